@@ -1,11 +1,14 @@
 #include "buffer.h"
 
 #include <QTimer>
+#include <QFileInfo>
+#include <QtConcurrent>
 
 #include <notebook/node.h>
 #include <utils/fileutils.h>
 #include <widgets/viewwindow.h>
 #include <utils/pathutils.h>
+#include <notebookbackend/inotebookbackend.h>
 
 #include <core/configmgr.h>
 #include <core/editorconfig.h>
@@ -21,6 +24,54 @@ static vnotex::ID generateBufferID()
     return ++id;
 }
 
+// Backup file is an append-only journal of edits against the file on disk after a head line.
+// Each record is one of:
+//   S<length>:<text>\n                   snapshot of the whole content;
+//   D<pos>,<removed>,<length>:<text>\n   replace <removed> characters at <pos> with <text>.
+// Positions and lengths are in UTF-16 code units.
+
+// Compact the journal into a snapshot once its records exceed the content size and this.
+static const qint64 c_minBackupCompactionSize = 64 * 1024;
+
+static QByteArray backupSnapshotRecord(const QString &p_content)
+{
+    return QStringLiteral("S%1:").arg(p_content.size()).toUtf8() + p_content.toUtf8() + '\n';
+}
+
+QByteArray Buffer::backupEditRecord(const QString &p_old, const QString &p_new)
+{
+    const int minLen = qMin(p_old.size(), p_new.size());
+    int prefix = 0;
+    while (prefix < minLen && p_old.at(prefix) == p_new.at(prefix)) {
+        ++prefix;
+    }
+
+    if (prefix == p_old.size() && prefix == p_new.size()) {
+        return QByteArray();
+    }
+
+    // Do not split a surrogate pair, which could not be encoded in UTF-8.
+    if (prefix > 0 && p_old.at(prefix - 1).isHighSurrogate()) {
+        --prefix;
+    }
+
+    int suffix = 0;
+    while (suffix < minLen - prefix
+           && p_old.at(p_old.size() - 1 - suffix) == p_new.at(p_new.size() - 1 - suffix)) {
+        ++suffix;
+    }
+
+    if (suffix > 0 && p_old.at(p_old.size() - suffix).isLowSurrogate()) {
+        --suffix;
+    }
+
+    const auto inserted = p_new.mid(prefix, p_new.size() - prefix - suffix);
+    return QStringLiteral("D%1,%2,%3:").arg(prefix)
+                                       .arg(p_old.size() - prefix - suffix)
+                                       .arg(inserted.size()).toUtf8()
+           + inserted.toUtf8() + '\n';
+}
+
 Buffer::Buffer(const BufferParameters &p_parameters,
                QObject *p_parent)
     : QObject(p_parent),
@@ -34,6 +85,14 @@ Buffer::Buffer(const BufferParameters &p_parameters,
     connect(m_autoSaveTimer, &QTimer::timeout,
             this, &Buffer::autoSave);
 
+    m_saveWatcher = new QFutureWatcher<QPair<bool, quint64>>(this);
+    connect(m_saveWatcher, &QFutureWatcher<QPair<bool, quint64>>::finished,
+            this, &Buffer::finishSaveAsync);
+
+    m_hashWatcher = new QFutureWatcher<quint64>(this);
+    connect(m_hashWatcher, &QFutureWatcher<quint64>::finished,
+            this, &Buffer::finishFileHashCheck);
+
     readContent();
 
     checkBackupFileOfPreviousSession();
@@ -41,7 +100,9 @@ Buffer::Buffer(const BufferParameters &p_parameters,
 
 Buffer::~Buffer()
 {
-    Q_ASSERT(m_attachedViewWindowCount == 0);
+    m_saveWatcher->waitForFinished();
+
+    Q_ASSERT(m_attachedViewWindows.isEmpty());
     Q_ASSERT(!m_viewWindowToSync);
     Q_ASSERT(!isModified());
     Q_ASSERT(m_backupFilePath.isEmpty());
@@ -49,24 +110,25 @@ Buffer::~Buffer()
 
 int Buffer::getAttachViewWindowCount() const
 {
-    return m_attachedViewWindowCount;
+    return m_attachedViewWindows.size();
 }
 
 void Buffer::attachViewWindow(ViewWindow *p_win)
 {
-    Q_UNUSED(p_win);
     Q_ASSERT(!(m_state & StateFlag::Discarded));
-    ++m_attachedViewWindowCount;
+    Q_ASSERT(!m_attachedViewWindows.contains(p_win));
+    m_attachedViewWindows.push_back(p_win);
 }
 
 void Buffer::detachViewWindow(ViewWindow *p_win)
 {
     Q_ASSERT(p_win != m_viewWindowToSync);
 
-    --m_attachedViewWindowCount;
-    Q_ASSERT(m_attachedViewWindowCount >= 0);
+    const bool removed = m_attachedViewWindows.removeOne(p_win);
+    Q_ASSERT(removed);
+    Q_UNUSED(removed);
 
-    if (m_attachedViewWindowCount == 0) {
+    if (m_attachedViewWindows.isEmpty()) {
         emit attachedViewWindowEmpty();
     }
 }
@@ -117,6 +179,7 @@ ID Buffer::getId() const
 
 const QString &Buffer::getContent() const
 {
+    const_cast<Buffer *>(this)->wakeUp();
     const_cast<Buffer *>(this)->syncContent();
     return m_content;
 }
@@ -125,6 +188,7 @@ void Buffer::setContent(const QString &p_content, int &p_revision)
 {
     m_viewWindowToSync = nullptr;
     m_content = p_content;
+    m_hibernated = false;
     p_revision = ++m_revision;
     setModified(true);
     m_autoSaveTimer->start();
@@ -190,23 +254,19 @@ Buffer::OperationCode Buffer::save(bool p_force)
         return OperationCode::Failed;
     }
 
+    waitForSave();
+    wakeUp();
+
     if (m_modified
         || p_force
         || m_state & (StateFlag::FileMissingOnDisk | StateFlag::FileChangedOutside)) {
         syncContent();
 
-        // We do not involve user here to handle file missing and changed outside cases.
-        // The active ViewWindow will check this periodically.
-        // Check if file still exists.
-        if (!p_force && !checkFileExistsOnDisk()) {
-            qWarning() << "failed to save buffer due to file missing on disk" << getPath();
-            return OperationCode::FileMissingOnDisk;
-        }
-
-        // Check if file is modified outside.
-        if (!p_force && checkFileChangedOutside()) {
-            qWarning() << "failed to save buffer due to file changed from outside" << getPath();
-            return OperationCode::FileChangedOutside;
+        if (!p_force) {
+            const auto code = checkBeforeSave();
+            if (code != OperationCode::Success) {
+                return code;
+            }
         }
 
         try {
@@ -216,14 +276,134 @@ Buffer::OperationCode Buffer::save(bool p_force)
             return OperationCode::Failed;
         }
 
+        resetBackupFile(m_content);
+
         setModified(false);
         m_state &= ~(StateFlag::FileMissingOnDisk | StateFlag::FileChangedOutside);
     }
     return OperationCode::Success;
 }
 
+Buffer::OperationCode Buffer::checkBeforeSave()
+{
+    // We do not involve user here to handle file missing and changed outside cases.
+    // The active ViewWindow will check this periodically.
+    // Check if file still exists.
+    if (!checkFileExistsOnDisk()) {
+        qWarning() << "failed to save buffer due to file missing on disk" << getPath();
+        return OperationCode::FileMissingOnDisk;
+    }
+
+    // Check if file is modified outside.
+    if (checkFileChangedOutside()) {
+        qWarning() << "failed to save buffer due to file changed from outside" << getPath();
+        return OperationCode::FileChangedOutside;
+    }
+
+    return OperationCode::Success;
+}
+
+void Buffer::saveAsync()
+{
+    Q_ASSERT(!m_readOnly);
+    if (m_saving) {
+        m_saveRequested = true;
+        return;
+    }
+
+    if (!m_modified) {
+        return;
+    }
+
+    syncContent();
+
+    const auto code = checkBeforeSave();
+    if (code != OperationCode::Success) {
+        emit saveFinished(code);
+        return;
+    }
+
+    // QString is implicitly shared so the snapshot is cheap.
+    File::WriteJob job;
+    try {
+        job = m_provider->prepareWrite(m_content);
+    } catch (Exception &p_e) {
+        qWarning() << "failed to prepare writing the buffer content" << getPath() << p_e.what();
+        emit saveFinished(OperationCode::Failed);
+        return;
+    }
+
+    m_saving = true;
+    m_savingRevision = m_revision;
+    m_savingPath = getContentPath();
+    const auto path = getPath();
+    m_saveWatcher->setFuture(QtConcurrent::run(INotebookBackend::getIOThreadPool(), [job, path]() {
+        try {
+            return qMakePair(true, job());
+        } catch (Exception &p_e) {
+            qWarning() << "failed to write the buffer content" << path << p_e.what();
+            return qMakePair(false, quint64(0));
+        }
+    }));
+}
+
+bool Buffer::isSaving() const
+{
+    return m_saving;
+}
+
+void Buffer::waitForSave()
+{
+    m_saveRequested = false;
+    if (m_saving) {
+        m_saveWatcher->waitForFinished();
+        finishSaveAsync();
+    }
+}
+
+void Buffer::finishSaveAsync()
+{
+    if (!m_saving) {
+        // Already handled by waitForSave().
+        return;
+    }
+    m_saving = false;
+
+    auto code = OperationCode::Failed;
+    const auto result = m_saveWatcher->result();
+    if (result.first && !PathUtils::areSamePaths(m_savingPath, getContentPath())) {
+        // Renamed or moved during the save without waiting for it. Keep it modified to save again.
+        qWarning() << "buffer file changed path during saving" << m_savingPath << getContentPath();
+        m_autoSaveTimer->start();
+    } else if (result.first) {
+        code = OperationCode::Success;
+        try {
+            m_provider->finishWrite(result.second);
+        } catch (Exception &p_e) {
+            qWarning() << "failed to update metadata after writing the buffer content" << getPath() << p_e.what();
+        }
+
+        resetBackupFile(QString());
+
+        // Content may change during saving.
+        if (m_savingRevision == m_revision) {
+            setModified(false);
+        }
+        m_state &= ~(StateFlag::FileMissingOnDisk | StateFlag::FileChangedOutside);
+    }
+
+    emit saveFinished(code);
+
+    if (m_saveRequested) {
+        m_saveRequested = false;
+        saveAsync();
+    }
+}
+
 Buffer::OperationCode Buffer::reload()
 {
+    waitForSave();
+
     // Check if file is missing.
     if (!checkFileExistsOnDisk()) {
         qWarning() << "failed to save buffer due to file missing on disk" << getPath();
@@ -243,8 +423,11 @@ Buffer::OperationCode Buffer::reload()
 void Buffer::readContent()
 {
     m_content = m_provider->read();
+    m_hibernated = false;
     ++m_revision;
 
+    resetBackupFile(m_content);
+
     // Reset state.
     m_viewWindowToSync = nullptr;
     m_modified = false;
@@ -253,9 +436,11 @@ void Buffer::readContent()
 void Buffer::discard()
 {
     Q_ASSERT(!(m_state & StateFlag::Discarded));
-    Q_ASSERT(m_attachedViewWindowCount == 1);
+    Q_ASSERT(m_attachedViewWindows.size() == 1);
     m_autoSaveTimer->stop();
+    waitForSave();
     m_content.clear();
+    m_hibernated = false;
     m_state |= StateFlag::Discarded;
     ++m_revision;
 
@@ -267,6 +452,7 @@ void Buffer::close()
 {
     // Delete the backup file if exists.
     m_autoSaveTimer->stop();
+    waitForSave();
     if (!m_backupFilePath.isEmpty()) {
         FileUtils::removeFile(m_backupFilePath);
         m_backupFilePath.clear();
@@ -318,9 +504,7 @@ void Buffer::autoSave()
         return;
 
     case EditorConfig::AutoSavePolicy::AutoSave:
-        if (save(false) != OperationCode::Success) {
-            qWarning() << "AutoSave failed to save buffer, retry later";
-        }
+        saveAsync();
         break;
 
     case EditorConfig::AutoSavePolicy::BackupFile:
@@ -345,15 +529,61 @@ void Buffer::writeBackupFile()
         QDir backupDir(backupDirPath);
         backupDir.mkpath(backupDirPath);
         m_backupFilePath = backupDir.filePath(backupFileName);
+        resetBackupFile(m_backupContent);
     }
 
     Q_ASSERT(m_backupFilePathOfPreviousSession.isEmpty());
 
     // Just use FileUtils instead of notebook backend.
-    FileUtils::writeFile(m_backupFilePath, generateBackupFileHead() + getContent());
+    const auto &content = getContent();
+    if (m_backupContent.isNull()
+        || m_backupJournalSize > qMax<qint64>(c_minBackupCompactionSize, content.size())) {
+        FileUtils::writeFileDurably(m_backupFilePath,
+                                    (generateBackupFileHead() + backupBaseHash(content)).toUtf8() + '\n'
+                                    + backupSnapshotRecord(content));
+        m_backupContent = content;
+        m_backupJournalSize = 0;
+        return;
+    }
+
+    const auto record = backupEditRecord(m_backupContent, content);
+    if (record.isEmpty()) {
+        return;
+    }
+
+    try {
+        FileUtils::appendFile(m_backupFilePath, record);
+    } catch (Exception &p_e) {
+        // The record may be torn. Write a snapshot next time.
+        m_backupContent = QString();
+        throw;
+    }
+    m_backupContent = content;
+    m_backupJournalSize += record.size();
+}
+
+void Buffer::resetBackupFile(const QString &p_baseContent)
+{
+    m_backupContent = p_baseContent;
+    m_backupJournalSize = 0;
+    if (m_backupFilePath.isEmpty()) {
+        return;
+    }
+
+    try {
+        FileUtils::writeFileDurably(m_backupFilePath, (generateBackupFileHead() + backupBaseHash(p_baseContent)).toUtf8() + '\n');
+    } catch (Exception &p_e) {
+        qWarning() << "failed to reset backup file" << m_backupFilePath << p_e.what();
+        m_backupContent = QString();
+    }
 }
 
 QString Buffer::generateBackupFileHead() const
+{
+    return QString("vnotex_backup_journal %1|").arg(getContentPath());
+}
+
+QString Buffer::generateLegacyBackupFileHead() const
 {
     return QString("vnotex_backup_file %1|").arg(getContentPath());
 }
@@ -382,8 +612,11 @@ void Buffer::checkBackupFileOfPreviousSession()
     for (const auto &file : backupFiles) {
         const auto filePath = backupDir.filePath(file);
         if (isBackupFileOfBuffer(filePath)) {
-            const auto backupContent = readBackupFile(filePath);
-            if (backupContent == getContent()) {
+            const auto backupContent = readBackupFile(filePath, getContent());
+            if (backupContent.isNull()) {
+                // Keep it for the user to check.
+                qWarning() << "skipped backup file of previous session not matching the file on disk" << filePath;
+            } else if (backupContent == getContent()) {
                 // Found backup file with identical content.
                 // Just discard the backup file.
                 FileUtils::removeFile(filePath);
@@ -406,7 +639,7 @@ bool Buffer::isBackupFileOfBuffer(const QString &p_file) const
 
     QTextStream st(&file);
     const auto head = st.readLine();
-    return head.startsWith(generateBackupFileHead());
+    return head.startsWith(generateBackupFileHead()) || head.startsWith(generateLegacyBackupFileHead());
 }
 
 const QString &Buffer::getBackupFileOfPreviousSession() const
@@ -414,10 +647,77 @@ const QString &Buffer::getBackupFileOfPreviousSession() const
     return m_backupFilePathOfPreviousSession;
 }
 
-QString Buffer::readBackupFile(const QString &p_filePath)
+QString Buffer::readBackupFile(const QString &p_filePath, const QString &p_baseContent)
 {
-    auto content = FileUtils::readTextFile(p_filePath);
-    return content.mid(content.indexOf(QLatin1Char('|')) + 1);
+    const auto text = QString::fromUtf8(FileUtils::readFile(p_filePath));
+    if (text.startsWith(QStringLiteral("vnotex_backup_file "))) {
+        // Full content by previous versions.
+        auto content = FileUtils::readTextFile(p_filePath);
+        return content.mid(content.indexOf(QLatin1Char('|')) + 1);
+    }
+
+    auto content = p_baseContent;
+    int idx = text.indexOf(QLatin1Char('\n')) + 1;
+    if (idx == 0) {
+        return content;
+    }
+
+    // Edits before a snapshot apply only to the base content the journal started from.
+    // Journals without the hash are from previous versions.
+    const auto head = text.left(idx - 1);
+    const auto baseHash = head.mid(head.lastIndexOf(QLatin1Char('|')) + 1);
+    bool baseMatched = baseHash.isEmpty() || baseHash == backupBaseHash(p_baseContent);
+
+    while (idx < text.size()) {
+        const int colonIdx = text.indexOf(QLatin1Char(':'), idx);
+        if (colonIdx == -1) {
+            qWarning() << "skipped torn backup file record" << p_filePath;
+            break;
+        }
+
+        const auto type = text.at(idx);
+        const auto fields = text.mid(idx + 1, colonIdx - idx - 1).split(QLatin1Char(','));
+        bool ok = false;
+        const int len = fields.last().toInt(&ok);
+        if (!ok || len < 0 || colonIdx + 1 + len > text.size()) {
+            qWarning() << "skipped torn backup file record" << p_filePath;
+            break;
+        }
+
+        const auto data = text.mid(colonIdx + 1, len);
+        if (type == QLatin1Char('S') && fields.size() == 1) {
+            content = data;
+            baseMatched = true;
+        } else if (type == QLatin1Char('D') && fields.size() == 3 && !baseMatched) {
+            // Skip edits until next snapshot.
+        } else if (type == QLatin1Char('D') && fields.size() == 3) {
+            bool posOk = false, removedOk = false;
+            const int pos = fields[0].toInt(&posOk);
+            const int removed = fields[1].toInt(&removedOk);
+            if (!posOk || !removedOk || pos < 0 || removed < 0 || pos + removed > content.size()) {
+                qWarning() << "backup file does not match the file on disk" << p_filePath;
+                break;
+            }
+            content.replace(pos, removed, data);
+        } else {
+            qWarning() << "unknown backup file record" << p_filePath << type;
+            break;
+        }
+
+        // Skip the trailing new line.
+        idx = colonIdx + 1 + len + 1;
+    }
+
+    if (!baseMatched) {
+        qWarning() << "backup file starts from another content than the file on disk" << p_filePath;
+        return QString();
+    }
+    return content;
+}
+
+QString Buffer::backupBaseHash(const QString &p_content)
+{
+    return QString::number(FileUtils::hashData(p_content.toUtf8()), 16);
 }
 
 void Buffer::discardBackupFileOfPreviousSession()
@@ -429,13 +729,23 @@ void Buffer::discardBackupFileOfPreviousSession()
     m_backupFilePathOfPreviousSession.clear();
 }
 
-void Buffer::recoverFromBackupFileOfPreviousSession()
+bool Buffer::recoverFromBackupFileOfPreviousSession()
 {
     Q_ASSERT(!m_backupFilePathOfPreviousSession.isEmpty());
 
-    m_content = readBackupFile(m_backupFilePathOfPreviousSession);
+    // The journal is replayed against the file on disk.
+    const auto content = readBackupFile(m_backupFilePathOfPreviousSession, m_provider->read());
+    if (content.isNull()) {
+        // Keep the file for the user to check.
+        m_backupFilePathOfPreviousSession.clear();
+        return false;
+    }
+
+    m_content = content;
+    m_hibernated = false;
     m_provider->write(m_content);
     ++m_revision;
+    resetBackupFile(m_content);
 
     FileUtils::removeFile(m_backupFilePathOfPreviousSession);
     qInfo() << "recover from backup file of previous session" << m_backupFilePathOfPreviousSession;
@@ -447,6 +757,7 @@ void Buffer::recoverFromBackupFileOfPreviousSession()
 
     emit modified(m_modified);
     emit contentsChanged();
+    return true;
 }
 
 bool Buffer::isChildOf(const Node *p_node) const
@@ -549,12 +860,91 @@ bool Buffer::checkFileExistsOnDisk()
 
 bool Buffer::checkFileChangedOutside()
 {
-    if (m_provider->checkFileChangedOutside()) {
+    if (m_saving) {
+        // Our own write is in progress.
+        return false;
+    }
+
+    bool changed = false;
+    switch (m_provider->checkFileChangedOutside()) {
+    case BufferProvider::FileCheckResult::Unchanged:
+        break;
+
+    case BufferProvider::FileCheckResult::Changed:
+        changed = true;
+        break;
+
+    case BufferProvider::FileCheckResult::NeedHashCheck:
+    {
+        const auto baseHash = m_provider->getContentHash();
+        const auto lastModified = QFileInfo(getContentPath()).lastModified();
+        try {
+            changed = m_provider->applyFileHash(baseHash, lastModified, m_provider->computeFileHash());
+        } catch (Exception &p_e) {
+            qWarning() << "failed to hash file" << getContentPath() << p_e.what();
+            changed = true;
+        }
+        break;
+    }
+    }
+
+    if (changed) {
         m_state |= StateFlag::FileChangedOutside;
-        return true;
     } else {
         m_state &= ~StateFlag::FileChangedOutside;
-        return false;
+    }
+    return changed;
+}
+
+void Buffer::checkFileChangedOutsideAsync()
+{
+    if (m_saving) {
+        // Our own write is in progress.
+        return;
+    }
+
+    if (m_hashWatcher->isRunning()) {
+        m_hashCheckRequested = true;
+        return;
+    }
+
+    switch (m_provider->checkFileChangedOutside()) {
+    case BufferProvider::FileCheckResult::Unchanged:
+        return;
+
+    case BufferProvider::FileCheckResult::Changed:
+        emit fileChangedOutside();
+        return;
+
+    case BufferProvider::FileCheckResult::NeedHashCheck:
+        break;
+    }
+
+    // Modified time is fetched before hashing so that a later change is not missed.
+    m_hashCheckBaseHash = m_provider->getContentHash();
+    m_hashCheckLastModified = QFileInfo(getContentPath()).lastModified();
+    const auto path = getContentPath();
+    const auto baseHash = m_hashCheckBaseHash;
+    m_hashWatcher->setFuture(QtConcurrent::run(INotebookBackend::getIOThreadPool(), [path, baseHash]() {
+        try {
+            return FileUtils::hashFile(path);
+        } catch (Exception &p_e) {
+            qWarning() << "failed to hash file" << path << p_e.what();
+            // Any hash other than the base one marks it changed.
+            return ~baseHash;
+        }
+    }));
+}
+
+void Buffer::finishFileHashCheck()
+{
+    if (m_provider->applyFileHash(m_hashCheckBaseHash, m_hashCheckLastModified, m_hashWatcher->result())) {
+        emit fileChangedOutside();
+    }
+
+    if (m_hashCheckRequested) {
+        m_hashCheckRequested = false;
+        checkFileChangedOutsideAsync();
     }
 }
 
@@ -563,6 +953,73 @@ Buffer::StateFlags Buffer::state() const
     return m_state;
 }
 
+bool Buffer::canHibernate() const
+{
+    return !m_hibernated
+           && !m_modified
+           && !m_saving
+           && !m_viewWindowToSync
+           && m_state == StateFlag::Normal
+           && m_backupFilePathOfPreviousSession.isEmpty()
+           && std::none_of(m_attachedViewWindows.constBegin(),
+                           m_attachedViewWindows.constEnd(),
+                           [](const ViewWindow *p_win) {
+                               return p_win->isVisible();
+                           });
+}
+
+bool Buffer::hibernate()
+{
+    if (!canHibernate()) {
+        return false;
+    }
+
+    emit aboutToHibernate();
+
+    m_content = QString();
+    m_backupContent = QString();
+    m_hibernated = true;
+    return true;
+}
+
+bool Buffer::isHibernated() const
+{
+    return m_hibernated;
+}
+
+qint64 Buffer::estimateMemoryCost() const
+{
+    if (m_hibernated) {
+        return 0;
+    }
+
+    // A text document with its layout or a rendered web page takes several times of the content.
+    const int viewWindowCostFactor = 4;
+    return static_cast<qint64>(m_content.size()) * sizeof(QChar)
+           * (1 + viewWindowCostFactor * m_attachedViewWindows.size());
+}
+
+void Buffer::activate()
+{
+    emit activated();
+}
+
+void Buffer::wakeUp()
+{
+    if (!m_hibernated) {
+        return;
+    }
+
+    // The buffer is not modified so it is fine to pick up changes on disk.
+    try {
+        readContent();
+    } catch (Exception &p_e) {
+        qWarning() << "failed to read back the content of hibernated buffer" << getPath() << p_e.what();
+        m_hibernated = false;
+        checkFileExistsOnDisk();
+    }
+}
+
 QSharedPointer<File> Buffer::getFile() const
 {
     return m_provider->getFile();
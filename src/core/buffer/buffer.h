@@ -3,6 +3,9 @@
 
 #include <QObject>
 #include <QSharedPointer>
+#include <QVector>
+#include <QDateTime>
+#include <QPair>
 
 #include <functional>
 
@@ -11,6 +14,9 @@
 class QWidget;
 class QTimer;
 
+template <typename T>
+class QFutureWatcher;
+
 namespace vnotex
 {
     class Node;
@@ -115,8 +121,20 @@ namespace vnotex
         bool isReadOnly() const;
 
         // Save buffer content to file.
+        // Wait for the background save if any.
         OperationCode save(bool p_force);
 
+        // Save buffer content in a worker thread, taking only a snapshot of the content here.
+        // A request during a running save is coalesced into one save of the latest content
+        // after it. Result is reported by saveFinished().
+        void saveAsync();
+
+        bool isSaving() const;
+
+        // Wait for the running background save and drop coalesced requests.
+        // Should be called before the file is renamed, moved or removed.
+        void waitForSave();
+
         // Discard changes and reload file.
         OperationCode reload();
 
@@ -138,7 +156,8 @@ namespace vnotex
 
         void discardBackupFileOfPreviousSession();
 
-        void recoverFromBackupFileOfPreviousSession();
+        // Return false if the backup file could not be replayed against the file on disk.
+        bool recoverFromBackupFileOfPreviousSession();
 
         // Whether this buffer's provider is a child of @p_node or an attachment of @p_node.
         bool isChildOf(const Node *p_node) const;
@@ -169,11 +188,42 @@ namespace vnotex
 
         bool checkFileExistsOnDisk();
 
+        // A touched file whose content is the same is not treated as changed.
         bool checkFileChangedOutside();
 
+        // Check whether file is changed outside in background, comparing the content hash
+        // if the modified time changes. fileChangedOutside() is emitted if changed.
+        void checkFileChangedOutsideAsync();
+
         StateFlags state() const;
 
-        static QString readBackupFile(const QString &p_filePath);
+        // Drop the content to save memory. It will be read from file again on next access.
+        // Attached view windows are asked to release their editors before that.
+        // Return false if it could not hibernate, such as it is modified.
+        bool hibernate();
+
+        bool canHibernate() const;
+
+        bool isHibernated() const;
+
+        // Rough estimate of the memory held by the content and the editors of the attached
+        // view windows in bytes.
+        qint64 estimateMemoryCost() const;
+
+        // One of the attached view windows is shown to user.
+        void activate();
+
+        // Read the content of backup file @p_filePath.
+        // @p_baseContent: content of the file on disk to replay the edit journal against.
+        // Return null string if the journal starts from another content than @p_baseContent.
+        static QString readBackupFile(const QString &p_filePath, const QString &p_baseContent);
+
+        // Hash of @p_content kept in the backup file head to check the base of the journal.
+        static QString backupBaseHash(const QString &p_content);
+
+        // Record of the edit from @p_old to @p_new in the backup journal.
+        // Return an empty record if @p_old and @p_new are identical.
+        static QByteArray backupEditRecord(const QString &p_old, const QString &p_new);
 
     signals:
         void attachedViewWindowEmpty();
@@ -186,6 +236,15 @@ namespace vnotex
 
         void attachmentChanged();
 
+        void saveFinished(OperationCode p_code);
+
+        void fileChangedOutside();
+
+        // View windows should release their editors and keep only the position.
+        void aboutToHibernate();
+
+        void activated();
+
     protected:
         virtual ViewWindow *createViewWindowInternal(const QSharedPointer<FileOpenParameters> &p_paras, QWidget *p_parent) = 0;
 
@@ -197,16 +256,34 @@ namespace vnotex
     private:
         void syncContent();
 
+        // Check whether file is missing or changed outside before saving.
+        OperationCode checkBeforeSave();
+
+        void finishSaveAsync();
+
+        void finishFileHashCheck();
+
         void readContent();
 
+        // Read back the content dropped by hibernate().
+        void wakeUp();
+
         // Get the path of the image folder.
         QString getImageFolderPath() const;
 
+        // Append the edit since last write to the backup file, or compact it.
         void writeBackupFile();
 
-        // Generate backup file head.
+        // Restart the backup journal from @p_baseContent which is on disk now.
+        // Null @p_baseContent means unknown, so that the next write will be a snapshot.
+        void resetBackupFile(const QString &p_baseContent);
+
+        // Generate backup file head, which is followed by the hash of the base content.
         QString generateBackupFileHead() const;
 
+        // Head of backup files of full content by previous versions.
+        QString generateLegacyBackupFileHead() const;
+
         void checkBackupFileOfPreviousSession();
 
         bool isBackupFileOfBuffer(const QString &p_file) const;
@@ -225,7 +302,7 @@ namespace vnotex
 
         bool m_modified = false;
 
-        int m_attachedViewWindowCount = 0;
+        QVector<ViewWindow *> m_attachedViewWindows;
 
         const ViewWindow *m_viewWindowToSync = nullptr;
 
@@ -236,7 +313,41 @@ namespace vnotex
 
         QString m_backupFilePathOfPreviousSession;
 
+        // Content the backup journal leads to.
+        QString m_backupContent;
+
+        // Size of the edit records in the backup file.
+        qint64 m_backupJournalSize = 0;
+
         StateFlags m_state = StateFlag::Normal;
+
+        // Managed by QObject.
+        // Whether the background save succeeds and the hash of the bytes written.
+        QFutureWatcher<QPair<bool, quint64>> *m_saveWatcher = nullptr;
+
+        bool m_saving = false;
+
+        // Whether another save is requested during the running one.
+        bool m_saveRequested = false;
+
+        // Revision of the content being saved in background.
+        int m_savingRevision = 0;
+
+        // Content path the running background save writes to.
+        QString m_savingPath;
+
+        bool m_hibernated = false;
+
+        // Managed by QObject.
+        QFutureWatcher<quint64> *m_hashWatcher = nullptr;
+
+        // Content hash and file modified time when the running hash check started.
+        quint64 m_hashCheckBaseHash = 0;
+
+        QDateTime m_hashCheckLastModified;
+
+        // Whether another hash check is requested during the running one.
+        bool m_hashCheckRequested = false;
     };
 } // ns vnotex
 
@@ -2,6 +2,8 @@
 
 #include <QFileInfo>
 
+#include <utils/fileutils.h>
+
 using namespace vnotex;
 
 bool BufferProvider::checkFileExistsOnDisk() const
@@ -14,11 +16,56 @@ QDateTime BufferProvider::getLastModifiedFromFile() const
     return QFileInfo(getContentPath()).lastModified();
 }
 
-bool BufferProvider::checkFileChangedOutside() const
+void BufferProvider::updateFileState(const QDateTime &p_lastModified, quint64 p_hash)
+{
+    m_lastModified = p_lastModified;
+    m_changedLastModified = QDateTime();
+    m_contentHash = p_hash;
+    m_contentHashValid = true;
+}
+
+BufferProvider::FileCheckResult BufferProvider::checkFileChangedOutside() const
 {
     QFileInfo info(getContentPath());
-    if (!info.exists() || m_lastModified != info.lastModified()) {
-        return true;
+    if (!info.exists()) {
+        return FileCheckResult::Changed;
+    }
+
+    const auto lastModified = info.lastModified();
+    if (m_lastModified == lastModified) {
+        return FileCheckResult::Unchanged;
+    }
+
+    if (!m_contentHashValid || m_changedLastModified == lastModified) {
+        return FileCheckResult::Changed;
+    }
+
+    return FileCheckResult::NeedHashCheck;
+}
+
+quint64 BufferProvider::computeFileHash() const
+{
+    return FileUtils::hashFile(getContentPath());
+}
+
+bool BufferProvider::applyFileHash(quint64 p_baseHash, const QDateTime &p_lastModified, quint64 p_hash)
+{
+    if (!m_contentHashValid || m_contentHash != p_baseHash) {
+        // Read or written again since the computation started.
+        return checkFileChangedOutside() == FileCheckResult::Changed;
     }
-    return false;
+
+    if (p_hash == m_contentHash) {
+        // Just touched.
+        m_lastModified = p_lastModified;
+        return false;
+    }
+
+    m_changedLastModified = p_lastModified;
+    return true;
+}
+
+quint64 BufferProvider::getContentHash() const
+{
+    return m_contentHashValid ? m_contentHash : 0;
 }
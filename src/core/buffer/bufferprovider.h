@@ -4,6 +4,8 @@
 #include <QObject>
 #include <QDateTime>
 
+#include <core/file.h>
+
 #include "buffer.h"
 
 namespace vnotex
@@ -22,6 +24,14 @@ namespace vnotex
 
         virtual ~BufferProvider() {}
 
+        enum class FileCheckResult
+        {
+            Unchanged,
+            Changed,
+            // Modified time changed, which may be just touched. Compare the content hash to tell.
+            NeedHashCheck
+        };
+
         virtual Buffer::ProviderType getType() const = 0;
 
         virtual bool match(const Node *p_node) const = 0;
@@ -38,6 +48,12 @@ namespace vnotex
 
         virtual void write(const QString &p_content) = 0;
 
+        // Asynchronous counterpart of write(). See File::prepareWrite().
+        virtual File::WriteJob prepareWrite(const QString &p_content) const = 0;
+
+        // @p_hash: hash of the bytes written by the job of prepareWrite().
+        virtual void finishWrite(quint64 p_hash) = 0;
+
         virtual QString read() const = 0;
 
         virtual QString fetchImageFolderPath() = 0;
@@ -70,7 +86,19 @@ namespace vnotex
 
         virtual bool checkFileExistsOnDisk() const;
 
-        virtual bool checkFileChangedOutside() const;
+        // Cheap check by the modified time against the file read or written last time.
+        virtual FileCheckResult checkFileChangedOutside() const;
+
+        // Hash of the content file. Could be called in a worker thread.
+        quint64 computeFileHash() const;
+
+        // Apply @p_hash computed from the content file whose modified time is @p_lastModified.
+        // @p_baseHash: recorded content hash when the computation started.
+        // Return true if the file is changed outside.
+        bool applyFileHash(quint64 p_baseHash, const QDateTime &p_lastModified, quint64 p_hash);
+
+        // Hash of the content read or written last time. Return 0 if unknown.
+        quint64 getContentHash() const;
 
         virtual bool isReadOnly() const = 0;
 
@@ -80,7 +108,18 @@ namespace vnotex
     protected:
         virtual QDateTime getLastModifiedFromFile() const;
 
+        // Record modified time of the file and hash @p_hash of the bytes just read or written.
+        void updateFileState(const QDateTime &p_lastModified, quint64 p_hash);
+
         QDateTime m_lastModified;
+
+    private:
+        quint64 m_contentHash = 0;
+
+        bool m_contentHashValid = false;
+
+        // Modified time of the file known to differ from the buffer by its hash.
+        QDateTime m_changedLastModified;
     };
 }
 
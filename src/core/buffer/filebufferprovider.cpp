@@ -58,14 +58,28 @@ QString FileBufferProvider::getResourcePath() const
 
 void FileBufferProvider::write(const QString &p_content)
 {
-    m_file->write(p_content);
-    m_lastModified = getLastModifiedFromFile();
+    const auto hash = m_file->write(p_content);
+    updateFileState(getLastModifiedFromFile(), hash);
+}
+
+File::WriteJob FileBufferProvider::prepareWrite(const QString &p_content) const
+{
+    return m_file->prepareWrite(p_content);
+}
+
+void FileBufferProvider::finishWrite(quint64 p_hash)
+{
+    m_file->finishWrite();
+    updateFileState(getLastModifiedFromFile(), p_hash);
 }
 
 QString FileBufferProvider::read() const
 {
-    const_cast<FileBufferProvider *>(this)->m_lastModified = getLastModifiedFromFile();
-    return m_file->read();
+    // Take the modified time first so a change during reading will be noticed.
+    const auto lastModified = getLastModifiedFromFile();
+    const auto data = m_file->readData();
+    const_cast<FileBufferProvider *>(this)->updateFileState(lastModified, FileUtils::hashData(data));
+    return FileUtils::decodeText(data);
 }
 
 QString FileBufferProvider::fetchImageFolderPath()
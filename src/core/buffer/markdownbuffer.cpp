@@ -1,11 +1,15 @@
 #include "markdownbuffer.h"
 
 #include <QDir>
+#include <QtConcurrent>
 
 #include <widgets/markdownviewwindow.h>
 #include <notebook/node.h>
 #include <utils/pathutils.h>
 #include <buffer/bufferprovider.h>
+#include <core/configmgr.h>
+#include <core/editorconfig.h>
+#include <core/markdowneditorconfig.h>
 
 using namespace vnotex;
 
@@ -13,6 +17,9 @@ MarkdownBuffer::MarkdownBuffer(const BufferParameters &p_parameters,
                                QObject *p_parent)
     : Buffer(p_parameters, p_parent)
 {
+    const int largeFileSize = ConfigMgr::getInst().getEditorConfig().getMarkdownEditorConfig().getLargeFileSize();
+    m_largeFile = largeFileSize > 0 && getContent().size() >= largeFileSize;
+
     fetchInitialImages();
 }
 
@@ -35,6 +42,17 @@ QString MarkdownBuffer::insertImage(const QImage &p_image, const QString &p_imag
 void MarkdownBuffer::fetchInitialImages()
 {
     Q_ASSERT(m_initialImages.isEmpty());
+    if (m_largeFile) {
+        // Do not block the open on scanning the whole content. It is only needed on close.
+        m_initialImagesFuture = QtConcurrent::run([content = getContent(), resourcePath = getResourcePath()]() {
+            return vte::MarkdownUtils::fetchImagesFromMarkdownText(content,
+                                                                   resourcePath,
+                                                                   vte::MarkdownLink::TypeFlag::LocalRelativeInternal);
+        });
+        m_initialImagesPending = true;
+        return;
+    }
+
     m_initialImages = vte::MarkdownUtils::fetchImagesFromMarkdownText(getContent(),
                                                                       getResourcePath(),
                                                                       vte::MarkdownLink::TypeFlag::LocalRelativeInternal);
@@ -54,6 +72,12 @@ QSet<QString> MarkdownBuffer::clearObsoleteImages()
     QSet<QString> obsoleteImages;
 
     Q_ASSERT(!isModified());
+    if (m_initialImagesPending) {
+        m_initialImages = m_initialImagesFuture.result();
+        m_initialImagesFuture = QFuture<QVector<vte::MarkdownLink>>();
+        m_initialImagesPending = false;
+    }
+
     const bool discarded = state() & StateFlag::Discarded;
     const auto latestImages =
         vte::MarkdownUtils::fetchImagesFromMarkdownText(!discarded ? getContent() : m_provider->read(),
@@ -93,3 +117,18 @@ void MarkdownBuffer::removeImage(const QString &p_imagePath)
     qDebug() << "remove obsolete image" << p_imagePath;
     m_provider->removeImage(p_imagePath);
 }
+
+bool MarkdownBuffer::isLargeFile() const
+{
+    return m_largeFile;
+}
+
+int MarkdownBuffer::getLargeFileFeatures() const
+{
+    return m_largeFileFeatures;
+}
+
+void MarkdownBuffer::setLargeFileFeatures(int p_features)
+{
+    m_largeFileFeatures = p_features;
+}
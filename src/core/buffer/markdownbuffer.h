@@ -5,6 +5,7 @@
 
 #include <QVector>
 #include <QSet>
+#include <QFuture>
 
 #include <vtextedit/markdownutils.h>
 
@@ -30,6 +31,16 @@ namespace vnotex
         // Will re-init m_initialImages and clear m_insertedImages.
         QSet<QString> clearObsoleteImages();
 
+        // Whether the content is large enough to open in large file mode.
+        // Decided once on open.
+        bool isLargeFile() const;
+
+        // Features enabled by user in large file mode, kept with the buffer
+        // so they survive hibernation of its view windows.
+        int getLargeFileFeatures() const;
+
+        void setLargeFileFeatures(int p_features);
+
     protected:
         ViewWindow *createViewWindowInternal(const QSharedPointer<FileOpenParameters> &p_paras, QWidget *p_parent) Q_DECL_OVERRIDE;
 
@@ -39,6 +50,15 @@ namespace vnotex
         // Images referenced in the file before opening this buffer.
         QVector<vte::MarkdownLink> m_initialImages;
 
+        // Fetch of m_initialImages running in background for a large file.
+        QFuture<QVector<vte::MarkdownLink>> m_initialImagesFuture;
+
+        bool m_initialImagesPending = false;
+
+        bool m_largeFile = false;
+
+        int m_largeFileFeatures = 0;
+
         // Images newly inserted during this buffer's lifetime.
         QVector<vte::MarkdownLink> m_insertedImages;
     };
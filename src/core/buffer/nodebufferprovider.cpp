@@ -4,6 +4,7 @@
 
 #include <notebook/node.h>
 #include <utils/pathutils.h>
+#include <utils/fileutils.h>
 #include <core/file.h>
 
 using namespace vnotex;
@@ -54,14 +55,28 @@ QString NodeBufferProvider::getResourcePath() const
 
 void NodeBufferProvider::write(const QString &p_content)
 {
-    m_nodeFile->write(p_content);
-    m_lastModified = getLastModifiedFromFile();
+    const auto hash = m_nodeFile->write(p_content);
+    updateFileState(getLastModifiedFromFile(), hash);
+}
+
+File::WriteJob NodeBufferProvider::prepareWrite(const QString &p_content) const
+{
+    return m_nodeFile->prepareWrite(p_content);
+}
+
+void NodeBufferProvider::finishWrite(quint64 p_hash)
+{
+    m_nodeFile->finishWrite();
+    updateFileState(getLastModifiedFromFile(), p_hash);
 }
 
 QString NodeBufferProvider::read() const
 {
-    const_cast<NodeBufferProvider *>(this)->m_lastModified = getLastModifiedFromFile();
-    return m_nodeFile->read();
+    // Take the modified time first so a change during reading will be noticed.
+    const auto lastModified = getLastModifiedFromFile();
+    const auto data = m_nodeFile->readData();
+    const_cast<NodeBufferProvider *>(this)->updateFileState(lastModified, FileUtils::hashData(data));
+    return FileUtils::decodeText(data);
 }
 
 QString NodeBufferProvider::fetchImageFolderPath()
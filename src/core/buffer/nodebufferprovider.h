@@ -35,6 +35,10 @@ namespace vnotex
 
         void write(const QString &p_content) Q_DECL_OVERRIDE;
 
+        File::WriteJob prepareWrite(const QString &p_content) const Q_DECL_OVERRIDE;
+
+        void finishWrite(quint64 p_hash) Q_DECL_OVERRIDE;
+
         QString read() const Q_DECL_OVERRIDE;
 
         QString fetchImageFolderPath() Q_DECL_OVERRIDE;
@@ -2,6 +2,7 @@
 
 #include <QUrl>
 #include <QDebug>
+#include <QTimer>
 
 #include <notebook/node.h>
 #include <buffer/filetypehelper.h>
@@ -11,11 +12,16 @@
 #include <buffer/nodebufferprovider.h>
 #include <buffer/filebufferprovider.h>
 #include <utils/widgetutils.h>
+#include <utils/pathutils.h>
 #include "notebookmgr.h"
 #include "vnotex.h"
 #include "externalfile.h"
+#include "filewatcher.h"
+#include "configmgr.h"
+#include "editorconfig.h"
 
 #include "fileopenparameters.h"
+#include "events.h"
 
 using namespace vnotex;
 
@@ -32,6 +38,25 @@ BufferMgr::~BufferMgr()
 void BufferMgr::init()
 {
     initBufferServer();
+
+    connect(&VNoteX::getInst().getFileWatcher(), &FileWatcher::filesChanged,
+            this, &BufferMgr::handleFilesChanged);
+
+    // Connected before the view area, which may close the buffers.
+    connect(&VNoteX::getInst(), &VNoteX::nodeAboutToMove,
+            this, &BufferMgr::waitForSaveOfNode);
+    connect(&VNoteX::getInst(), &VNoteX::nodeAboutToRemove,
+            this, &BufferMgr::waitForSaveOfNode);
+    connect(&VNoteX::getInst(), &VNoteX::nodeAboutToRename,
+            this, &BufferMgr::waitForSaveOfNode);
+    connect(&VNoteX::getInst(), &VNoteX::nodeAboutToReload,
+            this, &BufferMgr::waitForSaveOfNode);
+
+    m_memoryBudgetTimer = new QTimer(this);
+    m_memoryBudgetTimer->setSingleShot(true);
+    m_memoryBudgetTimer->setInterval(2000);
+    connect(m_memoryBudgetTimer, &QTimer::timeout,
+            this, &BufferMgr::checkMemoryBudget);
 }
 
 void BufferMgr::initBufferServer()
@@ -147,50 +172,187 @@ void BufferMgr::open(const QString &p_filePath, const QSharedPointer<FileOpenPar
     emit bufferRequested(buffer, p_paras);
 }
 
-Buffer *BufferMgr::findBuffer(const Node *p_node) const
+void BufferMgr::rewriteNoteLinks(const QString &p_filePath,
+                                 const std::function<QString(const QString &)> &p_rewrite,
+                                 const QSharedPointer<Event> &p_event)
 {
-    auto it = std::find_if(m_buffers.constBegin(),
-                           m_buffers.constEnd(),
-                           [p_node](const Buffer *p_buffer) {
-                               return p_buffer->match(p_node);
-                           });
-    if (it != m_buffers.constEnd()) {
-        return *it;
+    auto buffer = findBuffer(p_filePath);
+    if (!buffer || p_event->m_handled) {
+        return;
     }
 
-    return nullptr;
+    // Leave it to the disk rewrite, whose change will be noticed as usual.
+    if (buffer->isReadOnly()) {
+        qWarning() << "links of read-only buffer are rewritten on disk" << p_filePath;
+        return;
+    }
+
+    const auto content = p_rewrite(buffer->getContent());
+    if (!content.isNull()) {
+        int revision = 0;
+        buffer->setContent(content, revision);
+    }
+    p_event->m_handled = true;
 }
 
-Buffer *BufferMgr::findBuffer(const QString &p_filePath) const
+void BufferMgr::updateBufferPathsUnder(const QString &p_oldPath)
 {
-    auto it = std::find_if(m_buffers.constBegin(),
-                           m_buffers.constEnd(),
-                           [p_filePath](const Buffer *p_buffer) {
-                               return p_buffer->match(p_filePath);
-                           });
-    if (it != m_buffers.constEnd()) {
-        return *it;
+    const auto oldPath = PathUtils::normalizePath(p_oldPath);
+    for (auto buffer : m_buffers) {
+        if (PathUtils::pathContains(oldPath, m_bufferPaths.value(buffer))) {
+            updateBufferPath(buffer);
+            updateWatchedFile(buffer);
+        }
     }
+}
 
-    return nullptr;
+void BufferMgr::waitForSaveOfNode(Node *p_node)
+{
+    if (!p_node) {
+        return;
+    }
+
+    const auto nodePath = p_node->fetchAbsolutePath();
+    for (auto buffer : m_buffers) {
+        if (buffer->isSaving() && PathUtils::pathContains(nodePath, buffer->getContentPath())) {
+            buffer->waitForSave();
+        }
+    }
+}
+
+Buffer *BufferMgr::findBuffer(const Node *p_node) const
+{
+    auto buffer = m_nodeBuffers.value(p_node, nullptr);
+    Q_ASSERT(!buffer || buffer->match(p_node));
+    return buffer;
+}
+
+Buffer *BufferMgr::findBuffer(const QString &p_filePath)
+{
+    auto buffer = m_pathBuffers.value(PathUtils::normalizePath(p_filePath), nullptr);
+    if (buffer && !buffer->match(p_filePath)) {
+        // Stale entry of a buffer renamed or moved without notice yet.
+        updateBufferPath(buffer);
+        updateWatchedFile(buffer);
+        return nullptr;
+    }
+
+    return buffer;
 }
 
 void BufferMgr::addBuffer(Buffer *p_buffer)
 {
     m_buffers.push_back(p_buffer);
+    if (p_buffer->getProviderType() == Buffer::ProviderType::Internal) {
+        auto node = p_buffer->getNode();
+        Q_ASSERT(node && p_buffer->match(node));
+        m_nodeBuffers.insert(node, p_buffer);
+    }
+    updateBufferPath(p_buffer);
+    updateWatchedFile(p_buffer);
+    connect(p_buffer, &Buffer::fileChangedOutside,
+            this, [this, p_buffer]() {
+                emit bufferFileChanged(p_buffer);
+            });
+    connect(p_buffer, &Buffer::activated,
+            this, [this, p_buffer]() {
+                handleBufferActivated(p_buffer);
+            });
+    connect(p_buffer, &Buffer::saveFinished,
+            this, [p_buffer](Buffer::OperationCode p_code) {
+                if (p_code != Buffer::OperationCode::Success) {
+                    VNoteX::getInst().showStatusMessageShort(tr("Failed to save (%1)").arg(p_buffer->getPath()));
+                }
+            });
     connect(p_buffer, &Buffer::attachedViewWindowEmpty,
             this, [this, p_buffer]() {
                 qDebug() << "delete buffer without attached view window"
                          << p_buffer->getName();
-                m_buffers.removeAll(p_buffer);
+                removeBuffer(p_buffer);
                 p_buffer->close();
                 p_buffer->deleteLater();
             });
 }
 
+void BufferMgr::removeBuffer(Buffer *p_buffer)
+{
+    m_buffers.removeAll(p_buffer);
+
+    for (auto it = m_nodeBuffers.begin(); it != m_nodeBuffers.end(); ++it) {
+        if (it.value() == p_buffer) {
+            m_nodeBuffers.erase(it);
+            break;
+        }
+    }
+
+    const auto path = m_bufferPaths.take(p_buffer);
+    if (m_pathBuffers.value(path, nullptr) == p_buffer) {
+        m_pathBuffers.remove(path);
+    }
+
+    VNoteX::getInst().getFileWatcher().removePath(m_watchedFiles.take(p_buffer));
+}
+
+void BufferMgr::updateBufferPath(Buffer *p_buffer)
+{
+    const auto path = PathUtils::normalizePath(p_buffer->getPath());
+    auto &indexedPath = m_bufferPaths[p_buffer];
+    if (indexedPath == path) {
+        return;
+    }
+
+    if (!indexedPath.isEmpty() && m_pathBuffers.value(indexedPath, nullptr) == p_buffer) {
+        m_pathBuffers.remove(indexedPath);
+    }
+    indexedPath = path;
+    m_pathBuffers.insert(path, p_buffer);
+}
+
+void BufferMgr::updateWatchedFile(Buffer *p_buffer)
+{
+    const auto path = p_buffer->getContentPath();
+    auto &watchedFile = m_watchedFiles[p_buffer];
+    if (watchedFile == path) {
+        return;
+    }
+
+    auto &watcher = VNoteX::getInst().getFileWatcher();
+    if (!watchedFile.isEmpty()) {
+        watcher.removePath(watchedFile);
+    }
+    watchedFile = path;
+    watcher.addPath(watchedFile);
+}
+
+void BufferMgr::handleFilesChanged(const QStringList &p_files)
+{
+    QSet<QString> files;
+    for (const auto &file : p_files) {
+        files.insert(file);
+    }
+
+    const auto buffers = m_buffers;
+    for (auto buffer : buffers) {
+        const auto watchedFile = m_watchedFiles.value(buffer);
+        if (!files.contains(PathUtils::cleanPath(watchedFile))) {
+            continue;
+        }
+
+        // It may be renamed within the app.
+        updateBufferPath(buffer);
+        updateWatchedFile(buffer);
+
+        // Notify only if the content really changes.
+        buffer->checkFileChangedOutsideAsync();
+    }
+}
+
 QSharedPointer<Node> BufferMgr::loadNodeByPath(const QString &p_path)
 {
-    const auto &notebooks = VNoteX::getInst().getNotebookMgr().getNotebooks();
+    auto &notebookMgr = VNoteX::getInst().getNotebookMgr();
+    notebookMgr.openPendingNotebooks(p_path);
+
+    const auto &notebooks = notebookMgr.getNotebooks();
     for (const auto &nb : notebooks) {
         auto node = nb->loadNodeByPath(p_path);
         if (node) {
@@ -200,3 +362,40 @@ QSharedPointer<Node> BufferMgr::loadNodeByPath(const QString &p_path)
 
     return nullptr;
 }
+
+void BufferMgr::handleBufferActivated(Buffer *p_buffer)
+{
+    if (m_buffers.last() != p_buffer) {
+        m_buffers.removeOne(p_buffer);
+        m_buffers.push_back(p_buffer);
+    }
+
+    // Let the activation settle before releasing other buffers.
+    m_memoryBudgetTimer->start();
+}
+
+void BufferMgr::checkMemoryBudget()
+{
+    const qint64 budget = ConfigMgr::getInst().getEditorConfig().getBufferMemoryBudget() * 1024LL * 1024LL;
+    if (budget <= 0) {
+        return;
+    }
+
+    qint64 totalCost = 0;
+    for (const auto buffer : m_buffers) {
+        totalCost += buffer->estimateMemoryCost();
+    }
+
+    const auto buffers = m_buffers;
+    for (auto buffer : buffers) {
+        if (totalCost <= budget) {
+            break;
+        }
+
+        const auto cost = buffer->estimateMemoryCost();
+        if (cost > 0 && buffer->hibernate()) {
+            qDebug() << "hibernate buffer" << buffer->getName() << cost;
+            totalCost -= cost;
+        }
+    }
+}
@@ -5,15 +5,21 @@
 #include <QScopedPointer>
 #include <QSharedPointer>
 #include <QVector>
+#include <QHash>
+
+#include <functional>
 
 #include "namebasedserver.h"
 
+class QTimer;
+
 namespace vnotex
 {
     class IBufferFactory;
     class Node;
     class Buffer;
     struct FileOpenParameters;
+    class Event;
 
     class BufferMgr : public QObject
     {
@@ -30,25 +36,71 @@ namespace vnotex
 
         void open(const QString &p_filePath, const QSharedPointer<FileOpenParameters> &p_paras);
 
+        // Rewrite links of the buffer of @p_filePath if it is open.
+        void rewriteNoteLinks(const QString &p_filePath,
+                              const std::function<QString(const QString &)> &p_rewrite,
+                              const QSharedPointer<Event> &p_event);
+
+        // Update the path index of buffers within @p_oldPath, which is renamed or moved.
+        void updateBufferPathsUnder(const QString &p_oldPath);
+
     signals:
         void bufferRequested(Buffer *p_buffer, const QSharedPointer<FileOpenParameters> &p_paras);
 
+        // The file of @p_buffer is changed, removed or renamed on disk.
+        void bufferFileChanged(Buffer *p_buffer);
+
     private:
         void initBufferServer();
 
         Buffer *findBuffer(const Node *p_node) const;
 
-        Buffer *findBuffer(const QString &p_filePath) const;
+        // Look up the path index, which is kept in sync on rename and move.
+        Buffer *findBuffer(const QString &p_filePath);
 
         void addBuffer(Buffer *p_buffer);
 
+        void removeBuffer(Buffer *p_buffer);
+
+        // Keep the path index of @p_buffer in sync with its path, which changes on rename and move.
+        void updateBufferPath(Buffer *p_buffer);
+
+        void handleFilesChanged(const QStringList &p_files);
+
+        // Keep the watched file of @p_buffer in sync with its content path, which changes on rename.
+        void updateWatchedFile(Buffer *p_buffer);
+
         // Try to load @p_path as a node if it is within one notebook.
         QSharedPointer<Node> loadNodeByPath(const QString &p_path);
 
+        void handleBufferActivated(Buffer *p_buffer);
+
+        // Let background saves of buffers within @p_node finish before its files change.
+        void waitForSaveOfNode(Node *p_node);
+
+        // Hibernate least recently activated buffers until within the memory budget.
+        void checkMemoryBudget();
+
         QSharedPointer<NameBasedServer<IBufferFactory>> m_bufferServer;
 
         // Managed by QObject.
+        // Ordered from the least recently activated one.
         QVector<Buffer *> m_buffers;
+
+        // File watched for each buffer.
+        QHash<Buffer *, QString> m_watchedFiles;
+
+        // Buffers of internal nodes.
+        QHash<const Node *, Buffer *> m_nodeBuffers;
+
+        // Normalized path -> buffer.
+        QHash<QString, Buffer *> m_pathBuffers;
+
+        // Normalized path indexed for each buffer.
+        QHash<Buffer *, QString> m_bufferPaths;
+
+        // Managed by QObject.
+        QTimer *m_memoryBudgetTimer = nullptr;
     };
 } // ns vnotex
 
@@ -11,6 +11,7 @@
 #include <QPixmap>
 #include <QSplashScreen>
 #include <QScopedPointer>
+#include <QCryptographicHash>
 
 #include <utils/pathutils.h>
 #include <utils/fileutils.h>
@@ -395,6 +396,16 @@ QString ConfigMgr::getUserSnippetFolder() const
     return folderPath;
 }
 
+QString ConfigMgr::getUserNotebookCacheFolder(const QString &p_rootFolderPath) const
+{
+    const auto key = QCryptographicHash::hash(PathUtils::normalizePath(p_rootFolderPath).toUtf8(),
+                                              QCryptographicHash::Sha1).toHex().left(16);
+    auto folderPath = PathUtils::concatenateFilePath(m_userConfigFolderPath,
+                                                     QStringLiteral("cache/notebooks/") + QString::fromLatin1(key));
+    QDir().mkpath(folderPath);
+    return folderPath;
+}
+
 QString ConfigMgr::getUserOrAppFile(const QString &p_filePath) const
 {
     QFileInfo fi(p_filePath);
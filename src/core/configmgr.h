@@ -95,6 +95,10 @@ namespace vnotex
 
         QString getUserSnippetFolder() const;
 
+        // Local folder for caches of notebook @p_rootFolderPath, which should not be synced
+        // along with the notebook.
+        QString getUserNotebookCacheFolder(const QString &p_rootFolderPath) const;
+
         // If @p_filePath is absolute, just return it.
         // Otherwise, first try to find it in user folder, then in app folder.
         QString getUserOrAppFile(const QString &p_filePath) const;
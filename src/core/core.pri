@@ -17,6 +17,8 @@ SOURCES += \
     $$PWD/editorconfig.cpp \
     $$PWD/externalfile.cpp \
     $$PWD/file.cpp \
+    $$PWD/fileoperationqueue.cpp \
+    $$PWD/filewatcher.cpp \
     $$PWD/htmltemplatehelper.cpp \
     $$PWD/logger.cpp \
     $$PWD/mainconfig.cpp \
@@ -41,7 +43,9 @@ HEADERS += \
     $$PWD/events.h \
     $$PWD/externalfile.h \
     $$PWD/file.h \
+    $$PWD/fileoperationqueue.h \
     $$PWD/filelocator.h \
+    $$PWD/filewatcher.h \
     $$PWD/fileopenparameters.h \
     $$PWD/htmltemplatehelper.h \
     $$PWD/location.h \
@@ -116,6 +116,22 @@ void CoreConfig::loadNoteManagement(const QJsonObject &p_app, const QJsonObject
 
         m_externalNodeExcludePatterns = READSTRLIST(QStringLiteral("exclude_patterns"));
     }
+
+    // Metadata snapshot.
+    {
+        const auto appObj = topAppObj.value(QStringLiteral("metadata_snapshot")).toObject();
+        const auto userObj = topUserObj.value(QStringLiteral("metadata_snapshot")).toObject();
+
+        m_metadataSnapshotEnabled = READBOOL(QStringLiteral("enabled"));
+    }
+
+    // Metadata journal.
+    {
+        const auto appObj = topAppObj.value(QStringLiteral("metadata_journal")).toObject();
+        const auto userObj = topUserObj.value(QStringLiteral("metadata_journal")).toObject();
+
+        m_metadataJournalEnabled = READBOOL(QStringLiteral("enabled"));
+    }
 }
 
 QJsonObject CoreConfig::saveShortcuts() const
@@ -153,6 +169,16 @@ const QStringList &CoreConfig::getExternalNodeExcludePatterns() const
     return m_externalNodeExcludePatterns;
 }
 
+bool CoreConfig::isMetadataSnapshotEnabled() const
+{
+    return m_metadataSnapshotEnabled;
+}
+
+bool CoreConfig::isMetadataJournalEnabled() const
+{
+    return m_metadataJournalEnabled;
+}
+
 bool CoreConfig::isRecoverLastSessionOnStartEnabled() const
 {
     return m_recoverLastSessionOnStartEnabled;
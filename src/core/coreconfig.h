@@ -87,6 +87,10 @@ namespace vnotex
 
         const QStringList &getExternalNodeExcludePatterns() const;
 
+        bool isMetadataSnapshotEnabled() const;
+
+        bool isMetadataJournalEnabled() const;
+
         static const QStringList &getAvailableLocales();
 
         bool isRecoverLastSessionOnStartEnabled() const;
@@ -115,6 +119,12 @@ namespace vnotex
 
         QStringList m_externalNodeExcludePatterns;
 
+        // Whether maintain a consolidated snapshot of notebook metadata for fast open.
+        bool m_metadataSnapshotEnabled = true;
+
+        // Whether record metadata updates in a journal instead of rewriting node configs.
+        bool m_metadataJournalEnabled = true;
+
         // Whether recover last session on start.
         bool m_recoverLastSessionOnStartEnabled = true;
 
@@ -64,6 +64,8 @@ void EditorConfig::loadCore(const QJsonObject &p_app, const QJsonObject &p_user)
     if (m_spellCheckDefaultDictionary.isEmpty()) {
         m_spellCheckDefaultDictionary = QStringLiteral("en_US");
     }
+
+    m_bufferMemoryBudget = READINT(QStringLiteral("buffer_memory_budget"));
 }
 
 QJsonObject EditorConfig::saveCore() const
@@ -76,6 +78,7 @@ QJsonObject EditorConfig::saveCore() const
     obj[QStringLiteral("shortcuts")] = saveShortcuts();
     obj[QStringLiteral("spell_check_auto_detect_language")] = m_spellCheckAutoDetectLanguageEnabled;
     obj[QStringLiteral("spell_check_default_dictionary")] = m_spellCheckDefaultDictionary;
+    obj[QStringLiteral("buffer_memory_budget")] = m_bufferMemoryBudget;
     return obj;
 }
 
@@ -212,3 +215,8 @@ void EditorConfig::setSpellCheckDefaultDictionary(const QString &p_dict)
 {
     updateConfig(m_spellCheckDefaultDictionary, p_dict, this);
 }
+
+int EditorConfig::getBufferMemoryBudget() const
+{
+    return m_bufferMemoryBudget;
+}
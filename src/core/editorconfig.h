@@ -93,6 +93,8 @@ namespace vnotex
         const QString &getSpellCheckDefaultDictionary() const;
         void setSpellCheckDefaultDictionary(const QString &p_dict);
 
+        int getBufferMemoryBudget() const;
+
     private:
         friend class MainConfig;
 
@@ -128,6 +130,10 @@ namespace vnotex
         bool m_spellCheckAutoDetectLanguageEnabled = false;
 
         QString m_spellCheckDefaultDictionary;
+
+        // Memory budget of opened buffers in MB. Least recently used buffers beyond it
+        // drop their content until activated again. 0 to disable.
+        int m_bufferMemoryBudget = 0;
     };
 }
 
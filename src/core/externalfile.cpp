@@ -11,14 +11,23 @@ ExternalFile::ExternalFile(const QString &p_filePath)
     setContentType(FileTypeHelper::getInst().getFileType(c_filePath).m_type);
 }
 
-QString ExternalFile::read() const
+QByteArray ExternalFile::readData() const
 {
-    return FileUtils::readTextFile(getContentPath());
+    return FileUtils::readFile(getContentPath());
 }
 
-void ExternalFile::write(const QString &p_content)
+File::WriteJob ExternalFile::prepareWrite(const QString &p_content) const
+{
+    const auto filePath = getContentPath();
+    return [filePath, p_content]() {
+        const auto data = FileUtils::encodeText(p_content);
+        FileUtils::writeFile(filePath, data);
+        return FileUtils::hashData(data);
+    };
+}
+
+void ExternalFile::finishWrite()
 {
-    FileUtils::writeFile(getContentPath(), p_content);
 }
 
 QString ExternalFile::getName() const
@@ -10,9 +10,11 @@ namespace vnotex
     public:
         explicit ExternalFile(const QString &p_filePath);
 
-        QString read() const Q_DECL_OVERRIDE;
+        QByteArray readData() const Q_DECL_OVERRIDE;
 
-        void write(const QString &p_content) Q_DECL_OVERRIDE;
+        WriteJob prepareWrite(const QString &p_content) const Q_DECL_OVERRIDE;
+
+        void finishWrite() Q_DECL_OVERRIDE;
 
         QString getName() const Q_DECL_OVERRIDE;
 
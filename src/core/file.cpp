@@ -1,7 +1,21 @@
 #include "file.h"
 
+#include <utils/fileutils.h>
+
 using namespace vnotex;
 
+QString File::read() const
+{
+    return FileUtils::decodeText(readData());
+}
+
+quint64 File::write(const QString &p_content)
+{
+    const auto hash = prepareWrite(p_content)();
+    finishWrite();
+    return hash;
+}
+
 const FileType &File::getContentType() const
 {
     return FileTypeHelper::getInst().getFileType(m_contentType);
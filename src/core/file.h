@@ -3,6 +3,8 @@
 
 #include <QString>
 
+#include <functional>
+
 #include <buffer/filetypehelper.h>
 
 class QImage;
@@ -37,9 +39,24 @@ namespace vnotex
 
         virtual ~File() = default;
 
-        virtual QString read() const = 0;
+        // Return the hash of the bytes written, the same as FileUtils::hashFile() of the content file.
+        typedef std::function<quint64()> WriteJob;
+
+        QString read() const;
+
+        // Bytes of the content file.
+        virtual QByteArray readData() const = 0;
+
+        // Write @p_content synchronously via prepareWrite() and finishWrite().
+        // Return the hash of the bytes written.
+        virtual quint64 write(const QString &p_content);
+
+        // Return a job writing @p_content which touches only the content file and could run
+        // in a worker thread. It throws on failure.
+        virtual WriteJob prepareWrite(const QString &p_content) const = 0;
 
-        virtual void write(const QString &p_content) = 0;
+        // Update metadata in the main thread after the job of prepareWrite() succeeds.
+        virtual void finishWrite() = 0;
 
         virtual QString getName() const = 0;
 
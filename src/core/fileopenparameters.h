@@ -32,6 +32,10 @@ namespace vnotex
 
         // Whether always open a new window for file.
         bool m_alwaysNewWindow = false;
+
+        // Open as a placeholder keeping only the position, which sets up its editors when
+        // first shown, such as windows restored from session.
+        bool m_deferred = false;
     };
 }
 
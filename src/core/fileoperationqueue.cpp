@@ -0,0 +1,250 @@
+#include "fileoperationqueue.h"
+
+#include <QtConcurrent>
+#include <QTimer>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QDebug>
+
+#include "exception.h"
+
+using namespace vnotex;
+
+bool FileOperationQueue::Context::isCancelled() const
+{
+    return m_cancelled.loadAcquire() != 0;
+}
+
+void FileOperationQueue::Context::addTotal(int p_count)
+{
+    m_total.fetchAndAddRelaxed(p_count);
+}
+
+void FileOperationQueue::Context::addDone(int p_count)
+{
+    m_done.fetchAndAddRelaxed(p_count);
+}
+
+int FileOperationQueue::Context::getTotal() const
+{
+    return m_total.loadAcquire();
+}
+
+int FileOperationQueue::Context::getDone() const
+{
+    return m_done.loadAcquire();
+}
+
+FileOperationQueue::FileOperationQueue(QObject *p_parent)
+    : QObject(p_parent)
+{
+    m_watcher = new QFutureWatcher<bool>(this);
+    connect(m_watcher, &QFutureWatcher<bool>::finished,
+            this, &FileOperationQueue::finishCurrent);
+
+    m_progressTimer = new QTimer(this);
+    m_progressTimer->setInterval(200);
+    connect(m_progressTimer, &QTimer::timeout,
+            this, &FileOperationQueue::emitProgress);
+}
+
+FileOperationQueue::~FileOperationQueue()
+{
+    m_pendingOperations.clear();
+    if (m_context) {
+        m_context->m_cancelled.storeRelease(1);
+        m_watcher->waitForFinished();
+    }
+}
+
+void FileOperationQueue::enqueue(const QString &p_description,
+                                 const Job &p_job,
+                                 QObject *p_receiver,
+                                 const Callback &p_callback)
+{
+    Operation op;
+    op.m_description = p_description;
+    op.m_job = p_job;
+    op.m_receiver = p_receiver;
+    op.m_callback = p_callback;
+    m_pendingOperations.enqueue(op);
+
+    if (!m_context) {
+        startNext();
+    } else {
+        emitProgress();
+    }
+}
+
+bool FileOperationQueue::isBusy() const
+{
+    return !m_context.isNull();
+}
+
+void FileOperationQueue::cancel()
+{
+    if (m_context) {
+        m_context->m_cancelled.storeRelease(1);
+    }
+
+    // Operations enqueued by the callbacks, such as rollbacks, are kept.
+    const auto operations = m_pendingOperations;
+    m_pendingOperations.clear();
+    for (const auto &op : operations) {
+        callBack(op, false);
+    }
+}
+
+void FileOperationQueue::startNext()
+{
+    Q_ASSERT(!m_context);
+    if (m_pendingOperations.isEmpty()) {
+        m_progressTimer->stop();
+        emit finished();
+        return;
+    }
+
+    m_currentOperation = m_pendingOperations.dequeue();
+    m_context.reset(new Context());
+
+    auto context = m_context;
+    auto job = m_currentOperation.m_job;
+    m_watcher->setFuture(QtConcurrent::run([context, job]() {
+        try {
+            return job(*context) && !context->isCancelled();
+        } catch (Exception &p_e) {
+            qWarning() << "file operation failed" << p_e.what();
+            return false;
+        }
+    }));
+
+    emitProgress();
+    m_progressTimer->start();
+}
+
+void FileOperationQueue::finishCurrent()
+{
+    Q_ASSERT(m_context);
+    const bool succeeded = m_watcher->result();
+    m_context.reset();
+
+    auto op = m_currentOperation;
+    m_currentOperation = Operation();
+    callBack(op, succeeded);
+
+    startNext();
+}
+
+void FileOperationQueue::emitProgress()
+{
+    if (!m_context) {
+        return;
+    }
+
+    emit progressChanged(m_currentOperation.m_description,
+                         m_context->getDone(),
+                         m_context->getTotal(),
+                         m_pendingOperations.size());
+}
+
+void FileOperationQueue::callBack(const Operation &p_op, bool p_succeeded)
+{
+    if (p_op.m_receiver && p_op.m_callback) {
+        p_op.m_callback(p_succeeded);
+    }
+}
+
+bool FileOperationQueue::removeDir(Context &p_context, const QString &p_dirPath)
+{
+    QStringList files;
+    QDirIterator it(p_dirPath,
+                    QDir::Files | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        files << it.next();
+        if (p_context.isCancelled()) {
+            return false;
+        }
+    }
+
+    // The last unit for the folders.
+    p_context.addTotal(files.size() + 1);
+
+    for (const auto &file : files) {
+        if (p_context.isCancelled()) {
+            return false;
+        }
+
+        if (!QFile::remove(file)) {
+            qWarning() << "failed to remove file" << file;
+            return false;
+        }
+
+        p_context.addDone();
+    }
+
+    if (p_context.isCancelled()) {
+        return false;
+    }
+
+    if (!QDir(p_dirPath).removeRecursively()) {
+        qWarning() << "failed to remove dir" << p_dirPath;
+        return false;
+    }
+
+    p_context.addDone();
+    return true;
+}
+
+bool FileOperationQueue::copyDir(Context &p_context, const QString &p_dirPath, const QString &p_destPath)
+{
+    const QDir srcDir(p_dirPath);
+    QStringList dirs;
+    QStringList files;
+    QDirIterator it(p_dirPath,
+                    QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const auto path = it.next();
+        if (it.fileInfo().isDir()) {
+            dirs << srcDir.relativeFilePath(path);
+        } else {
+            files << srcDir.relativeFilePath(path);
+        }
+
+        if (p_context.isCancelled()) {
+            return false;
+        }
+    }
+
+    p_context.addTotal(files.size());
+
+    QDir destDir(p_destPath);
+    if (!destDir.mkpath(QStringLiteral("."))) {
+        qWarning() << "failed to make dir" << p_destPath;
+        return false;
+    }
+
+    for (const auto &dir : dirs) {
+        if (!destDir.mkpath(dir)) {
+            qWarning() << "failed to make dir" << destDir.filePath(dir);
+            return false;
+        }
+    }
+
+    for (const auto &file : files) {
+        if (p_context.isCancelled()) {
+            return false;
+        }
+
+        if (!QFile::copy(srcDir.filePath(file), destDir.filePath(file))) {
+            qWarning() << "failed to copy file" << srcDir.filePath(file) << "to" << destDir.filePath(file);
+            return false;
+        }
+
+        p_context.addDone();
+    }
+
+    return !p_context.isCancelled();
+}
@@ -0,0 +1,121 @@
+#ifndef FILEOPERATIONQUEUE_H
+#define FILEOPERATIONQUEUE_H
+
+#include <QObject>
+#include <QQueue>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QFutureWatcher>
+
+#include <functional>
+
+class QTimer;
+
+namespace vnotex
+{
+    // Run heavy file operations one by one in a worker thread.
+    // A job only touches files while its callback, called in the main thread
+    // once the job finishes, commits the changes to the node tree and configs.
+    class FileOperationQueue : public QObject
+    {
+        Q_OBJECT
+    public:
+        // Shared by the worker thread and the main thread.
+        class Context
+        {
+        public:
+            bool isCancelled() const;
+
+            // Add @p_count units to the work of the job.
+            void addTotal(int p_count);
+
+            void addDone(int p_count = 1);
+
+            int getTotal() const;
+
+            int getDone() const;
+
+        private:
+            friend class FileOperationQueue;
+
+            QAtomicInt m_total = 0;
+
+            QAtomicInt m_done = 0;
+
+            QAtomicInt m_cancelled = 0;
+        };
+
+        // Return true if succeeded. Exceptions are treated as failure.
+        typedef std::function<bool(Context &)> Job;
+
+        typedef std::function<void(bool p_succeeded)> Callback;
+
+        explicit FileOperationQueue(QObject *p_parent = nullptr);
+
+        ~FileOperationQueue();
+
+        // Queue @p_job after pending ones.
+        // @p_callback will be skipped if @p_receiver is destroyed.
+        void enqueue(const QString &p_description,
+                     const Job &p_job,
+                     QObject *p_receiver,
+                     const Callback &p_callback);
+
+        bool isBusy() const;
+
+        // Cancel current and pending jobs. Cancelled jobs are reported as failure.
+        // Jobs enqueued by their callbacks still run.
+        // Files already removed could not be restored.
+        void cancel();
+
+        // Remove folder @p_dirPath file by file so that it could be cancelled in between.
+        static bool removeDir(Context &p_context, const QString &p_dirPath);
+
+        // Copy the files within folder @p_dirPath into folder @p_destPath file by file.
+        // @p_destPath may exist. It is left as is on failure for the caller to roll back.
+        static bool copyDir(Context &p_context, const QString &p_dirPath, const QString &p_destPath);
+
+    signals:
+        // @p_pending: number of jobs after current one.
+        void progressChanged(const QString &p_description, int p_done, int p_total, int p_pending);
+
+        // All jobs finished.
+        void finished();
+
+    private:
+        struct Operation
+        {
+            QString m_description;
+
+            Job m_job;
+
+            QPointer<QObject> m_receiver;
+
+            Callback m_callback;
+        };
+
+        void startNext();
+
+        void finishCurrent();
+
+        void emitProgress();
+
+        static void callBack(const Operation &p_op, bool p_succeeded);
+
+        QQueue<Operation> m_pendingOperations;
+
+        Operation m_currentOperation;
+
+        // Null if no job is running.
+        QSharedPointer<Context> m_context;
+
+        // Managed by QObject.
+        QFutureWatcher<bool> *m_watcher = nullptr;
+
+        // Managed by QObject.
+        QTimer *m_progressTimer = nullptr;
+    };
+} // ns vnotex
+
+#endif // FILEOPERATIONQUEUE_H
@@ -0,0 +1,163 @@
+#include "filewatcher.h"
+
+#include <QFileSystemWatcher>
+#include <QFileInfo>
+#include <QTimer>
+
+#include <utils/pathutils.h>
+
+using namespace vnotex;
+
+FileWatcher::FileWatcher(QObject *p_parent)
+    : QObject(p_parent)
+{
+    m_watcher = new QFileSystemWatcher(this);
+    connect(m_watcher, &QFileSystemWatcher::fileChanged,
+            this, &FileWatcher::handleFileChanged);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged,
+            this, &FileWatcher::handleDirectoryChanged);
+
+    // Editors may write a file in several steps.
+    m_coalesceTimer = new QTimer(this);
+    m_coalesceTimer->setSingleShot(true);
+    m_coalesceTimer->setInterval(300);
+    connect(m_coalesceTimer, &QTimer::timeout,
+            this, &FileWatcher::emitChanges);
+}
+
+QString FileWatcher::normalizePath(const QString &p_path)
+{
+    return PathUtils::cleanPath(p_path);
+}
+
+void FileWatcher::addPath(const QString &p_path)
+{
+    if (p_path.isEmpty()) {
+        return;
+    }
+
+    const auto path = normalizePath(p_path);
+    auto &cnt = m_refCounts[path];
+    if (cnt++ == 0) {
+        if (QFileInfo::exists(path)) {
+            m_watcher->addPath(path);
+        } else {
+            addPendingFile(path);
+        }
+    }
+}
+
+void FileWatcher::addPendingFile(const QString &p_path)
+{
+    const auto dirPath = PathUtils::parentDirPath(p_path);
+    auto &files = m_pendingFiles[dirPath];
+    if (files.isEmpty() && !m_refCounts.contains(dirPath) && QFileInfo::exists(dirPath)) {
+        m_watcher->addPath(dirPath);
+    }
+    files.insert(p_path);
+}
+
+void FileWatcher::removePendingFile(const QString &p_path)
+{
+    const auto dirPath = PathUtils::parentDirPath(p_path);
+    auto it = m_pendingFiles.find(dirPath);
+    if (it == m_pendingFiles.end() || !it.value().remove(p_path)) {
+        return;
+    }
+
+    if (it.value().isEmpty()) {
+        m_pendingFiles.erase(it);
+        if (!m_refCounts.contains(dirPath)) {
+            m_watcher->removePath(dirPath);
+        }
+    }
+}
+
+bool FileWatcher::checkPendingFiles(const QString &p_dirPath)
+{
+    auto it = m_pendingFiles.constFind(p_dirPath);
+    if (it == m_pendingFiles.constEnd()) {
+        return false;
+    }
+
+    bool promoted = false;
+    const auto files = it.value();
+    for (const auto &file : files) {
+        if (QFileInfo::exists(file)) {
+            removePendingFile(file);
+            m_watcher->addPath(file);
+            m_changedFiles.insert(file);
+            promoted = true;
+        }
+    }
+    return promoted;
+}
+
+void FileWatcher::removePath(const QString &p_path)
+{
+    const auto path = normalizePath(p_path);
+    auto it = m_refCounts.find(path);
+    if (it == m_refCounts.end()) {
+        return;
+    }
+
+    if (--it.value() == 0) {
+        m_refCounts.erase(it);
+        if (m_watcher->files().contains(path)
+            || (m_watcher->directories().contains(path) && !m_pendingFiles.contains(path))) {
+            m_watcher->removePath(path);
+        }
+        removePendingFile(path);
+    }
+}
+
+bool FileWatcher::isWatched(const QString &p_path) const
+{
+    return m_refCounts.contains(normalizePath(p_path));
+}
+
+void FileWatcher::handleFileChanged(const QString &p_path)
+{
+    // The watch is dropped if the file is replaced by a rename, which is common for editors.
+    if (!m_watcher->files().contains(p_path) && m_refCounts.contains(p_path)) {
+        if (QFileInfo::exists(p_path)) {
+            m_watcher->addPath(p_path);
+        } else {
+            // Removed or renamed away. It may come back later.
+            addPendingFile(p_path);
+        }
+    }
+
+    m_changedFiles.insert(p_path);
+    m_coalesceTimer->start();
+}
+
+void FileWatcher::handleDirectoryChanged(const QString &p_path)
+{
+    bool changed = checkPendingFiles(p_path);
+
+    // Folders watched only for pending files are not reported.
+    if (m_refCounts.contains(p_path)) {
+        m_changedDirs.insert(p_path);
+        changed = true;
+    }
+
+    if (changed) {
+        m_coalesceTimer->start();
+    }
+}
+
+void FileWatcher::emitChanges()
+{
+    if (!m_changedFiles.isEmpty()) {
+        const auto files = m_changedFiles.values();
+        m_changedFiles.clear();
+        emit filesChanged(files);
+    }
+
+    if (!m_changedDirs.isEmpty()) {
+        const auto dirs = m_changedDirs.values();
+        m_changedDirs.clear();
+        emit directoriesChanged(dirs);
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+
+class QFileSystemWatcher;
+class QTimer;
+
+namespace vnotex
+{
+    // Watch files and folders on disk and emit coalesced change events.
+    // Paths are reference counted so that multiple clients could watch the same path.
+    // A file not existing yet, or removed or renamed away, is watched via its parent
+    // folder and promoted to a file watch once it appears.
+    class FileWatcher : public QObject
+    {
+        Q_OBJECT
+    public:
+        explicit FileWatcher(QObject *p_parent = nullptr);
+
+        void addPath(const QString &p_path);
+
+        void removePath(const QString &p_path);
+
+        bool isWatched(const QString &p_path) const;
+
+    signals:
+        // Changes of files, including removals and renames.
+        void filesChanged(const QStringList &p_files);
+
+        // Entries of folders are added, removed or renamed.
+        void directoriesChanged(const QStringList &p_dirs);
+
+    private:
+        void handleFileChanged(const QString &p_path);
+
+        void handleDirectoryChanged(const QString &p_path);
+
+        void emitChanges();
+
+        // Watch @p_path via its parent folder until it appears.
+        void addPendingFile(const QString &p_path);
+
+        void removePendingFile(const QString &p_path);
+
+        // Promote pending files within @p_dirPath which appear now.
+        // Return true if any is promoted.
+        bool checkPendingFiles(const QString &p_dirPath);
+
+        static QString normalizePath(const QString &p_path);
+
+        // Managed by QObject.
+        QFileSystemWatcher *m_watcher = nullptr;
+
+        // Managed by QObject.
+        QTimer *m_coalesceTimer = nullptr;
+
+        QHash<QString, int> m_refCounts;
+
+        // Folder -> watched files not existing within it.
+        QHash<QString, QSet<QString>> m_pendingFiles;
+
+        QSet<QString> m_changedFiles;
+
+        QSet<QString> m_changedDirs;
+    };
+} // ns vnotex
+
+#endif // FILEWATCHER_H
@@ -167,6 +167,11 @@ const QString &HtmlTemplateHelper::getMarkdownViewerTemplate()
     return s_markdownViewerTemplate.m_template;
 }
 
+int HtmlTemplateHelper::getMarkdownViewerTemplateRevision()
+{
+    return s_markdownViewerTemplate.m_revision;
+}
+
 void HtmlTemplateHelper::updateMarkdownViewerTemplate(const MarkdownEditorConfig &p_config)
 {
     if (p_config.revision() == s_markdownViewerTemplate.m_revision) {
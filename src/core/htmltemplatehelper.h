@@ -58,6 +58,7 @@ namespace vnotex
         HtmlTemplateHelper() = delete;
 
         static const QString &getMarkdownViewerTemplate();
+        static int getMarkdownViewerTemplateRevision();
         static void updateMarkdownViewerTemplate(const MarkdownEditorConfig &p_config);
 
         static QString generateMarkdownViewerTemplate(const MarkdownEditorConfig &p_config,
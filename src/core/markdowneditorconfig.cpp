@@ -64,6 +64,8 @@ void MarkdownEditorConfig::init(const QJsonObject &p_app, const QJsonObject &p_u
     m_spellCheckEnabled = READBOOL(QStringLiteral("spell_check"));
 
     m_editorOverriddenFontFamily = READSTR(QStringLiteral("editor_overridden_font_family"));
+
+    m_largeFileSize = READINT(QStringLiteral("large_file_size"));
 }
 
 QJsonObject MarkdownEditorConfig::toJson() const
@@ -97,6 +99,7 @@ QJsonObject MarkdownEditorConfig::toJson() const
     obj[QStringLiteral("smart_table_interval")] = m_smartTableInterval;
     obj[QStringLiteral("spell_check")] = m_spellCheckEnabled;
     obj[QStringLiteral("editor_overridden_font_family")] = m_editorOverriddenFontFamily;
+    obj[QStringLiteral("large_file_size")] = m_largeFileSize;
     return obj;
 }
 
@@ -443,3 +446,13 @@ void MarkdownEditorConfig::setEditorOverriddenFontFamily(const QString &p_family
 {
     updateConfig(m_editorOverriddenFontFamily, p_family, this);
 }
+
+int MarkdownEditorConfig::getLargeFileSize() const
+{
+    return m_largeFileSize;
+}
+
+void MarkdownEditorConfig::setLargeFileSize(int p_size)
+{
+    updateConfig(m_largeFileSize, p_size, this);
+}
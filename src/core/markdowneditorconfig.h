@@ -115,6 +115,9 @@ namespace vnotex
         const QString &getEditorOverriddenFontFamily() const;
         void setEditorOverriddenFontFamily(const QString &p_family);
 
+        int getLargeFileSize() const;
+        void setLargeFileSize(int p_size);
+
     private:
         QString sectionNumberModeToString(SectionNumberMode p_mode) const;
         SectionNumberMode stringToSectionNumberMode(const QString &p_str) const;
@@ -203,6 +206,11 @@ namespace vnotex
 
         // Font family to override the editor's theme.
         QString m_editorOverriddenFontFamily;
+
+        // Files with at least this number of characters are opened in large file mode,
+        // with expensive features disabled until enabled for the file.
+        // 0 to disable large file mode.
+        int m_largeFileSize = 2 * 1024 * 1024;
     };
 }
 
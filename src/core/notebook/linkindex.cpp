@@ -0,0 +1,461 @@
+#include "linkindex.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QRegularExpression>
+#include <QUrl>
+#include <QDebug>
+
+#include <buffer/filetypehelper.h>
+#include <utils/pathutils.h>
+#include <utils/fileutils.h>
+#include <core/exception.h>
+
+using namespace vnotex;
+
+static QString parentPath(const QString &p_path)
+{
+    const int idx = p_path.lastIndexOf(QLatin1Char('/'));
+    return idx == -1 ? QString() : p_path.left(idx);
+}
+
+// Whether @p_pos is within a fenced code block.
+static bool isInCode(const QVector<QPair<int, int>> &p_codeRanges, int p_pos)
+{
+    for (const auto &range : p_codeRanges) {
+        if (p_pos >= range.first && p_pos < range.second) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static QVector<QPair<int, int>> fetchCodeRanges(const QString &p_content)
+{
+    QVector<QPair<int, int>> ranges;
+    static const QRegularExpression fenceReg(QStringLiteral("^ {0,3}(```|~~~)"),
+                                             QRegularExpression::MultilineOption);
+    int start = -1;
+    auto it = fenceReg.globalMatch(p_content);
+    while (it.hasNext()) {
+        const auto match = it.next();
+        if (start == -1) {
+            start = match.capturedStart();
+        } else {
+            ranges.push_back(qMakePair(start, match.capturedEnd()));
+            start = -1;
+        }
+    }
+
+    if (start != -1) {
+        ranges.push_back(qMakePair(start, p_content.size()));
+    }
+    return ranges;
+}
+
+bool LinkIndex::isBuilt() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_built;
+}
+
+void LinkIndex::build(const QString &p_rootFolderPath, const QStringList &p_excludedFolders)
+{
+    int moveCount = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_built) {
+            return;
+        }
+        moveCount = m_moveCount;
+    }
+
+    m_buildCancelled.storeRelease(0);
+
+    const QDir rootDir(p_rootFolderPath);
+    QHash<QString, QSet<QString>> links;
+    QDirIterator it(p_rootFolderPath, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        if (m_buildCancelled.loadAcquire()) {
+            return;
+        }
+
+        const auto filePath = it.next();
+        if (!FileTypeHelper::getInst().getFileType(filePath).isMarkdown()) {
+            continue;
+        }
+
+        const auto notePath = PathUtils::cleanPath(rootDir.relativeFilePath(filePath));
+        bool excluded = false;
+        for (const auto &folder : p_excludedFolders) {
+            if (isUnder(notePath, folder)) {
+                excluded = true;
+                break;
+            }
+        }
+        if (excluded) {
+            continue;
+        }
+
+        QString content;
+        try {
+            content = FileUtils::readTextFile(filePath);
+        } catch (Exception &p_e) {
+            qWarning() << "failed to read note for link index" << filePath << p_e.what();
+            continue;
+        }
+
+        QSet<QString> targets;
+        const auto noteLinks = parseLinks(content, notePath);
+        for (const auto &link : noteLinks) {
+            targets.insert(link.m_targetPath);
+        }
+        if (!targets.isEmpty()) {
+            links.insert(notePath, targets);
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (moveCount != m_moveCount) {
+        // Scanned paths may be stale. Build again on next request.
+        qWarning() << "discarded link index build of" << p_rootFolderPath << "due to moves during the scan";
+        return;
+    }
+
+    for (auto linkIt = links.constBegin(); linkIt != links.constEnd(); ++linkIt) {
+        if (!m_touchedNotes.contains(linkIt.key())) {
+            setLinks(linkIt.key(), linkIt.value());
+        }
+    }
+    m_touchedNotes.clear();
+    m_built = true;
+}
+
+void LinkIndex::cancelBuild()
+{
+    m_buildCancelled.storeRelease(1);
+}
+
+void LinkIndex::updateNote(const QString &p_notePath, const QString &p_content)
+{
+    const auto notePath = PathUtils::cleanPath(p_notePath);
+    QSet<QString> targets;
+    const auto links = parseLinks(p_content, notePath);
+    for (const auto &link : links) {
+        targets.insert(link.m_targetPath);
+    }
+
+    QMutexLocker locker(&m_mutex);
+    setLinks(notePath, targets);
+    if (!m_built) {
+        m_touchedNotes.insert(notePath);
+    }
+}
+
+void LinkIndex::removeNote(const QString &p_path)
+{
+    const auto path = PathUtils::cleanPath(p_path);
+
+    QMutexLocker locker(&m_mutex);
+    const auto notes = m_links.keys();
+    for (const auto &note : notes) {
+        if (isUnder(note, path)) {
+            removeLinks(note);
+        }
+    }
+}
+
+QHash<QString, QSet<QString>> LinkIndex::getLinks(const QString &p_path) const
+{
+    const auto path = PathUtils::cleanPath(p_path);
+
+    QHash<QString, QSet<QString>> links;
+    QMutexLocker locker(&m_mutex);
+    for (auto it = m_links.constBegin(); it != m_links.constEnd(); ++it) {
+        if (isUnder(it.key(), path)) {
+            links.insert(it.key(), it.value());
+        }
+    }
+    return links;
+}
+
+void LinkIndex::restoreLinks(const QHash<QString, QSet<QString>> &p_links)
+{
+    QMutexLocker locker(&m_mutex);
+    for (auto it = p_links.constBegin(); it != p_links.constEnd(); ++it) {
+        setLinks(it.key(), it.value());
+    }
+}
+
+QStringList LinkIndex::getBacklinks(const QString &p_targetPath) const
+{
+    QMutexLocker locker(&m_mutex);
+    QStringList notes = m_backlinks.value(PathUtils::cleanPath(p_targetPath)).values();
+    notes.sort();
+    return notes;
+}
+
+QStringList LinkIndex::movePath(const QString &p_oldPath, const QString &p_newPath)
+{
+    return movePaths(PathMoves() << qMakePair(p_oldPath, p_newPath));
+}
+
+QStringList LinkIndex::movePaths(const PathMoves &p_moves)
+{
+    const auto moves = cleanMoves(p_moves);
+
+    QMutexLocker locker(&m_mutex);
+    ++m_moveCount;
+
+    // Old paths of the affected notes.
+    QSet<QString> affectedNotes;
+    for (auto it = m_backlinks.constBegin(); it != m_backlinks.constEnd(); ++it) {
+        if (mapPath(it.key(), moves) != it.key()) {
+            affectedNotes.unite(it.value());
+        }
+    }
+
+    QStringList movedNotes;
+    for (auto it = m_links.constBegin(); it != m_links.constEnd(); ++it) {
+        if (mapPath(it.key(), moves) == it.key()) {
+            continue;
+        }
+
+        // Targets moved along keep their relative links.
+        movedNotes << it.key();
+        for (const auto &target : it.value()) {
+            if (isLinkChanged(it.key(), target, moves)) {
+                affectedNotes.insert(it.key());
+                break;
+            }
+        }
+    }
+
+    // Notes whose targets change.
+    QSet<QString> remappedNotes(affectedNotes);
+    for (const auto &note : movedNotes) {
+        remappedNotes.insert(note);
+    }
+
+    QHash<QString, QSet<QString>> newLinks;
+    for (const auto &note : remappedNotes) {
+        QSet<QString> targets;
+        for (const auto &target : m_links.value(note)) {
+            targets.insert(mapPath(target, moves));
+        }
+        newLinks.insert(mapPath(note, moves), targets);
+        removeLinks(note);
+    }
+
+    for (auto it = newLinks.constBegin(); it != newLinks.constEnd(); ++it) {
+        setLinks(it.key(), it.value());
+    }
+
+    QStringList notes;
+    for (const auto &note : affectedNotes) {
+        notes << mapPath(note, moves);
+    }
+    notes.sort();
+    return notes;
+}
+
+void LinkIndex::setLinks(const QString &p_notePath, const QSet<QString> &p_targets)
+{
+    removeLinks(p_notePath);
+    if (p_targets.isEmpty()) {
+        return;
+    }
+
+    m_links.insert(p_notePath, p_targets);
+    for (const auto &target : p_targets) {
+        m_backlinks[target].insert(p_notePath);
+    }
+}
+
+void LinkIndex::removeLinks(const QString &p_notePath)
+{
+    auto it = m_links.find(p_notePath);
+    if (it == m_links.end()) {
+        return;
+    }
+
+    for (const auto &target : it.value()) {
+        auto backIt = m_backlinks.find(target);
+        if (backIt != m_backlinks.end()) {
+            backIt.value().remove(p_notePath);
+            if (backIt.value().isEmpty()) {
+                m_backlinks.erase(backIt);
+            }
+        }
+    }
+    m_links.erase(it);
+}
+
+QVector<LinkIndex::Link> LinkIndex::parseLinks(const QString &p_content, const QString &p_notePath)
+{
+    QVector<Link> links;
+    if (p_content.isEmpty()) {
+        return links;
+    }
+
+    // Inline links and images, and reference definitions.
+    static const QRegularExpression inlineReg(QStringLiteral("\\]\\(\\s*(?:<([^>\\n]+)>|([^\\s()<>]+))"));
+    static const QRegularExpression refReg(QStringLiteral("^ {0,3}\\[[^\\]\\n]+\\]:[ \\t]*(?:<([^>\\n]+)>|(\\S+))"),
+                                           QRegularExpression::MultilineOption);
+    static const QRegularExpression schemeReg(QStringLiteral("^[A-Za-z][A-Za-z0-9+.\\-]*:"));
+    static const QRegularExpression suffixReg(QStringLiteral("[#?]"));
+
+    const auto codeRanges = fetchCodeRanges(p_content);
+    const auto noteFolderPath = parentPath(PathUtils::cleanPath(p_notePath));
+
+    auto handleMatch = [&](const QRegularExpressionMatch &p_match) {
+        if (isInCode(codeRanges, p_match.capturedStart())) {
+            return;
+        }
+
+        const int group = p_match.capturedStart(1) != -1 ? 1 : 2;
+        const auto url = p_match.captured(group);
+        if (url.startsWith(QLatin1Char('#'))
+            || url.startsWith(QLatin1Char('/'))
+            || schemeReg.match(url).hasMatch()) {
+            return;
+        }
+
+        Link link;
+        link.m_urlPos = p_match.capturedStart(group);
+        link.m_urlLength = url.size();
+
+        auto path = url;
+        const int suffixIdx = path.indexOf(suffixReg);
+        if (suffixIdx != -1) {
+            link.m_suffix = path.mid(suffixIdx);
+            path = path.left(suffixIdx);
+        }
+        if (path.isEmpty()) {
+            return;
+        }
+
+        link.m_encoded = path.contains(QLatin1Char('%'));
+        if (link.m_encoded) {
+            path = QUrl::fromPercentEncoding(path.toUtf8());
+        }
+
+        link.m_targetPath = QDir::cleanPath(noteFolderPath.isEmpty() ? path : noteFolderPath + QLatin1Char('/') + path);
+        if (link.m_targetPath == QStringLiteral("..") || link.m_targetPath.startsWith(QStringLiteral("../"))) {
+            // Out of the notebook.
+            return;
+        }
+
+        links.push_back(link);
+    };
+
+    auto it = inlineReg.globalMatch(p_content);
+    while (it.hasNext()) {
+        handleMatch(it.next());
+    }
+
+    it = refReg.globalMatch(p_content);
+    while (it.hasNext()) {
+        handleMatch(it.next());
+    }
+
+    std::sort(links.begin(), links.end(), [](const Link &p_a, const Link &p_b) {
+        return p_a.m_urlPos < p_b.m_urlPos;
+    });
+    return links;
+}
+
+QString LinkIndex::rewriteLinks(const QString &p_content,
+                                const QString &p_notePath,
+                                const QString &p_oldPath,
+                                const QString &p_newPath)
+{
+    return rewriteLinks(p_content, p_notePath, PathMoves() << qMakePair(p_oldPath, p_newPath));
+}
+
+QString LinkIndex::rewriteLinks(const QString &p_content,
+                                const QString &p_notePath,
+                                const PathMoves &p_moves)
+{
+    const auto moves = cleanMoves(p_moves);
+    const auto notePath = PathUtils::cleanPath(p_notePath);
+
+    // Links are relative to where the note was before the move.
+    const auto oldNotePath = mapPath(notePath, moves, true);
+    const QDir newNoteFolder(QLatin1Char('/') + parentPath(notePath));
+
+    auto content = p_content;
+    bool changed = false;
+    const auto links = parseLinks(p_content, oldNotePath);
+    // Replace from the end to keep positions valid.
+    for (int i = links.size() - 1; i >= 0; --i) {
+        const auto &link = links[i];
+        const auto newTargetPath = mapPath(link.m_targetPath, moves);
+        if (newTargetPath == link.m_targetPath && oldNotePath == notePath) {
+            continue;
+        }
+
+        auto url = newNoteFolder.relativeFilePath(QLatin1Char('/') + newTargetPath);
+        if (link.m_encoded) {
+            url = QString::fromUtf8(QUrl::toPercentEncoding(url, "/"));
+        } else if (p_content.at(link.m_urlPos - 1) != QLatin1Char('<')) {
+            url.replace(QLatin1Char(' '), QStringLiteral("%20"));
+        }
+        url += link.m_suffix;
+
+        if (p_content.midRef(link.m_urlPos, link.m_urlLength) != url) {
+            content.replace(link.m_urlPos, link.m_urlLength, url);
+            changed = true;
+        }
+    }
+
+    return changed ? content : QString();
+}
+
+QString LinkIndex::mapPath(const QString &p_path, const QString &p_oldPath, const QString &p_newPath)
+{
+    if (!isUnder(p_path, p_oldPath)) {
+        return p_path;
+    }
+
+    return p_newPath + p_path.mid(p_oldPath.size());
+}
+
+QString LinkIndex::mapPath(const QString &p_path, const PathMoves &p_moves, bool p_reverse)
+{
+    for (const auto &move : p_moves) {
+        const auto &from = p_reverse ? move.second : move.first;
+        const auto &to = p_reverse ? move.first : move.second;
+        if (isUnder(p_path, from)) {
+            return to + p_path.mid(from.size());
+        }
+    }
+    return p_path;
+}
+
+LinkIndex::PathMoves LinkIndex::cleanMoves(const PathMoves &p_moves)
+{
+    PathMoves moves;
+    for (const auto &move : p_moves) {
+        moves << qMakePair(PathUtils::cleanPath(move.first), PathUtils::cleanPath(move.second));
+    }
+    return moves;
+}
+
+bool LinkIndex::isLinkChanged(const QString &p_notePath, const QString &p_targetPath, const PathMoves &p_moves)
+{
+    const QDir oldNoteFolder(QLatin1Char('/') + parentPath(p_notePath));
+    const QDir newNoteFolder(QLatin1Char('/') + parentPath(mapPath(p_notePath, p_moves)));
+    return oldNoteFolder.relativeFilePath(QLatin1Char('/') + p_targetPath)
+           != newNoteFolder.relativeFilePath(QLatin1Char('/') + mapPath(p_targetPath, p_moves));
+}
+
+bool LinkIndex::isUnder(const QString &p_path, const QString &p_folderPath)
+{
+    if (p_folderPath.isEmpty()) {
+        return true;
+    }
+
+    return p_path.startsWith(p_folderPath)
+           && (p_path.size() == p_folderPath.size() || p_path.at(p_folderPath.size()) == QLatin1Char('/'));
+}
@@ -0,0 +1,135 @@
+#ifndef LINKINDEX_H
+#define LINKINDEX_H
+
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace vnotex
+{
+    // Index of the relative links between notes of a notebook.
+    // Maps each note to the paths it links to and each path back to the notes linking to it,
+    // so that "what links here" and fixing links after a rename or move only touch the
+    // referring notes instead of scanning the whole notebook.
+    // Paths are relative to the notebook root folder.
+    // Built once in background and then kept in sync on save, move and removal.
+    class LinkIndex
+    {
+    public:
+        struct Link
+        {
+            // Position and length of the URL in the content, excluding angle brackets.
+            int m_urlPos = -1;
+
+            int m_urlLength = 0;
+
+            // Fragment or query suffix of the URL, such as "#section".
+            QString m_suffix;
+
+            // Whether the URL is percent-encoded.
+            bool m_encoded = false;
+
+            // Target path relative to the notebook root folder.
+            QString m_targetPath;
+        };
+
+        // Old and new paths of the notes, folders or files moved together, such as a note
+        // with the images and attachments moved along with it.
+        typedef QVector<QPair<QString, QString>> PathMoves;
+
+        LinkIndex() = default;
+
+        // Whether the index covers the whole notebook.
+        bool isBuilt() const;
+
+        // Scan Markdown files under @p_rootFolderPath. Could be called in a worker thread.
+        // @p_excludedFolders: relative paths of folders to skip, such as the recycle bin.
+        // Notes updated during the scan keep their updated links.
+        void build(const QString &p_rootFolderPath, const QStringList &p_excludedFolders);
+
+        // Stop a running build as soon as possible. The index remains unbuilt.
+        void cancelBuild();
+
+        // Replace links of note @p_notePath with those in @p_content.
+        void updateNote(const QString &p_notePath, const QString &p_content);
+
+        // Remove note or folder @p_path and all the notes under it.
+        void removeNote(const QString &p_path);
+
+        // Links of the notes under note or folder @p_path, keyed by note.
+        QHash<QString, QSet<QString>> getLinks(const QString &p_path) const;
+
+        // Put back links taken by getLinks(), such as those of a note removed as part of a move.
+        void restoreLinks(const QHash<QString, QSet<QString>> &p_links);
+
+        // Notes linking to @p_targetPath.
+        QStringList getBacklinks(const QString &p_targetPath) const;
+
+        // Update the index after note or folder @p_oldPath is moved to @p_newPath.
+        // Return new paths of the notes whose links need a rewrite, which are notes linking
+        // into the moved paths and moved notes linking out of them.
+        QStringList movePath(const QString &p_oldPath, const QString &p_newPath);
+
+        // Update the index after all @p_moves. The first one is the note or folder moved.
+        // Return new paths of the notes whose links need a rewrite.
+        QStringList movePaths(const PathMoves &p_moves);
+
+        // Local relative links in Markdown @p_content of note @p_notePath.
+        static QVector<Link> parseLinks(const QString &p_content, const QString &p_notePath);
+
+        // Rewrite links in @p_content after note or folder @p_oldPath is moved to @p_newPath.
+        // @p_notePath: current path of the note of @p_content, which may have been moved too.
+        // Return null string if nothing changed.
+        static QString rewriteLinks(const QString &p_content,
+                                    const QString &p_notePath,
+                                    const QString &p_oldPath,
+                                    const QString &p_newPath);
+
+        static QString rewriteLinks(const QString &p_content,
+                                    const QString &p_notePath,
+                                    const PathMoves &p_moves);
+
+        // Map @p_path under @p_oldPath to the one under @p_newPath.
+        // Return @p_path if it is not under @p_oldPath.
+        static QString mapPath(const QString &p_path, const QString &p_oldPath, const QString &p_newPath);
+
+        // Map @p_path by the first move of @p_moves containing it, or backwards if @p_reverse.
+        static QString mapPath(const QString &p_path, const PathMoves &p_moves, bool p_reverse = false);
+
+        static bool isUnder(const QString &p_path, const QString &p_folderPath);
+
+    private:
+        void setLinks(const QString &p_notePath, const QSet<QString> &p_targets);
+
+        void removeLinks(const QString &p_notePath);
+
+        static PathMoves cleanMoves(const PathMoves &p_moves);
+
+        // Whether the relative link from note @p_notePath to @p_targetPath changes after @p_moves.
+        static bool isLinkChanged(const QString &p_notePath, const QString &p_targetPath, const PathMoves &p_moves);
+
+        mutable QMutex m_mutex;
+
+        // Note -> targets.
+        QHash<QString, QSet<QString>> m_links;
+
+        // Target -> notes.
+        QHash<QString, QSet<QString>> m_backlinks;
+
+        // Notes updated before the index is built, which the build should not override.
+        QSet<QString> m_touchedNotes;
+
+        // Increased on each move to invalidate a running build.
+        int m_moveCount = 0;
+
+        bool m_built = false;
+
+        QAtomicInt m_buildCancelled = 0;
+    };
+} // ns vnotex
+
+#endif // LINKINDEX_H
@@ -1,15 +1,21 @@
 #include "node.h"
 
 #include <QDir>
+#include <QSet>
+#include <limits>
 
 #include <notebookconfigmgr/inotebookconfigmgr.h>
 #include <notebookbackend/inotebookbackend.h>
 #include <utils/pathutils.h>
+#include <utils/fileutils.h>
 #include <core/exception.h>
 #include "notebook.h"
+#include "nodeindex.h"
 
 using namespace vnotex;
 
+const qint64 Node::c_invalidTime = std::numeric_limits<qint64>::min();
+
 Node::Node(Flags p_flags,
            ID p_id,
            const QString &p_name,
@@ -23,10 +29,10 @@ Node::Node(Flags p_flags,
       m_loaded(true),
       m_flags(p_flags),
       m_id(p_id),
+      m_createdTime(toTime(p_createdTimeUtc)),
+      m_modifiedTime(toTime(p_modifiedTimeUtc)),
       m_name(p_name),
-      m_createdTimeUtc(p_createdTimeUtc),
-      m_modifiedTimeUtc(p_modifiedTimeUtc),
-      m_tags(p_tags),
+      m_tags(p_notebook->internTags(p_tags)),
       m_attachmentFolder(p_attachmentFolder),
       m_parent(p_parent)
 {
@@ -62,11 +68,29 @@ void Node::loadCompleteInfo(ID p_id,
 {
     Q_ASSERT(!m_loaded);
     m_id = p_id;
-    m_createdTimeUtc = p_createdTimeUtc;
-    m_modifiedTimeUtc = p_modifiedTimeUtc;
-    m_tags = p_tags;
+    m_createdTime = toTime(p_createdTimeUtc);
+    m_modifiedTime = toTime(p_modifiedTimeUtc);
+    m_tags = m_notebook->internTags(p_tags);
     m_children = p_children;
+    m_latestModifiedTime = c_invalidTime;
     m_loaded = true;
+    invalidateLatestModifiedTime();
+
+    auto index = m_notebook->getNodeIndex();
+    index->updateNodeId(this);
+    for (const auto &child : m_children) {
+        index->addNode(child);
+    }
+}
+
+qint64 Node::toTime(const QDateTime &p_dateTimeUtc)
+{
+    return p_dateTimeUtc.isValid() ? p_dateTimeUtc.toMSecsSinceEpoch() : c_invalidTime;
+}
+
+QDateTime Node::fromTime(qint64 p_time)
+{
+    return p_time == c_invalidTime ? QDateTime() : QDateTime::fromMSecsSinceEpoch(p_time, Qt::UTC);
 }
 
 bool Node::isRoot() const
@@ -81,7 +105,22 @@ const QString &Node::getName() const
 
 void Node::setName(const QString &p_name)
 {
+    if (m_name == p_name) {
+        return;
+    }
+
+    // Paths of this node and its descendants change.
+    auto index = m_notebook->getNodeIndex();
+    const bool attached = m_parent && isIndexed();
+    if (attached) {
+        index->removeNode(this);
+    }
+
     m_name = p_name;
+
+    if (attached) {
+        index->addNode(sharedFromThis());
+    }
 }
 
 void Node::updateName(const QString &p_name)
@@ -90,9 +129,12 @@ void Node::updateName(const QString &p_name)
         return;
     }
 
+    const auto oldPath = fetchPath();
     getConfigMgr()->renameNode(this, p_name);
     Q_ASSERT(m_name == p_name);
 
+    m_notebook->updateLinksOnMove(oldPath, fetchPath());
+
     emit m_notebook->nodeUpdated(this);
 }
 
@@ -103,11 +145,39 @@ bool Node::containsChild(const QString &p_name, bool p_caseSensitive) const
 
 bool Node::containsChild(const QSharedPointer<Node> &p_node) const
 {
+    if (!p_node || p_node->getParent() != this) {
+        return false;
+    }
+
+    if (isIndexed()) {
+        return p_node->isIndexed();
+    }
+
     return m_children.indexOf(p_node) != -1;
 }
 
+bool Node::isIndexed() const
+{
+    return m_notebook->getNodeIndex()->findNodeByPath(fetchPath()).data() == this;
+}
+
 QSharedPointer<Node> Node::findChild(const QString &p_name, bool p_caseSensitive) const
 {
+    // Children of an indexed node are indexed, too. The index could not tell
+    // a case insensitive match on case sensitive platforms.
+    if ((p_caseSensitive || !FileUtils::isPlatformNameCaseSensitive()) && isIndexed()) {
+        auto child = m_notebook->getNodeIndex()->findNodeByPath(PathUtils::concatenateFilePath(fetchPath(), p_name));
+        if (!child || child->getParent() != this) {
+            return nullptr;
+        }
+
+        if (p_caseSensitive ? child->getName() == p_name
+                            : child->getName().toLower() == p_name.toLower()) {
+            return child;
+        }
+        return nullptr;
+    }
+
     auto targetName = p_caseSensitive ? p_name : p_name.toLower();
     for (const auto &child : m_children) {
         if (p_caseSensitive ? child->getName() == targetName
@@ -136,7 +206,7 @@ Node::Flags Node::getFlags() const
 
 Node::Use Node::getUse() const
 {
-    return m_use;
+    return static_cast<Use>(m_use);
 }
 
 void Node::setUse(Node::Use p_use)
@@ -149,19 +219,64 @@ ID Node::getId() const
     return m_id;
 }
 
-const QDateTime &Node::getCreatedTimeUtc() const
+QDateTime Node::getCreatedTimeUtc() const
 {
-    return m_createdTimeUtc;
+    return fromTime(m_createdTime);
 }
 
-const QDateTime &Node::getModifiedTimeUtc() const
+QDateTime Node::getModifiedTimeUtc() const
 {
-    return m_modifiedTimeUtc;
+    return fromTime(m_modifiedTime);
 }
 
 void Node::setModifiedTimeUtc()
 {
-    m_modifiedTimeUtc = QDateTime::currentDateTimeUtc();
+    m_modifiedTime = QDateTime::currentMSecsSinceEpoch();
+    invalidateLatestModifiedTime();
+}
+
+QDateTime Node::fetchLatestModifiedTimeUtc() const
+{
+    if (!isContainer()) {
+        return getModifiedTimeUtc();
+    }
+
+    if (!m_loaded) {
+        return fromTime(m_latestModifiedTime != c_invalidTime ? m_latestModifiedTime : m_modifiedTime);
+    }
+
+    if (!m_latestModifiedTimeCached) {
+        // Invalid time is the minimum.
+        auto latest = m_modifiedTime;
+        for (const auto &child : m_children) {
+            latest = qMax(latest, toTime(child->fetchLatestModifiedTimeUtc()));
+        }
+        m_latestModifiedTime = latest;
+        m_latestModifiedTimeCached = true;
+    }
+
+    return fromTime(m_latestModifiedTime);
+}
+
+void Node::invalidateLatestModifiedTime()
+{
+    m_latestModifiedTimeCached = false;
+
+    // An ancestor is not cached if any node within it is not.
+    for (auto node = m_parent; node && node->m_latestModifiedTimeCached; node = node->m_parent) {
+        node->m_latestModifiedTimeCached = false;
+    }
+}
+
+void Node::setCachedTimesUtc(const QDateTime &p_createdTimeUtc,
+                             const QDateTime &p_modifiedTimeUtc,
+                             const QDateTime &p_latestModifiedTimeUtc)
+{
+    Q_ASSERT(isContainer() && !m_loaded);
+    m_createdTime = toTime(p_createdTimeUtc);
+    m_modifiedTime = toTime(p_modifiedTimeUtc);
+    m_latestModifiedTime = toTime(p_latestModifiedTimeUtc);
+    invalidateLatestModifiedTime();
 }
 
 const QVector<QSharedPointer<Node>> &Node::getChildrenRef() const
@@ -191,12 +306,20 @@ void Node::insertChild(int p_idx, const QSharedPointer<Node> &p_node)
     p_node->setParent(this);
 
     m_children.insert(p_idx, p_node);
+
+    m_notebook->getNodeIndex()->addNode(p_node);
+
+    invalidateLatestModifiedTime();
 }
 
 void Node::removeChild(const QSharedPointer<Node> &p_child)
 {
     if (m_children.removeOne(p_child)) {
+        // Path is computed from the parent so remove it from index first.
+        m_notebook->getNodeIndex()->removeNode(p_child.data());
         p_child->setParent(nullptr);
+
+        invalidateLatestModifiedTime();
     }
 }
 
@@ -103,11 +103,21 @@ namespace vnotex
 
         ID getId() const;
 
-        const QDateTime &getCreatedTimeUtc() const;
+        QDateTime getCreatedTimeUtc() const;
 
-        const QDateTime &getModifiedTimeUtc() const;
+        QDateTime getModifiedTimeUtc() const;
         void setModifiedTimeUtc();
 
+        // Latest modified time of this node and its descendants.
+        // Unloaded containers contribute the time cached in their parent's config.
+        QDateTime fetchLatestModifiedTimeUtc() const;
+
+        // Set times of an unloaded container cached in its parent's config.
+        // Used to sort it without loading.
+        void setCachedTimesUtc(const QDateTime &p_createdTimeUtc,
+                               const QDateTime &p_modifiedTimeUtc,
+                               const QDateTime &p_latestModifiedTimeUtc);
+
         const QVector<QSharedPointer<Node>> &getChildrenRef() const;
         QVector<QSharedPointer<Node>> getChildren() const;
         int getChildrenCount() const;
@@ -185,19 +195,38 @@ namespace vnotex
         Notebook *m_notebook = nullptr;
 
     private:
+        // Times are kept as msecs since epoch to keep nodes small.
+        static qint64 toTime(const QDateTime &p_dateTimeUtc);
+
+        static QDateTime fromTime(qint64 p_time);
+
+        // Whether this node is attached and in the node index of the notebook.
+        bool isIndexed() const;
+
+        // Drop the cached latest modified time of this node and its ancestors.
+        void invalidateLatestModifiedTime();
+
+        // Members are ordered to avoid padding.
         bool m_loaded = false;
 
-        Flags m_flags = Flag::None;
+        quint8 m_use = Use::Normal;
 
-        Use m_use = Use::Normal;
+        // Whether m_latestModifiedTime of a loaded container is computed.
+        mutable bool m_latestModifiedTimeCached = false;
+
+        Flags m_flags = Flag::None;
 
         ID m_id = InvalidId;
 
-        QString m_name;
+        qint64 m_createdTime = c_invalidTime;
 
-        QDateTime m_createdTimeUtc;
+        qint64 m_modifiedTime = c_invalidTime;
 
-        QDateTime m_modifiedTimeUtc;
+        // Cached in parent's config before a container is loaded, and cached from
+        // the children after loaded.
+        mutable qint64 m_latestModifiedTime = c_invalidTime;
+
+        QString m_name;
 
         QStringList m_tags;
 
@@ -206,6 +235,8 @@ namespace vnotex
         Node *m_parent = nullptr;
 
         QVector<QSharedPointer<Node>> m_children;
+
+        static const qint64 c_invalidTime;
     };
 
     Q_DECLARE_OPERATORS_FOR_FLAGS(Node::Flags)
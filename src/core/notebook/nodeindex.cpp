@@ -0,0 +1,92 @@
+#include "nodeindex.h"
+
+#include <utils/pathutils.h>
+#include <utils/fileutils.h>
+#include "node.h"
+
+using namespace vnotex;
+
+void NodeIndex::addNode(const QSharedPointer<Node> &p_node)
+{
+    Q_ASSERT(p_node);
+    m_pathIndex.insert(normalizePath(p_node->fetchPath()), p_node);
+
+    const auto id = p_node->getId();
+    if (id != Node::InvalidId) {
+        m_idIndex.insert(id, p_node);
+    }
+
+    if (p_node->isLoaded()) {
+        for (const auto &child : p_node->getChildrenRef()) {
+            addNode(child);
+        }
+    }
+}
+
+void NodeIndex::removeNode(const Node *p_node)
+{
+    Q_ASSERT(p_node);
+    removeNodeInternal(p_node, normalizePath(p_node->fetchPath()));
+}
+
+void NodeIndex::removeNodeInternal(const Node *p_node, const QString &p_path)
+{
+    auto pathIt = m_pathIndex.find(p_path);
+    if (pathIt != m_pathIndex.end() && pathIt.value().data() == p_node) {
+        m_pathIndex.erase(pathIt);
+    }
+
+    auto idIt = m_idIndex.find(p_node->getId());
+    if (idIt != m_idIndex.end() && idIt.value().data() == p_node) {
+        m_idIndex.erase(idIt);
+    }
+
+    if (p_node->isLoaded()) {
+        for (const auto &child : p_node->getChildrenRef()) {
+            removeNodeInternal(child.data(), normalizePath(PathUtils::concatenateFilePath(p_path, child->getName())));
+        }
+    }
+}
+
+void NodeIndex::updateNodeId(const Node *p_node)
+{
+    const auto id = p_node->getId();
+    if (id == Node::InvalidId) {
+        return;
+    }
+
+    auto node = m_pathIndex.value(normalizePath(p_node->fetchPath())).toStrongRef();
+    if (node.data() == p_node) {
+        m_idIndex.insert(id, node);
+    }
+}
+
+QSharedPointer<Node> NodeIndex::findNodeById(ID p_id) const
+{
+    return m_idIndex.value(p_id).toStrongRef();
+}
+
+QSharedPointer<Node> NodeIndex::findNodeByPath(const QString &p_relativePath) const
+{
+    return m_pathIndex.value(normalizePath(p_relativePath)).toStrongRef();
+}
+
+void NodeIndex::clear()
+{
+    m_idIndex.clear();
+    m_pathIndex.clear();
+}
+
+QString NodeIndex::normalizePath(const QString &p_relativePath)
+{
+    auto path = PathUtils::cleanPath(p_relativePath);
+    if (path == QStringLiteral(".")) {
+        path.clear();
+    }
+
+    if (!FileUtils::isPlatformNameCaseSensitive()) {
+        path = path.toLower();
+    }
+
+    return path;
+}
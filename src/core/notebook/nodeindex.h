@@ -0,0 +1,51 @@
+#ifndef NODEINDEX_H
+#define NODEINDEX_H
+
+#include <QHash>
+#include <QSharedPointer>
+#include <QWeakPointer>
+
+#include <global.h>
+
+namespace vnotex
+{
+    class Node;
+
+    // Index of the loaded nodes of a notebook by ID and by relative path.
+    // Nodes are added as they are loaded and kept in sync on rename, move and removal,
+    // so a lookup never touches the disk.
+    class NodeIndex
+    {
+    public:
+        NodeIndex() = default;
+
+        // Add @p_node and all its loaded descendants.
+        void addNode(const QSharedPointer<Node> &p_node);
+
+        // Remove @p_node and all its loaded descendants.
+        // Entries now owned by another node (such as a moved node keeping its ID) are kept.
+        void removeNode(const Node *p_node);
+
+        // Add ID of @p_node if it is already indexed by path.
+        // Used when a container node gets its ID after loading.
+        void updateNodeId(const Node *p_node);
+
+        QSharedPointer<Node> findNodeById(ID p_id) const;
+
+        // @p_relativePath: path relative to the notebook root folder.
+        QSharedPointer<Node> findNodeByPath(const QString &p_relativePath) const;
+
+        void clear();
+
+        static QString normalizePath(const QString &p_relativePath);
+
+    private:
+        void removeNodeInternal(const Node *p_node, const QString &p_path);
+
+        QHash<ID, QWeakPointer<Node>> m_idIndex;
+
+        QHash<QString, QWeakPointer<Node>> m_pathIndex;
+    };
+} // ns vnotex
+
+#endif // NODEINDEX_H
@@ -0,0 +1,106 @@
+#include "nodeloader.h"
+
+#include <QtConcurrent>
+#include <QDebug>
+
+#include <notebookconfigmgr/inotebookconfigmgr.h>
+#include "exception.h"
+#include "notebook.h"
+#include "node.h"
+
+using namespace vnotex;
+
+NodeLoader::NodeLoader(Notebook *p_notebook)
+    : m_notebook(p_notebook)
+{
+}
+
+NodeLoader::~NodeLoader()
+{
+    // Workers may still access the config manager.
+    const auto watchers = findChildren<QFutureWatcherBase *>();
+    for (auto watcher : watchers) {
+        watcher->waitForFinished();
+    }
+}
+
+bool NodeLoader::load(const QSharedPointer<Node> &p_node)
+{
+    Q_ASSERT(p_node);
+    if (p_node->isLoaded() || !p_node->isContainer() || !p_node->exists()) {
+        return false;
+    }
+
+    auto it = m_pendingLoads.find(p_node.data());
+    if (it != m_pendingLoads.end()) {
+        if (it->m_node.toStrongRef() == p_node) {
+            return true;
+        }
+
+        // A stale load of a deleted node at the same address.
+        m_pendingLoads.erase(it);
+    }
+
+    auto configMgr = m_notebook->getConfigMgr().data();
+    const auto path = p_node->fetchPath();
+    const Node *key = p_node.data();
+
+    auto watcher = new LoadWatcher(this);
+    connect(watcher, &LoadWatcher::finished,
+            this, [this, key, watcher]() {
+                finishLoad(key, watcher);
+            });
+
+    PendingLoad pending;
+    pending.m_node = p_node;
+    pending.m_watcher = watcher;
+    m_pendingLoads.insert(key, pending);
+
+    watcher->setFuture(QtConcurrent::run([configMgr, path]() {
+        try {
+            return configMgr->readNodeLoadData(path);
+        } catch (Exception &p_e) {
+            qWarning() << "failed to read node data" << path << p_e.what();
+            return QSharedPointer<NodeLoadData>();
+        }
+    }));
+
+    return true;
+}
+
+bool NodeLoader::isLoading(const Node *p_node) const
+{
+    return m_pendingLoads.contains(p_node);
+}
+
+void NodeLoader::finishLoad(const Node *p_key, LoadWatcher *p_watcher)
+{
+    p_watcher->deleteLater();
+
+    auto it = m_pendingLoads.find(p_key);
+    if (it == m_pendingLoads.end() || it->m_watcher != p_watcher) {
+        return;
+    }
+
+    auto node = it->m_node.toStrongRef();
+    m_pendingLoads.erase(it);
+    if (!node) {
+        return;
+    }
+
+    if (!node->isLoaded()) {
+        try {
+            auto data = p_watcher->result();
+            if (data) {
+                m_notebook->getConfigMgr()->applyNodeLoadData(node.data(), data);
+            } else {
+                // Not supported or failed in the worker. Load it in place.
+                node->load();
+            }
+        } catch (Exception &p_e) {
+            qWarning() << "failed to load node" << node->fetchPath() << p_e.what();
+        }
+    }
+
+    emit nodeLoaded(node.data());
+}
@@ -0,0 +1,56 @@
+#ifndef NODELOADER_H
+#define NODELOADER_H
+
+#include <QObject>
+#include <QHash>
+#include <QSharedPointer>
+#include <QWeakPointer>
+#include <QFutureWatcher>
+
+namespace vnotex
+{
+    class Node;
+    class Notebook;
+    class NodeLoadData;
+
+    // Load container nodes of a notebook asynchronously.
+    // Config files are read in a worker thread while the node tree is only
+    // touched in the main thread.
+    class NodeLoader : public QObject
+    {
+        Q_OBJECT
+    public:
+        explicit NodeLoader(Notebook *p_notebook);
+
+        ~NodeLoader();
+
+        // Start loading @p_node in a worker thread. Loads of the same node are merged.
+        // Return true if nodeLoaded() will be emitted for @p_node later, or false if
+        // there is nothing to load asynchronously.
+        bool load(const QSharedPointer<Node> &p_node);
+
+        bool isLoading(const Node *p_node) const;
+
+    signals:
+        // @p_node may still be unloaded if it failed to load.
+        void nodeLoaded(Node *p_node);
+
+    private:
+        typedef QFutureWatcher<QSharedPointer<NodeLoadData>> LoadWatcher;
+
+        struct PendingLoad
+        {
+            QWeakPointer<Node> m_node;
+
+            LoadWatcher *m_watcher = nullptr;
+        };
+
+        void finishLoad(const Node *p_key, LoadWatcher *p_watcher);
+
+        Notebook *m_notebook = nullptr;
+
+        QHash<const Node *, PendingLoad> m_pendingLoads;
+    };
+} // ns vnotex
+
+#endif // NODELOADER_H
@@ -1,13 +1,24 @@
 #include "notebook.h"
 
 #include <QFileInfo>
+#include <QPointer>
+#include <QtConcurrent>
+#include <QDebug>
+
+#include <vtextedit/markdownutils.h>
 
 #include <versioncontroller/iversioncontroller.h>
 #include <notebookbackend/inotebookbackend.h>
 #include <notebookconfigmgr/inotebookconfigmgr.h>
 #include <utils/pathutils.h>
 #include <utils/fileutils.h>
+#include <core/fileoperationqueue.h>
+#include <core/events.h>
+#include <core/file.h>
 #include "exception.h"
+#include "nodeindex.h"
+#include "nodeloader.h"
+#include "linkindex.h"
 
 using namespace vnotex;
 
@@ -35,7 +46,10 @@ Notebook::Notebook(const NotebookParameters &p_paras,
       m_createdTimeUtc(p_paras.m_createdTimeUtc),
       m_backend(p_paras.m_notebookBackend),
       m_versionController(p_paras.m_versionController),
-      m_configMgr(p_paras.m_notebookConfigMgr)
+      m_configMgr(p_paras.m_notebookConfigMgr),
+      m_nodeIndex(new NodeIndex()),
+      m_linkIndex(new LinkIndex()),
+      m_nodeLoader(new NodeLoader(this))
 {
     if (m_imageFolder.isEmpty()) {
         m_imageFolder = c_defaultImageFolder;
@@ -44,10 +58,14 @@ Notebook::Notebook(const NotebookParameters &p_paras,
         m_attachmentFolder = c_defaultAttachmentFolder;
     }
     m_configMgr->setNotebook(this);
+
+    m_linkRewriteQueue = new FileOperationQueue(this);
 }
 
 Notebook::~Notebook()
 {
+    m_linkIndex->cancelBuild();
+    m_linkIndexFuture.waitForFinished();
 }
 
 vnotex::ID Notebook::getId() const
@@ -153,6 +171,7 @@ const QSharedPointer<Node> &Notebook::getRootNode() const
     if (!m_root) {
         const_cast<Notebook *>(this)->m_root = m_configMgr->loadRootNode();
         Q_ASSERT(m_root->isRoot());
+        m_nodeIndex->addNode(m_root);
     }
 
     return m_root;
@@ -188,25 +207,181 @@ const QDateTime &Notebook::getCreatedTimeUtc() const
     return m_createdTimeUtc;
 }
 
-QSharedPointer<Node> Notebook::loadNodeByPath(const QString &p_path)
+bool Notebook::toRelativePath(const QString &p_path, QString &p_relativePath) const
 {
     if (!PathUtils::pathContains(m_rootFolderPath, p_path)) {
+        return false;
+    }
+
+    if (QFileInfo(p_path).isAbsolute()) {
+        p_relativePath = PathUtils::relativePath(m_rootFolderPath, p_path);
+    } else {
+        p_relativePath = p_path;
+    }
+    return true;
+}
+
+QSharedPointer<Node> Notebook::loadNodeByPath(const QString &p_path)
+{
+    QString relativePath;
+    if (!toRelativePath(p_path, relativePath)) {
+        return nullptr;
+    }
+
+    // Try the index first to avoid walking and loading the tree.
+    auto node = m_nodeIndex->findNodeByPath(relativePath);
+    if (node) {
+        return node;
+    }
+
+    if (QFileInfo(p_path).isAbsolute() && !QFileInfo::exists(p_path)) {
         return nullptr;
     }
 
+    return m_configMgr->loadNodeByPath(getRootNode(), relativePath);
+}
+
+QSharedPointer<Node> Notebook::findNodeById(ID p_id) const
+{
+    return m_nodeIndex->findNodeById(p_id);
+}
+
+QSharedPointer<Node> Notebook::findNodeByPath(const QString &p_path) const
+{
     QString relativePath;
-    QFileInfo fi(p_path);
-    if (fi.isAbsolute()) {
-        if (!fi.exists()) {
-            return nullptr;
+    if (!toRelativePath(p_path, relativePath)) {
+        return nullptr;
+    }
+
+    return m_nodeIndex->findNodeByPath(relativePath);
+}
+
+NodeIndex *Notebook::getNodeIndex() const
+{
+    return m_nodeIndex.data();
+}
+
+NodeLoader *Notebook::getNodeLoader() const
+{
+    return m_nodeLoader.data();
+}
+
+const QSharedPointer<LinkIndex> &Notebook::getLinkIndex() const
+{
+    return m_linkIndex;
+}
+
+QStringList Notebook::getBacklinks(const Node *p_node)
+{
+    Q_ASSERT(p_node->getNotebook() == this);
+    buildLinkIndex();
+    return m_linkIndex->getBacklinks(p_node->fetchPath());
+}
+
+void Notebook::buildLinkIndex()
+{
+    if (m_linkIndex->isBuilt() || m_linkIndexFuture.isRunning()) {
+        return;
+    }
+
+    QStringList excludedFolders;
+    auto recycleBinNode = getRecycleBinNode();
+    if (recycleBinNode) {
+        excludedFolders << recycleBinNode->fetchPath();
+    }
+
+    auto linkIndex = m_linkIndex.data();
+    const auto rootFolderPath = getRootFolderAbsolutePath();
+    m_linkIndexFuture = QtConcurrent::run(INotebookBackend::getIOThreadPool(),
+                                          [linkIndex, rootFolderPath, excludedFolders]() {
+                                              linkIndex->build(rootFolderPath, excludedFolders);
+                                          });
+}
+
+void Notebook::updateLinksOnMove(const QString &p_oldPath, const QString &p_newPath)
+{
+    updateLinksOnMove(LinkIndex::PathMoves() << qMakePair(p_oldPath, p_newPath));
+}
+
+void Notebook::updateLinksOnMove(const QVector<QPair<QString, QString>> &p_moves)
+{
+    Q_ASSERT(!p_moves.isEmpty());
+    const auto &oldPath = p_moves.first().first;
+    const auto &newPath = p_moves.first().second;
+
+    // Let open buffers pick up the new path before their links are rewritten.
+    emit nodePathChanged(m_backend->getFullPath(oldPath), m_backend->getFullPath(newPath));
+
+    auto recycleBinNode = getRecycleBinNode();
+    if (recycleBinNode && LinkIndex::isUnder(newPath, recycleBinNode->fetchPath())) {
+        // Links to a recycled note are broken anyway.
+        m_linkIndex->removeNote(oldPath);
+        return;
+    }
+
+    // Notes not indexed yet are left untouched.
+    const auto notes = m_linkIndex->movePaths(p_moves);
+    buildLinkIndex();
+    if (!notes.isEmpty()) {
+        rewriteLinks(p_moves, notes);
+    }
+}
+
+void Notebook::rewriteLinks(const QVector<QPair<QString, QString>> &p_moves, const QStringList &p_notes)
+{
+    // Open notes are rewritten in their buffers to keep unsaved changes.
+    QStringList notes;
+    for (const auto &note : p_notes) {
+        auto event = QSharedPointer<Event>::create();
+        emit noteLinksRewriteRequested(m_backend->getFullPath(note),
+                                       [note, p_moves](const QString &p_content) {
+                                           return LinkIndex::rewriteLinks(p_content, note, p_moves);
+                                       },
+                                       event);
+        if (!event->m_handled) {
+            notes << note;
         }
+    }
 
-        relativePath = PathUtils::relativePath(m_rootFolderPath, p_path);
-    } else {
-        relativePath = p_path;
+    if (notes.isEmpty()) {
+        return;
     }
 
-    return m_configMgr->loadNodeByPath(getRootNode(), relativePath);
+    auto backend = m_backend;
+    auto job = [backend, p_moves, notes](FileOperationQueue::Context &p_context) {
+        p_context.addTotal(notes.size());
+        FileUtils::DirectorySyncBatch syncBatch;
+        bool succeeded = true;
+        for (const auto &note : notes) {
+            if (p_context.isCancelled()) {
+                return false;
+            }
+
+            try {
+                const auto content = LinkIndex::rewriteLinks(backend->readTextFile(note),
+                                                             note,
+                                                             p_moves);
+                if (!content.isNull()) {
+                    backend->writeFile(note, content);
+                }
+            } catch (Exception &p_e) {
+                qWarning() << "failed to rewrite links of note" << note << p_e.what();
+                succeeded = false;
+            }
+            p_context.addDone();
+        }
+        return succeeded;
+    };
+
+    const auto newPath = p_moves.first().second;
+    m_linkRewriteQueue->enqueue(tr("Update links to %1").arg(newPath),
+                                job,
+                                this,
+                                [newPath](bool p_succeeded) {
+                                    if (!p_succeeded) {
+                                        qWarning() << "failed to update some links to" << newPath;
+                                    }
+                                });
 }
 
 QSharedPointer<Node> Notebook::copyNodeAsChildOf(const QSharedPointer<Node> &p_src, Node *p_dest, bool p_move)
@@ -225,14 +400,203 @@ QSharedPointer<Node> Notebook::copyNodeAsChildOf(const QSharedPointer<Node> &p_s
         return p_src;
     }
 
-    return m_configMgr->copyNodeAsChildOf(p_src, p_dest, p_move);
+    auto srcNotebook = p_src->getNotebook();
+    const auto srcPath = p_src->fetchPath();
+
+    // Removing the source drops links of the moved notes, which movePaths() needs.
+    QHash<QString, QSet<QString>> movedLinks;
+    // Images and attachment folder of a note are copied next to its new place.
+    QStringList imagePaths;
+    QString attachmentFolderPath;
+    QString srcFolderPath;
+    if (p_move && srcNotebook == this) {
+        movedLinks = m_linkIndex->getLinks(srcPath);
+        if (p_src->hasContent() && p_src->exists()) {
+            imagePaths = fetchImagePaths(p_src.data());
+            if (!p_src->getAttachmentFolder().isEmpty()) {
+                attachmentFolderPath = p_src->fetchAttachmentFolderPath();
+            }
+            srcFolderPath = PathUtils::parentDirPath(p_src->fetchAbsolutePath());
+        }
+    }
+
+    auto node = m_configMgr->copyNodeAsChildOf(p_src, p_dest, p_move);
+    if (p_move) {
+        if (!node) {
+            // Source does not exist and is just removed.
+            srcNotebook->getLinkIndex()->removeNote(srcPath);
+        } else if (srcNotebook == this) {
+            m_linkIndex->restoreLinks(movedLinks);
+
+            LinkIndex::PathMoves moves;
+            moves << qMakePair(srcPath, node->fetchPath());
+            const auto rootFolderPath = getRootFolderAbsolutePath();
+            const auto destFolderPath = PathUtils::parentDirPath(node->fetchAbsolutePath());
+            for (const auto &imagePath : imagePaths) {
+                const auto destImagePath = PathUtils::concatenateFilePath(destFolderPath,
+                                                                          PathUtils::relativePath(srcFolderPath, imagePath));
+                moves << qMakePair(PathUtils::relativePath(rootFolderPath, imagePath),
+                                   PathUtils::relativePath(rootFolderPath, destImagePath));
+            }
+            if (!attachmentFolderPath.isEmpty()) {
+                moves << qMakePair(PathUtils::relativePath(rootFolderPath, attachmentFolderPath),
+                                   PathUtils::relativePath(rootFolderPath, node->fetchAttachmentFolderPath()));
+            }
+            updateLinksOnMove(moves);
+        } else {
+            srcNotebook->getLinkIndex()->removeNote(srcPath);
+        }
+    }
+    return node;
+}
+
+QStringList Notebook::fetchImagePaths(Node *p_node)
+{
+    QStringList paths;
+    auto file = p_node->getContentFile();
+    if (!file->getContentType().isMarkdown()) {
+        return paths;
+    }
+
+    try {
+        const auto images =
+            vte::MarkdownUtils::fetchImagesFromMarkdownText(file->read(),
+                                                            PathUtils::parentDirPath(file->getContentPath()),
+                                                            vte::MarkdownLink::TypeFlag::LocalRelativeInternal);
+        for (const auto &link : images) {
+            if (!paths.contains(link.m_path)) {
+                paths << link.m_path;
+            }
+        }
+    } catch (Exception &p_e) {
+        qWarning() << "failed to fetch images of note" << p_node->fetchPath() << p_e.what();
+    }
+    return paths;
+}
+
+QSharedPointer<Node> Notebook::copyNodeAsChildOf(const QSharedPointer<Node> &p_src,
+                                                 Node *p_dest,
+                                                 bool p_move,
+                                                 FileOperationQueue *p_queue,
+                                                 QObject *p_receiver,
+                                                 const std::function<void(const QSharedPointer<Node> &)> &p_callback)
+{
+    Q_ASSERT(p_src != p_dest);
+    Q_ASSERT(p_dest->getNotebook() == this);
+
+    // Files and moves within this notebook are done by a copy or rename of a few files.
+    auto srcNotebook = p_src->getNotebook();
+    if (!p_src->isContainer()
+        || !p_src->exists()
+        || (p_move && (p_src->getParent() == p_dest || (srcNotebook == this && !p_src->isReadOnly())))
+        || Node::isAncestor(p_src.data(), p_dest)) {
+        return copyNodeAsChildOf(p_src, p_dest, p_move);
+    }
+
+    // Reserve the name by making the folder.
+    const auto destPath = m_backend->renameIfExistsCaseInsensitive(PathUtils::concatenateFilePath(p_dest->fetchPath(),
+                                                                                                  p_src->getName()));
+    m_backend->makePath(destPath);
+
+    const auto srcFolderPath = p_src->fetchAbsolutePath();
+    const auto destFolderPath = m_backend->getFullPath(destPath);
+    const auto destName = PathUtils::fileName(destPath);
+    QWeakPointer<Node> weakSrc = p_src;
+    QWeakPointer<Node> weakDest = p_dest->sharedFromThis();
+    QPointer<QObject> receiver = p_receiver;
+    p_queue->enqueue(p_move ? tr("Moving %1").arg(p_src->getName()) : tr("Copying %1").arg(p_src->getName()),
+                     [srcFolderPath, destFolderPath](FileOperationQueue::Context &p_context) {
+                         return FileOperationQueue::copyDir(p_context, srcFolderPath, destFolderPath);
+                     },
+                     this,
+                     [this, weakSrc, weakDest, destName, destFolderPath, p_move, p_queue, receiver, p_callback](bool p_succeeded) {
+                         QSharedPointer<Node> node;
+                         if (p_succeeded) {
+                             node = finishCopyNodeInQueue(weakSrc.toStrongRef(),
+                                                          weakDest.toStrongRef(),
+                                                          destName,
+                                                          p_move,
+                                                          p_queue);
+                         }
+
+                         if (!node) {
+                             // Roll back the files copied.
+                             p_queue->enqueue(tr("Deleting %1").arg(destFolderPath),
+                                              [destFolderPath](FileOperationQueue::Context &p_context) {
+                                                  return FileOperationQueue::removeDir(p_context, destFolderPath);
+                                              },
+                                              nullptr,
+                                              nullptr);
+                         }
+
+                         if (receiver) {
+                             p_callback(node);
+                         }
+                     });
+    return nullptr;
+}
+
+QSharedPointer<Node> Notebook::finishCopyNodeInQueue(const QSharedPointer<Node> &p_src,
+                                                     const QSharedPointer<Node> &p_dest,
+                                                     const QString &p_destName,
+                                                     bool p_move,
+                                                     FileOperationQueue *p_queue)
+{
+    if (!p_src || !p_dest || (!p_dest->getParent() && !p_dest->isRoot())) {
+        // Removed meanwhile.
+        return nullptr;
+    }
+
+    auto srcNotebook = p_src->getNotebook();
+    const bool keepIds = p_move && srcNotebook == this;
+    QSharedPointer<Node> node;
+    try {
+        node = m_configMgr->copyNodeConfigsAsChildOf(p_src, p_dest.data(), p_destName, keepIds);
+    } catch (Exception &p_e) {
+        qWarning() << "failed to add copied nodes" << p_destName << p_e.what();
+        auto partialNode = p_dest->findChild(p_destName, true);
+        if (partialNode) {
+            try {
+                removeNode(partialNode, false, true);
+            } catch (Exception &p_e) {
+                qWarning() << "failed to remove partially added node" << p_destName << p_e.what();
+            }
+        }
+        return nullptr;
+    }
+
+    if (p_move && p_src->getParent()) {
+        // Drop the source from config and delete its files in background.
+        const auto srcPath = p_src->fetchPath();
+        const auto srcFolderPath = p_src->fetchAbsolutePath();
+        if (srcNotebook == this) {
+            updateLinksOnMove(srcPath, node->fetchPath());
+        }
+
+        try {
+            srcNotebook->removeNode(p_src, false, true);
+        } catch (Exception &p_e) {
+            qWarning() << "failed to remove moved node" << srcFolderPath << p_e.what();
+        }
+
+        p_queue->enqueue(tr("Deleting %1").arg(srcFolderPath),
+                         [srcFolderPath](FileOperationQueue::Context &p_context) {
+                             return FileOperationQueue::removeDir(p_context, srcFolderPath);
+                         },
+                         nullptr,
+                         nullptr);
+    }
+
+    return node;
 }
 
 void Notebook::removeNode(const QSharedPointer<Node> &p_node, bool p_force, bool p_configOnly)
 {
     Q_ASSERT(p_node && !p_node->isRoot());
     Q_ASSERT(p_node->getNotebook() == this);
+    const auto path = p_node->fetchPath();
     m_configMgr->removeNode(p_node, p_force, p_configOnly);
+    m_linkIndex->removeNote(path);
 }
 
 void Notebook::removeNode(Node *p_node, bool p_force, bool p_configOnly)
@@ -305,9 +669,7 @@ void Notebook::moveFileToRecycleBin(const QString &p_filePath)
     auto destFilePath = PathUtils::concatenateFilePath(node->fetchPath(),
                                                        PathUtils::fileName(p_filePath));
     destFilePath = getBackend()->renameIfExistsCaseInsensitive(destFilePath);
-    m_backend->copyFile(p_filePath, destFilePath);
-
-    getBackend()->removeFile(p_filePath);
+    m_backend->moveFile(p_filePath, destFilePath);
 
     emit nodeUpdated(node.data());
 }
@@ -318,9 +680,7 @@ void Notebook::moveDirToRecycleBin(const QString &p_dirPath)
     auto destDirPath = PathUtils::concatenateFilePath(node->fetchPath(),
                                                       PathUtils::fileName(p_dirPath));
     destDirPath = getBackend()->renameIfExistsCaseInsensitive(destDirPath);
-    m_backend->copyDir(p_dirPath, destDirPath);
-
-    getBackend()->removeDir(p_dirPath);
+    m_backend->moveDir(p_dirPath, destDirPath);
 
     emit nodeUpdated(node.data());
 }
@@ -352,6 +712,40 @@ QSharedPointer<Node> Notebook::copyAsNode(Node *p_parent,
 
 void Notebook::reloadNodes()
 {
+    m_nodeIndex->clear();
     m_root.clear();
+
+    {
+        QMutexLocker locker(&m_tagsPoolMutex);
+        m_tagsPool.clear();
+        m_tagPool.clear();
+    }
+
     getRootNode();
 }
+
+QStringList Notebook::internTags(const QStringList &p_tags)
+{
+    if (p_tags.isEmpty()) {
+        return QStringList();
+    }
+
+    QMutexLocker locker(&m_tagsPoolMutex);
+    auto it = m_tagsPool.constFind(p_tags);
+    if (it != m_tagsPool.constEnd()) {
+        return *it;
+    }
+
+    QStringList tags;
+    tags.reserve(p_tags.size());
+    for (const auto &tag : p_tags) {
+        auto tagIt = m_tagPool.constFind(tag);
+        if (tagIt == m_tagPool.constEnd()) {
+            tagIt = m_tagPool.insert(tag);
+        }
+        tags << *tagIt;
+    }
+
+    m_tagsPool.insert(tags);
+    return tags;
+}
@@ -4,6 +4,15 @@
 #include <QObject>
 #include <QIcon>
 #include <QSharedPointer>
+#include <QScopedPointer>
+#include <QFuture>
+#include <QMutex>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+#include <QPair>
+
+#include <functional>
 
 #include "notebookparameters.h"
 #include "../global.h"
@@ -14,6 +23,11 @@ namespace vnotex
     class INotebookBackend;
     class IVersionController;
     class INotebookConfigMgr;
+    class NodeIndex;
+    class NodeLoader;
+    class LinkIndex;
+    class FileOperationQueue;
+    class Event;
     struct NodeParameters;
 
     // Base class of notebook.
@@ -92,9 +106,46 @@ namespace vnotex
         // @p_path could be absolute or relative.
         virtual QSharedPointer<Node> loadNodeByPath(const QString &p_path);
 
+        // Find node with ID @p_id among the loaded nodes without touching the disk.
+        QSharedPointer<Node> findNodeById(ID p_id) const;
+
+        // Find node by path among the loaded nodes without touching the disk.
+        // @p_path could be absolute or relative.
+        QSharedPointer<Node> findNodeByPath(const QString &p_path) const;
+
+        NodeIndex *getNodeIndex() const;
+
+        // Used to load nodes asynchronously.
+        NodeLoader *getNodeLoader() const;
+
+        // Index of the links between notes. Use getBacklinks() to have it built.
+        const QSharedPointer<LinkIndex> &getLinkIndex() const;
+
+        // Paths of the notes linking to @p_node, relative to the root folder.
+        // The link index is built in background on first call, before which the result is incomplete.
+        QStringList getBacklinks(const Node *p_node);
+
+        // Update the link index after a node is renamed or moved within this notebook,
+        // and fix links of the referring notes in background.
+        void updateLinksOnMove(const QString &p_oldPath, const QString &p_newPath);
+
+        // @p_moves: old and new paths of the node first and then the files moved along with it.
+        void updateLinksOnMove(const QVector<QPair<QString, QString>> &p_moves);
+
         // Copy @p_src as a child of @p_dest. They may belong to different notebooks.
         virtual QSharedPointer<Node> copyNodeAsChildOf(const QSharedPointer<Node> &p_src, Node *p_dest, bool p_move);
 
+        // Like copyNodeAsChildOf() but the files of a folder are copied in @p_queue, after which
+        // the nodes are created. Copied files are removed if failed or cancelled.
+        // Return the new node if done at once. Otherwise, return null and call @p_callback later
+        // with the new node, or null if failed. @p_callback is skipped if @p_receiver is destroyed.
+        QSharedPointer<Node> copyNodeAsChildOf(const QSharedPointer<Node> &p_src,
+                                               Node *p_dest,
+                                               bool p_move,
+                                               FileOperationQueue *p_queue,
+                                               QObject *p_receiver,
+                                               const std::function<void(const QSharedPointer<Node> &)> &p_callback);
+
         // Remove @p_node and delete all related files from disk.
         // @p_force: if true, will delete all files including files not tracked by configmgr.
         // @p_configOnly: if true, will just remove node from config.
@@ -130,6 +181,10 @@ namespace vnotex
 
         void reloadNodes();
 
+        // Share the tags among nodes since most notes use the same few tags.
+        // Thread-safe since nodes may be built by background loaders.
+        QStringList internTags(const QStringList &p_tags);
+
         static const QString c_defaultAttachmentFolder;
 
         static const QString c_defaultImageFolder;
@@ -139,9 +194,38 @@ namespace vnotex
 
         void nodeUpdated(const Node *p_node);
 
+        // Emitted after a node is renamed or moved within this notebook from absolute path
+        // @p_oldPath to @p_newPath.
+        void nodePathChanged(const QString &p_oldPath, const QString &p_newPath);
+
+        // Emitted before links of note @p_filePath are rewritten on disk after a move.
+        // A handler holding the note open should apply @p_rewrite to its content, which returns
+        // null string if nothing changes, and mark @p_event handled to skip the disk rewrite.
+        void noteLinksRewriteRequested(const QString &p_filePath,
+                                       const std::function<QString(const QString &)> &p_rewrite,
+                                       const QSharedPointer<Event> &p_event);
+
     private:
         QSharedPointer<Node> getOrCreateRecycleBinDateNode();
 
+        // Get relative path of @p_path if it is within this notebook.
+        bool toRelativePath(const QString &p_path, QString &p_relativePath) const;
+
+        void buildLinkIndex();
+
+        // Called in main thread once the files of @p_src are copied to @p_destName under @p_dest.
+        QSharedPointer<Node> finishCopyNodeInQueue(const QSharedPointer<Node> &p_src,
+                                                   const QSharedPointer<Node> &p_dest,
+                                                   const QString &p_destName,
+                                                   bool p_move,
+                                                   FileOperationQueue *p_queue);
+
+        // Rewrite links of @p_notes after @p_moves.
+        void rewriteLinks(const QVector<QPair<QString, QString>> &p_moves, const QStringList &p_notes);
+
+        // Absolute paths of the local images of note @p_node, which are copied along with it.
+        static QStringList fetchImagePaths(Node *p_node);
+
         // ID of this notebook.
         // Will be assigned uniquely once loaded.
         ID m_id;
@@ -178,6 +262,28 @@ namespace vnotex
         QSharedPointer<INotebookConfigMgr> m_configMgr;
 
         QSharedPointer<Node> m_root;
+
+        // Index of loaded nodes by ID and by path.
+        QScopedPointer<NodeIndex> m_nodeIndex;
+
+        // Shared with save jobs running in background.
+        QSharedPointer<LinkIndex> m_linkIndex;
+
+        QFuture<void> m_linkIndexFuture;
+
+        // Queue of link rewrites to keep them in order.
+        // Managed by QObject.
+        FileOperationQueue *m_linkRewriteQueue = nullptr;
+
+        // Pools of interned tags, dropped on reload and with the notebook.
+        QMutex m_tagsPoolMutex;
+
+        QSet<QStringList> m_tagsPool;
+
+        QSet<QString> m_tagPool;
+
+        // Keep it last to be destroyed before the config manager it uses.
+        QScopedPointer<NodeLoader> m_nodeLoader;
     };
 } // ns vnotex
 
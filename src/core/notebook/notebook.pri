@@ -4,7 +4,10 @@ SOURCES += \
     $$PWD/bundlenotebookfactory.cpp \
     $$PWD/notebookparameters.cpp \
     $$PWD/bundlenotebook.cpp \
+    $$PWD/linkindex.cpp \
     $$PWD/node.cpp \
+    $$PWD/nodeindex.cpp \
+    $$PWD/nodeloader.cpp \
     $$PWD/vxnode.cpp \
     $$PWD/vxnodefile.cpp
 
@@ -15,6 +18,9 @@ HEADERS += \
     $$PWD/bundlenotebookfactory.h \
     $$PWD/notebookparameters.h \
     $$PWD/bundlenotebook.h \
+    $$PWD/linkindex.h \
     $$PWD/node.h \
+    $$PWD/nodeindex.h \
+    $$PWD/nodeloader.h \
     $$PWD/vxnode.h \
     $$PWD/vxnodefile.h
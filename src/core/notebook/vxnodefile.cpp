@@ -6,8 +6,10 @@
 #include <notebookconfigmgr/inotebookconfigmgr.h>
 #include <notebookconfigmgr/vxnotebookconfigmgr.h>
 #include <utils/pathutils.h>
+#include <utils/fileutils.h>
 #include "vxnode.h"
 #include "notebook.h"
+#include "linkindex.h"
 
 using namespace vnotex;
 
@@ -18,15 +20,35 @@ VXNodeFile::VXNodeFile(const QSharedPointer<VXNode> &p_node)
     setContentType(FileTypeHelper::getInst().getFileType(getContentPath()).m_type);
 }
 
-QString VXNodeFile::read() const
+QByteArray VXNodeFile::readData() const
 {
-    return m_node->getBackend()->readTextFile(m_node->fetchPath());
+    return m_node->getBackend()->readFile(m_node->fetchPath());
 }
 
-void VXNodeFile::write(const QString &p_content)
+File::WriteJob VXNodeFile::prepareWrite(const QString &p_content) const
 {
-    m_node->getBackend()->writeFile(m_node->fetchPath(), p_content);
+    auto notebook = m_node->getNotebook();
+    auto backend = notebook->getBackend();
+    const auto path = m_node->fetchPath();
+    QSharedPointer<LinkIndex> linkIndex;
+    if (getContentType().isMarkdown()) {
+        linkIndex = notebook->getLinkIndex();
+    }
+
+    return [backend, linkIndex, path, p_content]() {
+        const auto data = FileUtils::encodeText(p_content);
+        backend->writeFile(path, data);
+
+        if (linkIndex) {
+            linkIndex->updateNote(path, p_content);
+        }
+
+        return FileUtils::hashData(data);
+    };
+}
 
+void VXNodeFile::finishWrite()
+{
     m_node->setModifiedTimeUtc();
     m_node->save();
 }
@@ -15,9 +15,11 @@ namespace vnotex
     public:
         explicit VXNodeFile(const QSharedPointer<VXNode> &p_node);
 
-        QString read() const Q_DECL_OVERRIDE;
+        QByteArray readData() const Q_DECL_OVERRIDE;
 
-        void write(const QString &p_content) Q_DECL_OVERRIDE;
+        WriteJob prepareWrite(const QString &p_content) const Q_DECL_OVERRIDE;
+
+        void finishWrite() Q_DECL_OVERRIDE;
 
         QString getName() const Q_DECL_OVERRIDE;
 
@@ -1,12 +1,31 @@
 #include "inotebookbackend.h"
 
 #include <QDir>
+#include <QThreadPool>
+#include <QtConcurrent>
 
 #include <exception.h>
 #include <utils/pathutils.h>
 
 using namespace vnotex;
 
+// Disk access gains little from more threads.
+static const int c_ioThreadCount = 4;
+
+// Run @p_func in the I/O thread pool and return @p_failedResult if it throws.
+template <typename T, typename Func>
+static QFuture<T> runIO(Func p_func, const T &p_failedResult)
+{
+    return QtConcurrent::run(INotebookBackend::getIOThreadPool(), [p_func, p_failedResult]() {
+        try {
+            return p_func();
+        } catch (Exception &p_e) {
+            qWarning() << "asynchronous backend operation failed" << p_e.what();
+            return p_failedResult;
+        }
+    });
+}
+
 void INotebookBackend::constrainPath(const QString &p_path) const
 {
     if (!PathUtils::pathContains(m_rootPath, p_path)) {
@@ -21,3 +40,57 @@ QString INotebookBackend::getFullPath(const QString &p_path) const
     constrainPath(p_path);
     return QDir(m_rootPath).filePath(p_path);
 }
+
+QFuture<QByteArray> INotebookBackend::readFileAsync(const QString &p_filePath)
+{
+    return runIO<QByteArray>([this, p_filePath]() {
+        auto data = readFile(p_filePath);
+        if (data.isNull()) {
+            // Tell an empty file from failure.
+            data = QByteArray("");
+        }
+        return data;
+    }, QByteArray());
+}
+
+QFuture<bool> INotebookBackend::writeFileAsync(const QString &p_filePath, const QByteArray &p_data)
+{
+    return runIO<bool>([this, p_filePath, p_data]() {
+        writeFile(p_filePath, p_data);
+        return true;
+    }, false);
+}
+
+QFuture<bool> INotebookBackend::existsAsync(const QString &p_path) const
+{
+    return runIO<bool>([this, p_path]() {
+        return exists(p_path);
+    }, false);
+}
+
+QFuture<bool> INotebookBackend::copyFileAsync(const QString &p_filePath, const QString &p_destPath)
+{
+    return runIO<bool>([this, p_filePath, p_destPath]() {
+        copyFile(p_filePath, p_destPath);
+        return true;
+    }, false);
+}
+
+QFuture<bool> INotebookBackend::copyDirAsync(const QString &p_dirPath, const QString &p_destPath)
+{
+    return runIO<bool>([this, p_dirPath, p_destPath]() {
+        copyDir(p_dirPath, p_destPath);
+        return true;
+    }, false);
+}
+
+QThreadPool *INotebookBackend::getIOThreadPool()
+{
+    static QThreadPool *s_pool = []() {
+        // Never deleted, so that pending operations do not block the exit.
+        auto pool = new QThreadPool();
+        pool->setMaxThreadCount(c_ioThreadCount);
+        return pool;
+    }();
+    return s_pool;
+}
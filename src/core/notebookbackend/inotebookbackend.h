@@ -2,11 +2,14 @@
 #define INOTEBOOKBACKEND_H
 
 #include <QObject>
+#include <QFuture>
 
 #include <utils/pathutils.h>
 
 class QByteArray;
 class QJsonObject;
+class QDateTime;
+class QThreadPool;
 
 namespace vnotex
 {
@@ -57,6 +60,9 @@ namespace vnotex
         // Write @p_jobj to @p_filePath.
         virtual void writeFile(const QString &p_filePath, const QJsonObject &p_jobj) = 0;
 
+        // Append @p_data to @p_filePath durably. Create it if not exists.
+        virtual void appendFile(const QString &p_filePath, const QByteArray &p_data) = 0;
+
         // Read content from @p_filePath.
         virtual QString readTextFile(const QString &p_filePath) = 0;
 
@@ -75,6 +81,12 @@ namespace vnotex
 
         virtual bool isFile(const QString &p_path) const = 0;
 
+        // Return an invalid QDateTime if @p_path does not exist.
+        virtual QDateTime getModifiedTimeUtc(const QString &p_path) const = 0;
+
+        // Return -1 if @p_path does not exist.
+        virtual qint64 getFileSize(const QString &p_path) const = 0;
+
         virtual void renameFile(const QString &p_filePath, const QString &p_name) = 0;
 
         virtual void renameDir(const QString &p_dirPath, const QString &p_name) = 0;
@@ -89,6 +101,13 @@ namespace vnotex
         // Copy  @p_dirPath to as @p_destPath.
         virtual void copyDir(const QString &p_dirPath, const QString &p_destPath) = 0;
 
+        // Move @p_filePath to @p_destPath. Rename it if on the same file system.
+        virtual void moveFile(const QString &p_filePath, const QString &p_destPath) = 0;
+
+        // Move @p_dirPath to @p_destPath. Rename it if on the same file system.
+        // Source is left intact if it fails.
+        virtual void moveDir(const QString &p_dirPath, const QString &p_destPath) = 0;
+
         // Delete @p_dirPath from disk if it is empty.
         // Return false if it is not deleted due to non-empty.
         virtual bool removeDirIfEmpty(const QString &p_dirPath) = 0;
@@ -102,6 +121,26 @@ namespace vnotex
 
         virtual void removeEmptyDir(const QString &p_dirPath) = 0;
 
+        // Asynchronous variants running in the I/O thread pool.
+        // The backend must outlive the returned future. Failures are logged.
+
+        // Return a null QByteArray if failed.
+        QFuture<QByteArray> readFileAsync(const QString &p_filePath);
+
+        // Return false if failed.
+        QFuture<bool> writeFileAsync(const QString &p_filePath, const QByteArray &p_data);
+
+        QFuture<bool> existsAsync(const QString &p_path) const;
+
+        // Return false if failed.
+        QFuture<bool> copyFileAsync(const QString &p_filePath, const QString &p_destPath);
+
+        // Return false if failed.
+        QFuture<bool> copyDirAsync(const QString &p_dirPath, const QString &p_destPath);
+
+        // Threads for file access, apart from the global thread pool for computation.
+        static QThreadPool *getIOThreadPool();
+
     protected:
         // Constrain @p_path within root path of the notebook.
         void constrainPath(const QString &p_path) const;
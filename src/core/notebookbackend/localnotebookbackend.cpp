@@ -5,6 +5,7 @@
 #include <QTextStream>
 #include <QJsonObject>
 #include <QJsonDocument>
+#include <QDateTime>
 
 #include <utils/pathutils.h>
 #include "exception.h"
@@ -55,13 +56,13 @@ void LocalNotebookBackend::makePath(const QString &p_dirPath)
 void LocalNotebookBackend::writeFile(const QString &p_filePath, const QByteArray &p_data)
 {
     const auto filePath = getFullPath(p_filePath);
-    FileUtils::writeFile(filePath, p_data);
+    FileUtils::writeFileDurably(filePath, p_data);
 }
 
 void LocalNotebookBackend::writeFile(const QString &p_filePath, const QString &p_text)
 {
     const auto filePath = getFullPath(p_filePath);
-    FileUtils::writeFile(filePath, p_text);
+    FileUtils::writeFileDurably(filePath, p_text);
 }
 
 void LocalNotebookBackend::writeFile(const QString &p_filePath, const QJsonObject &p_jobj)
@@ -69,6 +70,12 @@ void LocalNotebookBackend::writeFile(const QString &p_filePath, const QJsonObjec
     writeFile(p_filePath, QJsonDocument(p_jobj).toJson());
 }
 
+void LocalNotebookBackend::appendFile(const QString &p_filePath, const QByteArray &p_data)
+{
+    const auto filePath = getFullPath(p_filePath);
+    FileUtils::appendFile(filePath, p_data);
+}
+
 QString LocalNotebookBackend::readTextFile(const QString &p_filePath)
 {
     const auto filePath = getFullPath(p_filePath);
@@ -109,6 +116,24 @@ bool LocalNotebookBackend::isFile(const QString &p_path) const
     return fi.isFile();
 }
 
+QDateTime LocalNotebookBackend::getModifiedTimeUtc(const QString &p_path) const
+{
+    QFileInfo fi(getFullPath(p_path));
+    if (!fi.exists()) {
+        return QDateTime();
+    }
+    return fi.lastModified().toUTC();
+}
+
+qint64 LocalNotebookBackend::getFileSize(const QString &p_path) const
+{
+    QFileInfo fi(getFullPath(p_path));
+    if (!fi.exists()) {
+        return -1;
+    }
+    return fi.size();
+}
+
 void LocalNotebookBackend::renameFile(const QString &p_filePath, const QString &p_name)
 {
     Q_ASSERT(isFile(p_filePath));
@@ -147,6 +172,18 @@ void LocalNotebookBackend::copyDir(const QString &p_dirPath, const QString &p_de
     FileUtils::copyDir(dirPath, getFullPath(p_destPath));
 }
 
+void LocalNotebookBackend::moveFile(const QString &p_filePath, const QString &p_destPath)
+{
+    Q_ASSERT(isFile(p_filePath));
+    FileUtils::copyFile(getFullPath(p_filePath), getFullPath(p_destPath), true);
+}
+
+void LocalNotebookBackend::moveDir(const QString &p_dirPath, const QString &p_destPath)
+{
+    Q_ASSERT(!isFile(p_dirPath));
+    FileUtils::copyDir(getFullPath(p_dirPath), getFullPath(p_destPath), true);
+}
+
 void LocalNotebookBackend::removeFile(const QString &p_filePath)
 {
     Q_ASSERT(isFile(p_filePath));
@@ -39,6 +39,8 @@ namespace vnotex
         // Write @p_jobj to @p_filePath.
         void writeFile(const QString &p_filePath, const QJsonObject &p_jobj) Q_DECL_OVERRIDE;
 
+        void appendFile(const QString &p_filePath, const QByteArray &p_data) Q_DECL_OVERRIDE;
+
         // Read content from @p_filePath.
         QString readTextFile(const QString &p_filePath) Q_DECL_OVERRIDE;
 
@@ -55,6 +57,10 @@ namespace vnotex
 
         bool isFile(const QString &p_path) const Q_DECL_OVERRIDE;
 
+        QDateTime getModifiedTimeUtc(const QString &p_path) const Q_DECL_OVERRIDE;
+
+        qint64 getFileSize(const QString &p_path) const Q_DECL_OVERRIDE;
+
         void renameFile(const QString &p_filePath, const QString &p_name) Q_DECL_OVERRIDE;
 
         void renameDir(const QString &p_dirPath, const QString &p_name) Q_DECL_OVERRIDE;
@@ -74,6 +80,10 @@ namespace vnotex
         // Copy @p_dirPath to as @p_destPath.
         void copyDir(const QString &p_dirPath, const QString &p_destPath) Q_DECL_OVERRIDE;
 
+        void moveFile(const QString &p_filePath, const QString &p_destPath) Q_DECL_OVERRIDE;
+
+        void moveDir(const QString &p_dirPath, const QString &p_destPath) Q_DECL_OVERRIDE;
+
         QString renameIfExistsCaseInsensitive(const QString &p_path) const Q_DECL_OVERRIDE;
 
         void addFile(const QString &p_path) Q_DECL_OVERRIDE;
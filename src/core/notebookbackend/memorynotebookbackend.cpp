@@ -0,0 +1,498 @@
+#include "memorynotebookbackend.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QMutexLocker>
+
+#include <utils/pathutils.h>
+#include <utils/fileutils.h>
+#include "exception.h"
+
+using namespace vnotex;
+
+MemoryNotebookBackend::MemoryNotebookBackend(const QString &p_name,
+                                             const QString &p_displayName,
+                                             const QString &p_description,
+                                             const QString &p_rootPath,
+                                             QObject *p_parent)
+    : INotebookBackend(p_rootPath, p_parent),
+      m_info(p_name, p_displayName, p_description)
+{
+    Entry root;
+    root.m_isDir = true;
+    root.m_modifiedTimeUtc = QDateTime::currentDateTimeUtc();
+    m_entries.insert(PathUtils::cleanPath(getRootPath()), root);
+}
+
+QString MemoryNotebookBackend::getName() const
+{
+    return m_info.m_name;
+}
+
+QString MemoryNotebookBackend::getDisplayName() const
+{
+    return m_info.m_displayName;
+}
+
+QString MemoryNotebookBackend::getDescription() const
+{
+    return m_info.m_description;
+}
+
+QString MemoryNotebookBackend::fullPath(const QString &p_path) const
+{
+    return PathUtils::cleanPath(getFullPath(p_path));
+}
+
+const MemoryNotebookBackend::Entry *MemoryNotebookBackend::findEntry(const QString &p_path) const
+{
+    auto it = m_entries.constFind(p_path);
+    return it == m_entries.constEnd() ? nullptr : &it.value();
+}
+
+bool MemoryNotebookBackend::isDirEntry(const QString &p_path) const
+{
+    auto entry = findEntry(p_path);
+    return entry && entry->m_isDir;
+}
+
+bool MemoryNotebookBackend::hasChildren(const QString &p_dirPath) const
+{
+    const auto prefix = p_dirPath + QLatin1Char('/');
+    auto it = m_entries.lowerBound(prefix);
+    return it != m_entries.constEnd() && it.key().startsWith(prefix);
+}
+
+bool MemoryNotebookBackend::childExistsCaseInsensitiveInternal(const QString &p_dirPath, const QString &p_name) const
+{
+    const auto prefix = p_dirPath + QLatin1Char('/');
+    for (auto it = m_entries.lowerBound(prefix); it != m_entries.constEnd() && it.key().startsWith(prefix); ++it) {
+        const auto name = it.key().mid(prefix.size());
+        if (!name.contains(QLatin1Char('/')) && name.compare(p_name, Qt::CaseInsensitive) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void MemoryNotebookBackend::makePathInternal(const QString &p_dirPath)
+{
+    auto entry = findEntry(p_dirPath);
+    if (entry) {
+        if (!entry->m_isDir) {
+            Exception::throwOne(Exception::Type::FailToCreateDir,
+                                QString("fail to create directory: %1").arg(p_dirPath));
+        }
+        return;
+    }
+
+    makePathInternal(PathUtils::parentDirPath(p_dirPath));
+
+    Entry dir;
+    dir.m_isDir = true;
+    addEntry(p_dirPath, dir);
+}
+
+void MemoryNotebookBackend::addEntry(const QString &p_path, const Entry &p_entry)
+{
+    if (!isDirEntry(PathUtils::parentDirPath(p_path))) {
+        Exception::throwOne(Exception::Type::FailToWriteFile,
+                            QString("parent directory does not exist: %1").arg(p_path));
+    }
+
+    auto &entry = m_entries[p_path];
+    entry = p_entry;
+    entry.m_modifiedTimeUtc = QDateTime::currentDateTimeUtc();
+    touchParent(p_path);
+}
+
+void MemoryNotebookBackend::removeEntries(const QString &p_path)
+{
+    const auto prefix = p_path + QLatin1Char('/');
+    auto it = m_entries.lowerBound(prefix);
+    while (it != m_entries.end() && it.key().startsWith(prefix)) {
+        it = m_entries.erase(it);
+    }
+
+    m_entries.remove(p_path);
+    touchParent(p_path);
+}
+
+void MemoryNotebookBackend::moveEntries(const QString &p_path, const QString &p_destPath)
+{
+    Q_ASSERT(!PathUtils::pathContains(p_path, p_destPath));
+    QVector<QPair<QString, Entry>> moved;
+    moved.push_back(qMakePair(p_destPath, m_entries.value(p_path)));
+
+    const auto prefix = p_path + QLatin1Char('/');
+    for (auto it = m_entries.lowerBound(prefix); it != m_entries.end() && it.key().startsWith(prefix); ++it) {
+        moved.push_back(qMakePair(p_destPath + it.key().mid(p_path.size()), it.value()));
+    }
+
+    makePathInternal(PathUtils::parentDirPath(p_destPath));
+    removeEntries(p_path);
+
+    for (const auto &ent : moved) {
+        m_entries.insert(ent.first, ent.second);
+    }
+    touchParent(p_destPath);
+}
+
+void MemoryNotebookBackend::touchParent(const QString &p_path)
+{
+    auto it = m_entries.find(PathUtils::parentDirPath(p_path));
+    if (it != m_entries.end()) {
+        it->m_modifiedTimeUtc = QDateTime::currentDateTimeUtc();
+    }
+}
+
+void MemoryNotebookBackend::importFromDisk(const QString &p_path, const QString &p_destPath)
+{
+    QFileInfo fi(p_path);
+    if (fi.isFile()) {
+        Entry file;
+        file.m_data = FileUtils::readFile(p_path);
+        addEntry(p_destPath, file);
+        return;
+    }
+
+    makePathInternal(p_destPath);
+
+    QDir srcDir(p_path);
+    QDirIterator it(p_path,
+                    QDir::Dirs | QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const auto path = it.next();
+        const auto destPath = PathUtils::concatenateFilePath(p_destPath, srcDir.relativeFilePath(path));
+        if (it.fileInfo().isDir()) {
+            makePathInternal(destPath);
+        } else {
+            Entry file;
+            file.m_data = FileUtils::readFile(path);
+            makePathInternal(PathUtils::parentDirPath(destPath));
+            addEntry(destPath, file);
+        }
+    }
+}
+
+bool MemoryNotebookBackend::isEmptyDir(const QString &p_dirPath) const
+{
+    QMutexLocker locker(&m_mutex);
+    const auto dirPath = fullPath(p_dirPath);
+    auto entry = findEntry(dirPath);
+    if (!entry) {
+        return true;
+    }
+
+    return entry->m_isDir && !hasChildren(dirPath);
+}
+
+void MemoryNotebookBackend::makePath(const QString &p_dirPath)
+{
+    QMutexLocker locker(&m_mutex);
+    makePathInternal(fullPath(p_dirPath));
+}
+
+void MemoryNotebookBackend::writeFile(const QString &p_filePath, const QByteArray &p_data)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto filePath = fullPath(p_filePath);
+    if (isDirEntry(filePath)) {
+        Exception::throwOne(Exception::Type::FailToWriteFile,
+                            QString("failed to write to directory: %1").arg(filePath));
+    }
+
+    Entry file;
+    file.m_data = p_data;
+    addEntry(filePath, file);
+}
+
+void MemoryNotebookBackend::writeFile(const QString &p_filePath, const QString &p_text)
+{
+    writeFile(p_filePath, p_text.toUtf8());
+}
+
+void MemoryNotebookBackend::writeFile(const QString &p_filePath, const QJsonObject &p_jobj)
+{
+    writeFile(p_filePath, QJsonDocument(p_jobj).toJson());
+}
+
+void MemoryNotebookBackend::appendFile(const QString &p_filePath, const QByteArray &p_data)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto filePath = fullPath(p_filePath);
+    auto entry = findEntry(filePath);
+    if (entry && entry->m_isDir) {
+        Exception::throwOne(Exception::Type::FailToWriteFile,
+                            QString("failed to append to directory: %1").arg(filePath));
+    }
+
+    Entry file;
+    if (entry) {
+        file.m_data = entry->m_data;
+    }
+    file.m_data.append(p_data);
+    addEntry(filePath, file);
+}
+
+QString MemoryNotebookBackend::readTextFile(const QString &p_filePath)
+{
+    return QString::fromUtf8(readFile(p_filePath));
+}
+
+QByteArray MemoryNotebookBackend::readFile(const QString &p_filePath)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto filePath = fullPath(p_filePath);
+    auto entry = findEntry(filePath);
+    if (!entry || entry->m_isDir) {
+        Exception::throwOne(Exception::Type::FailToReadFile,
+                            QString("failed to read file: %1").arg(filePath));
+    }
+
+    return entry->m_data;
+}
+
+bool MemoryNotebookBackend::exists(const QString &p_path) const
+{
+    QMutexLocker locker(&m_mutex);
+    return findEntry(fullPath(p_path));
+}
+
+bool MemoryNotebookBackend::existsFile(const QString &p_path) const
+{
+    return isFile(p_path);
+}
+
+bool MemoryNotebookBackend::existsDir(const QString &p_path) const
+{
+    QMutexLocker locker(&m_mutex);
+    return isDirEntry(fullPath(p_path));
+}
+
+bool MemoryNotebookBackend::childExistsCaseInsensitive(const QString &p_dirPath, const QString &p_name) const
+{
+    QMutexLocker locker(&m_mutex);
+    return childExistsCaseInsensitiveInternal(fullPath(p_dirPath), p_name);
+}
+
+bool MemoryNotebookBackend::isFile(const QString &p_path) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto entry = findEntry(fullPath(p_path));
+    return entry && !entry->m_isDir;
+}
+
+QDateTime MemoryNotebookBackend::getModifiedTimeUtc(const QString &p_path) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto entry = findEntry(fullPath(p_path));
+    return entry ? entry->m_modifiedTimeUtc : QDateTime();
+}
+
+qint64 MemoryNotebookBackend::getFileSize(const QString &p_path) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto entry = findEntry(fullPath(p_path));
+    return entry ? entry->m_data.size() : -1;
+}
+
+void MemoryNotebookBackend::renameFile(const QString &p_filePath, const QString &p_name)
+{
+    Q_ASSERT(PathUtils::isLegalFileName(p_name));
+    QMutexLocker locker(&m_mutex);
+    const auto filePath = fullPath(p_filePath);
+    const auto newFilePath = PathUtils::concatenateFilePath(PathUtils::parentDirPath(filePath), p_name);
+    if (!findEntry(filePath) || findEntry(newFilePath)) {
+        Exception::throwOne(Exception::Type::FailToRenameFile,
+                            QString("failed to rename file: %1").arg(filePath));
+    }
+
+    moveEntries(filePath, newFilePath);
+}
+
+void MemoryNotebookBackend::renameDir(const QString &p_dirPath, const QString &p_name)
+{
+    renameFile(p_dirPath, p_name);
+}
+
+void MemoryNotebookBackend::removeFile(const QString &p_filePath)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto filePath = fullPath(p_filePath);
+    auto entry = findEntry(filePath);
+    if (!entry || entry->m_isDir) {
+        Exception::throwOne(Exception::Type::FailToRemoveFile,
+                            QString("failed to remove file: %1").arg(filePath));
+    }
+
+    removeEntries(filePath);
+}
+
+bool MemoryNotebookBackend::removeDirIfEmpty(const QString &p_dirPath)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto dirPath = fullPath(p_dirPath);
+    if (hasChildren(dirPath)) {
+        return false;
+    }
+
+    if (!isDirEntry(dirPath)) {
+        Exception::throwOne(Exception::Type::FailToRemoveFile,
+                            QString("failed to remove directory: %1").arg(dirPath));
+    }
+
+    removeEntries(dirPath);
+    return true;
+}
+
+void MemoryNotebookBackend::removeDir(const QString &p_dirPath)
+{
+    QMutexLocker locker(&m_mutex);
+    removeEntries(fullPath(p_dirPath));
+}
+
+void MemoryNotebookBackend::copyFile(const QString &p_filePath, const QString &p_destPath)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto destPath = fullPath(p_destPath);
+    if (findEntry(destPath)) {
+        Exception::throwOne(Exception::Type::FailToCopyFile,
+                            QString("failed to copy file: %1 %2").arg(p_filePath, destPath));
+    }
+
+    makePathInternal(PathUtils::parentDirPath(destPath));
+
+    if (!PathUtils::pathContains(getRootPath(), p_filePath)) {
+        importFromDisk(p_filePath, destPath);
+        return;
+    }
+
+    auto entry = findEntry(fullPath(p_filePath));
+    if (!entry || entry->m_isDir) {
+        Exception::throwOne(Exception::Type::FailToCopyFile,
+                            QString("failed to copy file: %1 %2").arg(p_filePath, destPath));
+    }
+
+    const auto file = *entry;
+    addEntry(destPath, file);
+}
+
+void MemoryNotebookBackend::copyDir(const QString &p_dirPath, const QString &p_destPath)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto destPath = fullPath(p_destPath);
+    if (findEntry(destPath)) {
+        Exception::throwOne(Exception::Type::FailToCopyDir,
+                            QString("target directory %1 already exists").arg(destPath));
+    }
+
+    if (!PathUtils::pathContains(getRootPath(), p_dirPath)) {
+        importFromDisk(p_dirPath, destPath);
+        return;
+    }
+
+    const auto dirPath = fullPath(p_dirPath);
+    if (!isDirEntry(dirPath) || PathUtils::pathContains(dirPath, destPath)) {
+        Exception::throwOne(Exception::Type::FailToCopyDir,
+                            QString("failed to copy directory: %1 %2").arg(dirPath, destPath));
+    }
+
+    QVector<QPair<QString, Entry>> copied;
+    const auto prefix = dirPath + QLatin1Char('/');
+    for (auto it = m_entries.lowerBound(prefix); it != m_entries.end() && it.key().startsWith(prefix); ++it) {
+        copied.push_back(qMakePair(destPath + it.key().mid(dirPath.size()), it.value()));
+    }
+
+    makePathInternal(destPath);
+    for (const auto &ent : copied) {
+        addEntry(ent.first, ent.second);
+    }
+}
+
+void MemoryNotebookBackend::moveFile(const QString &p_filePath, const QString &p_destPath)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto filePath = fullPath(p_filePath);
+    const auto destPath = fullPath(p_destPath);
+    auto entry = findEntry(filePath);
+    if (!entry || entry->m_isDir || findEntry(destPath)) {
+        Exception::throwOne(Exception::Type::FailToCopyFile,
+                            QString("failed to move file: %1 %2").arg(filePath, destPath));
+    }
+
+    moveEntries(filePath, destPath);
+}
+
+void MemoryNotebookBackend::moveDir(const QString &p_dirPath, const QString &p_destPath)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto dirPath = fullPath(p_dirPath);
+    const auto destPath = fullPath(p_destPath);
+    if (!isDirEntry(dirPath) || findEntry(destPath) || PathUtils::pathContains(dirPath, destPath)) {
+        Exception::throwOne(Exception::Type::FailToCopyDir,
+                            QString("failed to move directory: %1 %2").arg(dirPath, destPath));
+    }
+
+    moveEntries(dirPath, destPath);
+}
+
+QString MemoryNotebookBackend::renameIfExistsCaseInsensitive(const QString &p_path) const
+{
+    QMutexLocker locker(&m_mutex);
+    QFileInfo fi(fullPath(p_path));
+    const auto dirPath = PathUtils::cleanPath(fi.absolutePath());
+    const auto baseName = fi.completeBaseName();
+    const auto suffix = fi.suffix();
+    auto name = fi.fileName();
+    int idx = 1;
+    while (childExistsCaseInsensitiveInternal(dirPath, name)) {
+        name = QString("%1_%2").arg(baseName, QString::number(idx));
+        if (!suffix.isEmpty()) {
+            name += QStringLiteral(".") + suffix;
+        }
+
+        ++idx;
+    }
+
+    return PathUtils::concatenateFilePath(dirPath, name);
+}
+
+void MemoryNotebookBackend::addFile(const QString &p_path)
+{
+    Q_UNUSED(p_path);
+}
+
+void MemoryNotebookBackend::removeEmptyDir(const QString &p_dirPath)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto prefix = fullPath(p_dirPath) + QLatin1Char('/');
+    QStringList dirs;
+    for (auto it = m_entries.lowerBound(prefix); it != m_entries.end() && it.key().startsWith(prefix); ++it) {
+        if (it->m_isDir) {
+            dirs << it.key();
+        }
+    }
+
+    // Deepest first.
+    for (int i = dirs.size() - 1; i >= 0; --i) {
+        if (!hasChildren(dirs[i])) {
+            removeEntries(dirs[i]);
+        }
+    }
+}
+
+qint64 MemoryNotebookBackend::getDataSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    qint64 size = 0;
+    for (const auto &entry : m_entries) {
+        size += entry.m_data.size();
+    }
+    return size;
+}
@@ -0,0 +1,139 @@
+#ifndef MEMORYNOTEBOOKBACKEND_H
+#define MEMORYNOTEBOOKBACKEND_H
+
+#include "inotebookbackend.h"
+
+#include <QMap>
+#include <QMutex>
+#include <QDateTime>
+
+#include "../global.h"
+
+namespace vnotex
+{
+    // Backend keeping all files in memory, which is used to test and benchmark
+    // notebooks without the noise of disk access.
+    // Files outside root folder could be copied in from disk.
+    // Thread-safe so that asynchronous operations could run on it.
+    class MemoryNotebookBackend : public INotebookBackend
+    {
+        Q_OBJECT
+    public:
+        explicit MemoryNotebookBackend(const QString &p_name,
+                                       const QString &p_displayName,
+                                       const QString &p_description,
+                                       const QString &p_rootPath,
+                                       QObject *p_parent = nullptr);
+
+        QString getName() const Q_DECL_OVERRIDE;
+
+        QString getDisplayName() const Q_DECL_OVERRIDE;
+
+        QString getDescription() const Q_DECL_OVERRIDE;
+
+        bool isEmptyDir(const QString &p_dirPath) const Q_DECL_OVERRIDE;
+
+        void makePath(const QString &p_dirPath) Q_DECL_OVERRIDE;
+
+        void writeFile(const QString &p_filePath, const QByteArray &p_data) Q_DECL_OVERRIDE;
+
+        void writeFile(const QString &p_filePath, const QString &p_text) Q_DECL_OVERRIDE;
+
+        void writeFile(const QString &p_filePath, const QJsonObject &p_jobj) Q_DECL_OVERRIDE;
+
+        void appendFile(const QString &p_filePath, const QByteArray &p_data) Q_DECL_OVERRIDE;
+
+        QString readTextFile(const QString &p_filePath) Q_DECL_OVERRIDE;
+
+        QByteArray readFile(const QString &p_filePath) Q_DECL_OVERRIDE;
+
+        bool exists(const QString &p_path) const Q_DECL_OVERRIDE;
+
+        bool existsFile(const QString &p_path) const Q_DECL_OVERRIDE;
+
+        bool existsDir(const QString &p_path) const Q_DECL_OVERRIDE;
+
+        bool childExistsCaseInsensitive(const QString &p_dirPath, const QString &p_name) const Q_DECL_OVERRIDE;
+
+        bool isFile(const QString &p_path) const Q_DECL_OVERRIDE;
+
+        QDateTime getModifiedTimeUtc(const QString &p_path) const Q_DECL_OVERRIDE;
+
+        qint64 getFileSize(const QString &p_path) const Q_DECL_OVERRIDE;
+
+        void renameFile(const QString &p_filePath, const QString &p_name) Q_DECL_OVERRIDE;
+
+        void renameDir(const QString &p_dirPath, const QString &p_name) Q_DECL_OVERRIDE;
+
+        void removeFile(const QString &p_filePath) Q_DECL_OVERRIDE;
+
+        bool removeDirIfEmpty(const QString &p_dirPath) Q_DECL_OVERRIDE;
+
+        void removeDir(const QString &p_dirPath) Q_DECL_OVERRIDE;
+
+        void copyFile(const QString &p_filePath, const QString &p_destPath) Q_DECL_OVERRIDE;
+
+        void copyDir(const QString &p_dirPath, const QString &p_destPath) Q_DECL_OVERRIDE;
+
+        void moveFile(const QString &p_filePath, const QString &p_destPath) Q_DECL_OVERRIDE;
+
+        void moveDir(const QString &p_dirPath, const QString &p_destPath) Q_DECL_OVERRIDE;
+
+        QString renameIfExistsCaseInsensitive(const QString &p_path) const Q_DECL_OVERRIDE;
+
+        void addFile(const QString &p_path) Q_DECL_OVERRIDE;
+
+        void removeEmptyDir(const QString &p_dirPath) Q_DECL_OVERRIDE;
+
+        // Total size of the files in bytes.
+        qint64 getDataSize() const;
+
+    private:
+        struct Entry
+        {
+            bool m_isDir = false;
+
+            QByteArray m_data;
+
+            QDateTime m_modifiedTimeUtc;
+        };
+
+        // Functions below do not lock and take clean absolute paths.
+
+        QString fullPath(const QString &p_path) const;
+
+        const Entry *findEntry(const QString &p_path) const;
+
+        bool isDirEntry(const QString &p_path) const;
+
+        bool hasChildren(const QString &p_dirPath) const;
+
+        bool childExistsCaseInsensitiveInternal(const QString &p_dirPath, const QString &p_name) const;
+
+        void makePathInternal(const QString &p_dirPath);
+
+        // Parent folder must exist.
+        void addEntry(const QString &p_path, const Entry &p_entry);
+
+        // Remove @p_path and all its descendants.
+        void removeEntries(const QString &p_path);
+
+        // Move @p_path and all its descendants to @p_destPath.
+        void moveEntries(const QString &p_path, const QString &p_destPath);
+
+        // Update modified time of the parent folder of @p_path.
+        void touchParent(const QString &p_path);
+
+        // Read a file or folder outside root folder from disk as @p_destPath.
+        void importFromDisk(const QString &p_path, const QString &p_destPath);
+
+        Info m_info;
+
+        // Sorted so that descendants of a folder are next to each other.
+        QMap<QString, Entry> m_entries;
+
+        mutable QMutex m_mutex;
+    };
+} // ns vnotex
+
+#endif // MEMORYNOTEBOOKBACKEND_H
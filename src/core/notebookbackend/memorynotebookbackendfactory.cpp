@@ -0,0 +1,34 @@
+#include "memorynotebookbackendfactory.h"
+
+#include <QObject>
+
+#include "memorynotebookbackend.h"
+
+using namespace vnotex;
+
+MemoryNotebookBackendFactory::MemoryNotebookBackendFactory()
+{
+}
+
+QString MemoryNotebookBackendFactory::getName() const
+{
+    return QStringLiteral("memory.vnotex");
+}
+
+QString MemoryNotebookBackendFactory::getDisplayName() const
+{
+    return QObject::tr("Memory Notebook Backend");
+}
+
+QString MemoryNotebookBackendFactory::getDescription() const
+{
+    return QObject::tr("In-memory files for tests and benchmarks");
+}
+
+QSharedPointer<INotebookBackend> MemoryNotebookBackendFactory::createNotebookBackend(const QString &p_rootPath)
+{
+    return QSharedPointer<MemoryNotebookBackend>::create(getName(),
+                                                         getDisplayName(),
+                                                         getDescription(),
+                                                         p_rootPath);
+}
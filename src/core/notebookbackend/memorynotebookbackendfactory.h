@@ -0,0 +1,25 @@
+#ifndef MEMORYNOTEBOOKBACKENDFACTORY_H
+#define MEMORYNOTEBOOKBACKENDFACTORY_H
+
+#include "inotebookbackendfactory.h"
+
+
+namespace vnotex
+{
+    // Not registered for users since the files will be lost.
+    class MemoryNotebookBackendFactory : public INotebookBackendFactory
+    {
+    public:
+        MemoryNotebookBackendFactory();
+
+        QString getName() const Q_DECL_OVERRIDE;
+
+        QString getDisplayName() const Q_DECL_OVERRIDE;
+
+        QString getDescription() const Q_DECL_OVERRIDE;
+
+        QSharedPointer<INotebookBackend> createNotebookBackend(const QString &p_rootPath) Q_DECL_OVERRIDE;
+    };
+} // ns vnotex
+
+#endif // MEMORYNOTEBOOKBACKENDFACTORY_H
@@ -1,10 +1,14 @@
 SOURCES += \
     $$PWD/localnotebookbackend.cpp \
     $$PWD/localnotebookbackendfactory.cpp \
+    $$PWD/memorynotebookbackend.cpp \
+    $$PWD/memorynotebookbackendfactory.cpp \
     $$PWD/inotebookbackend.cpp
 
 HEADERS += \
     $$PWD/inotebookbackend.h \
     $$PWD/localnotebookbackend.h \
     $$PWD/inotebookbackendfactory.h \
-    $$PWD/localnotebookbackendfactory.h
+    $$PWD/localnotebookbackendfactory.h \
+    $$PWD/memorynotebookbackend.h \
+    $$PWD/memorynotebookbackendfactory.h
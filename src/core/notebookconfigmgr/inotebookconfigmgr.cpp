@@ -4,6 +4,10 @@
 
 using namespace vnotex;
 
+NodeLoadData::~NodeLoadData()
+{
+}
+
 INotebookConfigMgr::INotebookConfigMgr(const QSharedPointer<INotebookBackend> &p_backend,
                                        QObject *p_parent)
     : QObject(p_parent),
@@ -35,3 +39,15 @@ void INotebookConfigMgr::setNotebook(Notebook *p_notebook)
 {
     m_notebook = p_notebook;
 }
+
+QSharedPointer<NodeLoadData> INotebookConfigMgr::readNodeLoadData(const QString &p_path) const
+{
+    Q_UNUSED(p_path);
+    return nullptr;
+}
+
+void INotebookConfigMgr::applyNodeLoadData(Node *p_node, const QSharedPointer<NodeLoadData> &p_data) const
+{
+    Q_UNUSED(p_data);
+    loadNode(p_node);
+}
@@ -14,6 +14,13 @@ namespace vnotex
     class Notebook;
     struct NodeParameters;
 
+    // Data of a node read in a worker thread to load the node asynchronously.
+    class NodeLoadData
+    {
+    public:
+        virtual ~NodeLoadData();
+    };
+
     // Abstract class for notebook config manager, which is responsible for config
     // files access and note nodes access.
     class INotebookConfigMgr : public QObject
@@ -41,6 +48,14 @@ namespace vnotex
         virtual void loadNode(Node *p_node) const = 0;
         virtual void saveNode(const Node *p_node) = 0;
 
+        // Read data to load container node at @p_path in a worker thread.
+        // Must not touch the node tree or any state of the main thread.
+        // Return null if asynchronous loading is not supported.
+        virtual QSharedPointer<NodeLoadData> readNodeLoadData(const QString &p_path) const;
+
+        // Load @p_node with data from readNodeLoadData() in the main thread.
+        virtual void applyNodeLoadData(Node *p_node, const QSharedPointer<NodeLoadData> &p_data) const;
+
         virtual void renameNode(Node *p_node, const QString &p_name) = 0;
 
         virtual QSharedPointer<Node> newNode(Node *p_parent,
@@ -67,6 +82,13 @@ namespace vnotex
                                                        Node *p_dest,
                                                        bool p_move) = 0;
 
+        // Create nodes mirroring @p_src as child @p_name of @p_dest, whose files have been copied already.
+        // @p_keepIds: whether to keep the IDs, used when @p_src is moved within this notebook.
+        virtual QSharedPointer<Node> copyNodeConfigsAsChildOf(const QSharedPointer<Node> &p_src,
+                                                              Node *p_dest,
+                                                              const QString &p_name,
+                                                              bool p_keepIds) = 0;
+
         virtual void removeNode(const QSharedPointer<Node> &p_node, bool p_force, bool p_configOnly) = 0;
 
         // Whether @p_name is a built-in file under @p_node.
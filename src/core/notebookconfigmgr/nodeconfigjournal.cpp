@@ -0,0 +1,192 @@
+#include "nodeconfigjournal.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QDebug>
+
+using namespace vnotex;
+
+static const QString c_configKey = QStringLiteral("config");
+
+static const QString c_opKey = QStringLiteral("op");
+
+static const QString c_sectionKey = QStringLiteral("section");
+
+static const QString c_nameKey = QStringLiteral("name");
+
+static const QString c_newNameKey = QStringLiteral("new_name");
+
+static const QString c_fieldsKey = QStringLiteral("fields");
+
+static const QString c_updateOp = QStringLiteral("update");
+
+static const QString c_renameOp = QStringLiteral("rename");
+
+static const QString c_resetOp = QStringLiteral("reset");
+
+void NodeConfigJournal::fromData(const QByteArray &p_data)
+{
+    clear();
+
+    const auto lines = p_data.split('\n');
+    for (const auto &line : lines) {
+        if (line.trimmed().isEmpty()) {
+            continue;
+        }
+
+        QJsonParseError err;
+        const auto doc = QJsonDocument::fromJson(line, &err);
+        if (err.error != QJsonParseError::NoError || !doc.isObject()) {
+            qWarning() << "skipped broken node config journal entry" << err.errorString();
+            continue;
+        }
+
+        addEntry(doc.object());
+    }
+}
+
+QByteArray NodeConfigJournal::addEntry(const QJsonObject &p_entry)
+{
+    const auto configPath = p_entry.value(c_configKey).toString();
+    auto &entries = m_entries[configPath];
+    if (p_entry.value(c_opKey).toString() == c_resetOp) {
+        m_size -= entries.size();
+        entries.clear();
+        m_entries.remove(configPath);
+    } else {
+        entries.push_back(p_entry);
+        ++m_size;
+    }
+
+    return QJsonDocument(p_entry).toJson(QJsonDocument::Compact) + '\n';
+}
+
+bool NodeConfigJournal::isEmpty() const
+{
+    return m_size == 0;
+}
+
+int NodeConfigJournal::size() const
+{
+    return m_size;
+}
+
+bool NodeConfigJournal::hasEntries(const QString &p_configPath) const
+{
+    return m_entries.contains(p_configPath);
+}
+
+QStringList NodeConfigJournal::getConfigPaths() const
+{
+    return m_entries.keys();
+}
+
+QVector<QJsonObject> NodeConfigJournal::getEntries(const QString &p_configPath) const
+{
+    return m_entries.value(p_configPath);
+}
+
+QVector<QJsonObject> NodeConfigJournal::takeEntries(const QString &p_configPath)
+{
+    auto entries = m_entries.take(p_configPath);
+    m_size -= entries.size();
+    return entries;
+}
+
+void NodeConfigJournal::restoreEntries(const QString &p_configPath, const QVector<QJsonObject> &p_entries)
+{
+    if (p_entries.isEmpty()) {
+        return;
+    }
+
+    auto &entries = m_entries[p_configPath];
+    entries = p_entries + entries;
+    m_size += p_entries.size();
+}
+
+QByteArray NodeConfigJournal::toData() const
+{
+    QByteArray data;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        for (const auto &entry : it.value()) {
+            data += QJsonDocument(entry).toJson(QJsonDocument::Compact) + '\n';
+        }
+    }
+    return data;
+}
+
+void NodeConfigJournal::clear()
+{
+    m_entries.clear();
+    m_size = 0;
+}
+
+QJsonObject NodeConfigJournal::updateChildEntry(const QString &p_configPath,
+                                                const QString &p_section,
+                                                const QString &p_name,
+                                                const QJsonObject &p_fields)
+{
+    QJsonObject entry;
+    entry[c_configKey] = p_configPath;
+    entry[c_opKey] = c_updateOp;
+    entry[c_sectionKey] = p_section;
+    entry[c_nameKey] = p_name;
+    entry[c_fieldsKey] = p_fields;
+    return entry;
+}
+
+QJsonObject NodeConfigJournal::renameChildEntry(const QString &p_configPath,
+                                                const QString &p_section,
+                                                const QString &p_name,
+                                                const QString &p_newName)
+{
+    QJsonObject entry;
+    entry[c_configKey] = p_configPath;
+    entry[c_opKey] = c_renameOp;
+    entry[c_sectionKey] = p_section;
+    entry[c_nameKey] = p_name;
+    entry[c_newNameKey] = p_newName;
+    return entry;
+}
+
+QJsonObject NodeConfigJournal::resetEntry(const QString &p_configPath)
+{
+    QJsonObject entry;
+    entry[c_configKey] = p_configPath;
+    entry[c_opKey] = c_resetOp;
+    return entry;
+}
+
+void NodeConfigJournal::apply(QJsonObject &p_config, const QJsonObject &p_entry)
+{
+    const auto op = p_entry.value(c_opKey).toString();
+    const auto section = p_entry.value(c_sectionKey).toString();
+    const auto name = p_entry.value(c_nameKey).toString();
+
+    auto children = p_config.value(section).toArray();
+    for (int i = 0; i < children.size(); ++i) {
+        auto child = children[i].toObject();
+        if (child.value(c_nameKey).toString() != name) {
+            continue;
+        }
+
+        if (op == c_updateOp) {
+            const auto fields = p_entry.value(c_fieldsKey).toObject();
+            for (auto it = fields.constBegin(); it != fields.constEnd(); ++it) {
+                child[it.key()] = it.value();
+            }
+        } else if (op == c_renameOp) {
+            child[c_nameKey] = p_entry.value(c_newNameKey).toString();
+        } else {
+            qWarning() << "unknown node config journal op" << op;
+            return;
+        }
+
+        children[i] = child;
+        p_config[section] = children;
+        return;
+    }
+
+    // The child may have been removed by a later rewrite which is lost in a crash.
+    qWarning() << "node config journal entry without target" << section << name;
+}
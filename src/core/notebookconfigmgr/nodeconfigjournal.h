@@ -0,0 +1,77 @@
+#ifndef NODECONFIGJOURNAL_H
+#define NODECONFIGJOURNAL_H
+
+#include <QHash>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+
+namespace vnotex
+{
+    // Append-only journal of small changes to the node configs of a notebook.
+    // Each entry is one line of compact JSON targeting one config file, so that a
+    // metadata update costs one append instead of rewriting the whole config.
+    // Entries are folded into the config files later, and replayed on open if the
+    // application exits before that.
+    class NodeConfigJournal
+    {
+    public:
+        NodeConfigJournal() = default;
+
+        // Parse entries from journal file data. Broken entries, such as a torn last
+        // line after a crash, are skipped.
+        void fromData(const QByteArray &p_data);
+
+        // Add @p_entry and return its serialized line to append to the journal file.
+        QByteArray addEntry(const QJsonObject &p_entry);
+
+        bool isEmpty() const;
+
+        int size() const;
+
+        bool hasEntries(const QString &p_configPath) const;
+
+        // Paths of config files with pending entries.
+        QStringList getConfigPaths() const;
+
+        QVector<QJsonObject> getEntries(const QString &p_configPath) const;
+
+        // Take pending entries of config file @p_configPath in order.
+        QVector<QJsonObject> takeEntries(const QString &p_configPath);
+
+        // Put back entries taken by takeEntries() before the pending ones of @p_configPath.
+        void restoreEntries(const QString &p_configPath, const QVector<QJsonObject> &p_entries);
+
+        // Serialize all the pending entries as journal file data.
+        QByteArray toData() const;
+
+        void clear();
+
+        // @p_configPath: path of the config file.
+        // @p_section: files or folders array of the config.
+        // @p_fields: new fields of the child entry named @p_name.
+        static QJsonObject updateChildEntry(const QString &p_configPath,
+                                           const QString &p_section,
+                                           const QString &p_name,
+                                           const QJsonObject &p_fields);
+
+        static QJsonObject renameChildEntry(const QString &p_configPath,
+                                           const QString &p_section,
+                                           const QString &p_name,
+                                           const QString &p_newName);
+
+        // Discard all the entries of @p_configPath before it since the config is rewritten.
+        static QJsonObject resetEntry(const QString &p_configPath);
+
+        // Apply @p_entry on config @p_config.
+        static void apply(QJsonObject &p_config, const QJsonObject &p_entry);
+
+    private:
+        QHash<QString, QVector<QJsonObject>> m_entries;
+
+        int m_size = 0;
+    };
+} // ns vnotex
+
+#endif // NODECONFIGJOURNAL_H
@@ -0,0 +1,123 @@
+#include "nodeconfigsnapshot.h"
+
+#include <QCborMap>
+#include <QCborArray>
+#include <QDateTime>
+#include <QDebug>
+
+#include <utils/pathutils.h>
+
+using namespace vnotex;
+
+const int NodeConfigSnapshot::c_version = 2;
+
+bool NodeConfigSnapshot::fromCbor(const QByteArray &p_data)
+{
+    m_entries.clear();
+    m_dirty = false;
+
+    QCborParserError err;
+    const auto root = QCborValue::fromCbor(p_data, &err).toMap();
+    if (err.error != QCborError::NoError) {
+        qWarning() << "failed to parse node config snapshot" << err.errorString();
+        return false;
+    }
+
+    if (root.value(QStringLiteral("version")).toInteger() != c_version) {
+        return false;
+    }
+
+    const auto entries = root.value(QStringLiteral("entries")).toMap();
+    m_entries.reserve(entries.size());
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        const auto arr = it.value().toArray();
+        if (arr.size() != 3) {
+            continue;
+        }
+
+        Entry entry;
+        entry.m_modifiedTime = arr.at(0).toInteger();
+        entry.m_size = arr.at(1).toInteger(-1);
+        entry.m_config = arr.at(2);
+        m_entries.insert(it.key().toString(), entry);
+    }
+
+    return true;
+}
+
+QByteArray NodeConfigSnapshot::toCbor() const
+{
+    QCborMap entries;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        QCborArray arr;
+        arr.append(it.value().m_modifiedTime);
+        arr.append(it.value().m_size);
+        arr.append(it.value().m_config);
+        entries.insert(it.key(), arr);
+    }
+
+    QCborMap root;
+    root.insert(QStringLiteral("version"), c_version);
+    root.insert(QStringLiteral("entries"), entries);
+    return root.toCborValue().toCbor();
+}
+
+QJsonObject NodeConfigSnapshot::findConfig(const QString &p_path,
+                                           const QDateTime &p_modifiedTimeUtc,
+                                           qint64 p_size) const
+{
+    if (!p_modifiedTimeUtc.isValid() || p_size < 0) {
+        return QJsonObject();
+    }
+
+    auto it = m_entries.constFind(p_path);
+    if (it == m_entries.constEnd()
+        || it.value().m_modifiedTime != p_modifiedTimeUtc.toMSecsSinceEpoch()
+        || it.value().m_size != p_size) {
+        return QJsonObject();
+    }
+
+    return it.value().m_config.toJsonValue().toObject();
+}
+
+void NodeConfigSnapshot::updateConfig(const QString &p_path,
+                                      const QDateTime &p_modifiedTimeUtc,
+                                      qint64 p_size,
+                                      const QJsonObject &p_config)
+{
+    if (!p_modifiedTimeUtc.isValid() || p_size < 0) {
+        return;
+    }
+
+    Entry entry;
+    entry.m_modifiedTime = p_modifiedTimeUtc.toMSecsSinceEpoch();
+    entry.m_size = p_size;
+    entry.m_config = QCborValue::fromJsonValue(p_config);
+    m_entries.insert(p_path, entry);
+    m_dirty = true;
+}
+
+void NodeConfigSnapshot::removeConfigs(const QString &p_dirPath)
+{
+    // Paths are relative to the notebook root. Empty @p_dirPath means the root.
+    const auto dirPath = PathUtils::cleanPath(p_dirPath);
+    const auto prefix = dirPath.isEmpty() ? QString() : dirPath + QLatin1Char('/');
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it.key().startsWith(prefix)) {
+            it = m_entries.erase(it);
+            m_dirty = true;
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool NodeConfigSnapshot::isDirty() const
+{
+    return m_dirty;
+}
+
+void NodeConfigSnapshot::setDirty(bool p_dirty)
+{
+    m_dirty = p_dirty;
+}
@@ -0,0 +1,63 @@
+#ifndef NODECONFIGSNAPSHOT_H
+#define NODECONFIGSNAPSHOT_H
+
+#include <QHash>
+#include <QString>
+#include <QJsonObject>
+#include <QCborValue>
+
+class QDateTime;
+
+namespace vnotex
+{
+    // Consolidated snapshot of all the node configs of a notebook in CBOR, so that
+    // the configs could be loaded in one read instead of one JSON parse per folder.
+    // Each entry is validated against the modified time and size of its config file,
+    // which remains the source of truth.
+    class NodeConfigSnapshot
+    {
+    public:
+        NodeConfigSnapshot() = default;
+
+        // Return false if @p_data is not a valid snapshot.
+        bool fromCbor(const QByteArray &p_data);
+
+        QByteArray toCbor() const;
+
+        // @p_path: path of the config file.
+        // @p_size: size of the config file.
+        // Return an empty object if there is no such entry or it is stale.
+        QJsonObject findConfig(const QString &p_path, const QDateTime &p_modifiedTimeUtc, qint64 p_size) const;
+
+        void updateConfig(const QString &p_path,
+                          const QDateTime &p_modifiedTimeUtc,
+                          qint64 p_size,
+                          const QJsonObject &p_config);
+
+        // Remove entries of config files within @p_dirPath.
+        void removeConfigs(const QString &p_dirPath);
+
+        bool isDirty() const;
+
+        void setDirty(bool p_dirty);
+
+    private:
+        struct Entry
+        {
+            // Msecs since epoch.
+            qint64 m_modifiedTime = 0;
+
+            qint64 m_size = -1;
+
+            QCborValue m_config;
+        };
+
+        QHash<QString, Entry> m_entries;
+
+        bool m_dirty = false;
+
+        static const int c_version;
+    };
+} // ns vnotex
+
+#endif // NODECONFIGSNAPSHOT_H
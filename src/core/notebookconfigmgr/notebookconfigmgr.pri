@@ -3,7 +3,11 @@ SOURCES += \
     $$PWD/vxnotebookconfigmgrfactory.cpp \
     $$PWD/inotebookconfigmgr.cpp \
     $$PWD/notebookconfig.cpp \
-    $$PWD/bundlenotebookconfigmgr.cpp
+    $$PWD/bundlenotebookconfigmgr.cpp \
+    $$PWD/nodeconfigsnapshot.cpp \
+    $$PWD/nodeconfigjournal.cpp \
+    $$PWD/sqlitenotebookconfigmgr.cpp \
+    $$PWD/sqlitenotebookconfigmgrfactory.cpp
 
 HEADERS += \
     $$PWD/inotebookconfigmgr.h \
@@ -11,4 +15,8 @@ HEADERS += \
     $$PWD/inotebookconfigmgrfactory.h \
     $$PWD/vxnotebookconfigmgrfactory.h \
     $$PWD/notebookconfig.h \
-    $$PWD/bundlenotebookconfigmgr.h
+    $$PWD/bundlenotebookconfigmgr.h \
+    $$PWD/nodeconfigsnapshot.h \
+    $$PWD/nodeconfigjournal.h \
+    $$PWD/sqlitenotebookconfigmgr.h \
+    $$PWD/sqlitenotebookconfigmgrfactory.h
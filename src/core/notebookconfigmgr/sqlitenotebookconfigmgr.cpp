@@ -0,0 +1,442 @@
+#include "sqlitenotebookconfigmgr.h"
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QHash>
+#include <QDebug>
+
+#include <notebookbackend/inotebookbackend.h>
+#include <utils/pathutils.h>
+#include <exception.h>
+
+using namespace vnotex;
+
+const QString SqliteNotebookConfigMgr::c_databaseName = "vx_nodes.db";
+
+static QVariant timeToVariant(const QDateTime &p_time)
+{
+    return p_time.isValid() ? QVariant(p_time.toMSecsSinceEpoch()) : QVariant();
+}
+
+static QDateTime timeFromVariant(const QVariant &p_var)
+{
+    if (p_var.isNull()) {
+        return QDateTime();
+    }
+    return QDateTime::fromMSecsSinceEpoch(p_var.toLongLong(), Qt::UTC);
+}
+
+SqliteNotebookConfigMgr::SqliteNotebookConfigMgr(const QString &p_name,
+                                                 const QString &p_displayName,
+                                                 const QString &p_description,
+                                                 const QSharedPointer<INotebookBackend> &p_backend,
+                                                 QObject *p_parent)
+    : VXNotebookConfigMgr(p_name, p_displayName, p_description, p_backend, p_parent),
+      m_connectionName(QStringLiteral("vnotex_nodes_%1").arg(reinterpret_cast<quintptr>(this)))
+{
+}
+
+SqliteNotebookConfigMgr::~SqliteNotebookConfigMgr()
+{
+    if (m_databaseOpened) {
+        {
+            auto db = QSqlDatabase::database(m_connectionName, false);
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(m_connectionName);
+    }
+}
+
+QString SqliteNotebookConfigMgr::getDatabaseFilePath() const
+{
+    return PathUtils::concatenateFilePath(getConfigFolderName(), c_databaseName);
+}
+
+QString SqliteNotebookConfigMgr::configPathToFolderPath(const QString &p_configPath)
+{
+    Q_ASSERT(p_configPath.endsWith(c_nodeConfigName));
+    auto folderPath = p_configPath.left(p_configPath.size() - c_nodeConfigName.size());
+    if (folderPath.endsWith(QLatin1Char('/'))) {
+        folderPath.chop(1);
+    }
+    return folderPath;
+}
+
+QSqlDatabase SqliteNotebookConfigMgr::getDatabase() const
+{
+    if (m_databaseOpened) {
+        return QSqlDatabase::database(m_connectionName);
+    }
+
+    // SQLite needs a local file so we bypass the backend here.
+    auto db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), m_connectionName);
+    db.setDatabaseName(getBackend()->getFullPath(getDatabaseFilePath()));
+    if (!db.open()) {
+        const auto msg = QString("failed to open node database (%1): %2").arg(db.databaseName(),
+                                                                              db.lastError().text());
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(m_connectionName);
+        Exception::throwOne(Exception::Type::FailToReadFile, msg);
+    }
+
+    m_databaseOpened = true;
+
+    createSchema(db);
+
+    // Convert an existing notebook with vx.json files on first open.
+    QSqlQuery query(db);
+    if (query.exec(QStringLiteral("SELECT COUNT(*) FROM folder")) && query.next() && query.value(0).toInt() == 0) {
+        if (getBackend()->existsFile(c_nodeConfigName)) {
+            const_cast<SqliteNotebookConfigMgr *>(this)->importFromNodeConfigFiles();
+        }
+    }
+
+    return db;
+}
+
+void SqliteNotebookConfigMgr::createSchema(QSqlDatabase &p_db) const
+{
+    static const QStringList statements = {
+        QStringLiteral("PRAGMA journal_mode=WAL"),
+        QStringLiteral("PRAGMA synchronous=NORMAL"),
+        QStringLiteral("CREATE TABLE IF NOT EXISTS folder ("
+                       "path TEXT PRIMARY KEY NOT NULL,"
+                       "id INTEGER,"
+                       "created_time INTEGER,"
+                       "modified_time INTEGER)"),
+        // Children of each folder. @seq keeps the order of children.
+        QStringLiteral("CREATE TABLE IF NOT EXISTS node ("
+                       "parent TEXT NOT NULL,"
+                       "name TEXT NOT NULL,"
+                       "seq INTEGER NOT NULL,"
+                       "is_folder INTEGER NOT NULL,"
+                       "id INTEGER,"
+                       "created_time INTEGER,"
+                       "modified_time INTEGER,"
+                       "attachment_folder TEXT,"
+                       "latest_modified_time INTEGER,"
+                       "PRIMARY KEY (parent, name))"),
+        QStringLiteral("CREATE TABLE IF NOT EXISTS tag ("
+                       "parent TEXT NOT NULL,"
+                       "name TEXT NOT NULL,"
+                       "tag TEXT NOT NULL)"),
+        QStringLiteral("CREATE INDEX IF NOT EXISTS node_parent_idx ON node (parent, seq)"),
+        QStringLiteral("CREATE INDEX IF NOT EXISTS node_name_idx ON node (name)"),
+        QStringLiteral("CREATE INDEX IF NOT EXISTS node_created_time_idx ON node (created_time)"),
+        QStringLiteral("CREATE INDEX IF NOT EXISTS node_modified_time_idx ON node (modified_time)"),
+        QStringLiteral("CREATE INDEX IF NOT EXISTS tag_tag_idx ON tag (tag)"),
+        QStringLiteral("CREATE INDEX IF NOT EXISTS tag_node_idx ON tag (parent, name)")
+    };
+
+    for (const auto &stmt : statements) {
+        execQuery(p_db, stmt, QVariantList());
+    }
+
+    // Databases created by older versions lack the cached sort time of folders.
+    QSqlQuery query(p_db);
+    bool hasLatestModifiedTime = false;
+    if (query.exec(QStringLiteral("PRAGMA table_info(node)"))) {
+        while (query.next()) {
+            if (query.value(1).toString() == QStringLiteral("latest_modified_time")) {
+                hasLatestModifiedTime = true;
+                break;
+            }
+        }
+    }
+
+    if (!hasLatestModifiedTime) {
+        execQuery(p_db, QStringLiteral("ALTER TABLE node ADD COLUMN latest_modified_time INTEGER"), QVariantList());
+    }
+}
+
+void SqliteNotebookConfigMgr::execQuery(const QSqlDatabase &p_db, const QString &p_sql, const QVariantList &p_values) const
+{
+    QSqlQuery query(p_db);
+    query.prepare(p_sql);
+    for (const auto &val : p_values) {
+        query.addBindValue(val);
+    }
+
+    if (!query.exec()) {
+        Exception::throwOne(Exception::Type::FailToWriteFile,
+                            QString("failed to execute query of node database (%1): %2").arg(p_sql,
+                                                                                             query.lastError().text()));
+    }
+}
+
+void SqliteNotebookConfigMgr::runInTransaction(QSqlDatabase &p_db, const std::function<void()> &p_func) const
+{
+    const bool inTransaction = p_db.transaction();
+    try {
+        p_func();
+    } catch (...) {
+        if (inTransaction) {
+            p_db.rollback();
+        }
+        throw;
+    }
+
+    if (inTransaction && !p_db.commit()) {
+        const auto msg = QString("failed to commit node database: %1").arg(p_db.lastError().text());
+        p_db.rollback();
+        Exception::throwOne(Exception::Type::FailToWriteFile, msg);
+    }
+}
+
+QSharedPointer<VXNotebookConfigMgr::NodeConfig> SqliteNotebookConfigMgr::readNodeConfig(const QString &p_path) const
+{
+    auto db = getDatabase();
+    const auto folderPath = PathUtils::cleanPath(p_path);
+
+    QSqlQuery query(db);
+    query.prepare(QStringLiteral("SELECT id, created_time, modified_time FROM folder WHERE path = ?"));
+    query.addBindValue(folderPath);
+    if (!query.exec() || !query.next()) {
+        Exception::throwOne(Exception::Type::InvalidArgument,
+                            QString("node path (%1) does not exist in node database").arg(p_path));
+    }
+
+    auto nodeConfig = QSharedPointer<NodeConfig>::create(getCodeVersion(),
+                                                         query.value(0).toULongLong(),
+                                                         timeFromVariant(query.value(1)),
+                                                         timeFromVariant(query.value(2)));
+
+    QHash<QString, QStringList> tags;
+    query.prepare(QStringLiteral("SELECT name, tag FROM tag WHERE parent = ? ORDER BY rowid"));
+    query.addBindValue(folderPath);
+    if (query.exec()) {
+        while (query.next()) {
+            tags[query.value(0).toString()] << query.value(1).toString();
+        }
+    }
+
+    query.prepare(QStringLiteral("SELECT name, is_folder, id, created_time, modified_time, attachment_folder, "
+                                 "latest_modified_time FROM node WHERE parent = ? ORDER BY seq"));
+    query.addBindValue(folderPath);
+    if (!query.exec()) {
+        Exception::throwOne(Exception::Type::FailToReadFile,
+                            QString("failed to read children of node (%1): %2").arg(p_path, query.lastError().text()));
+    }
+
+    while (query.next()) {
+        if (query.value(1).toBool()) {
+            NodeFolderConfig folderConfig;
+            folderConfig.m_name = query.value(0).toString();
+            folderConfig.m_createdTimeUtc = timeFromVariant(query.value(3));
+            folderConfig.m_modifiedTimeUtc = timeFromVariant(query.value(4));
+            folderConfig.m_latestModifiedTimeUtc = timeFromVariant(query.value(6));
+            nodeConfig->m_folders.push_back(folderConfig);
+        } else {
+            NodeFileConfig fileConfig;
+            fileConfig.m_name = query.value(0).toString();
+            fileConfig.m_id = query.value(2).toULongLong();
+            fileConfig.m_createdTimeUtc = timeFromVariant(query.value(3));
+            fileConfig.m_modifiedTimeUtc = timeFromVariant(query.value(4));
+            fileConfig.m_attachmentFolder = query.value(5).toString();
+            fileConfig.m_tags = tags.value(fileConfig.m_name);
+            nodeConfig->m_files.push_back(fileConfig);
+        }
+    }
+
+    return nodeConfig;
+}
+
+void SqliteNotebookConfigMgr::writeNodeConfig(const QString &p_path, const NodeConfig &p_config) const
+{
+    auto db = getDatabase();
+    const auto folderPath = configPathToFolderPath(p_path);
+
+    // Nested calls (such as import) run within the outer transaction.
+    runInTransaction(db, [&]() {
+        execQuery(db,
+                  QStringLiteral("INSERT OR REPLACE INTO folder (path, id, created_time, modified_time) VALUES (?, ?, ?, ?)"),
+                  { folderPath,
+                    static_cast<qulonglong>(p_config.m_id),
+                    timeToVariant(p_config.m_createdTimeUtc),
+                    timeToVariant(p_config.m_modifiedTimeUtc) });
+        execQuery(db, QStringLiteral("DELETE FROM node WHERE parent = ?"), { folderPath });
+        execQuery(db, QStringLiteral("DELETE FROM tag WHERE parent = ?"), { folderPath });
+
+        int seq = 0;
+        for (const auto &folder : p_config.m_folders) {
+            execQuery(db,
+                      QStringLiteral("INSERT INTO node (parent, name, seq, is_folder, created_time, modified_time, latest_modified_time) "
+                                     "VALUES (?, ?, ?, 1, ?, ?, ?)"),
+                      { folderPath,
+                        folder.m_name,
+                        seq++,
+                        timeToVariant(folder.m_createdTimeUtc),
+                        timeToVariant(folder.m_modifiedTimeUtc),
+                        timeToVariant(folder.m_latestModifiedTimeUtc) });
+        }
+
+        for (const auto &file : p_config.m_files) {
+            execQuery(db,
+                      QStringLiteral("INSERT INTO node (parent, name, seq, is_folder, id, created_time, modified_time, attachment_folder) "
+                                     "VALUES (?, ?, ?, 0, ?, ?, ?, ?)"),
+                      { folderPath,
+                        file.m_name,
+                        seq++,
+                        static_cast<qulonglong>(file.m_id),
+                        timeToVariant(file.m_createdTimeUtc),
+                        timeToVariant(file.m_modifiedTimeUtc),
+                        file.m_attachmentFolder });
+
+            for (const auto &tag : file.m_tags) {
+                execQuery(db,
+                          QStringLiteral("INSERT INTO tag (parent, name, tag) VALUES (?, ?, ?)"),
+                          { folderPath, file.m_name, tag });
+            }
+        }
+    });
+}
+
+void SqliteNotebookConfigMgr::removeNodeConfig(const QString &p_folderPath)
+{
+    auto db = getDatabase();
+    const auto folderPath = PathUtils::cleanPath(p_folderPath);
+
+    runInTransaction(db, [&]() {
+        execQuery(db, QStringLiteral("DELETE FROM folder WHERE path = ?"), { folderPath });
+        execQuery(db, QStringLiteral("DELETE FROM node WHERE parent = ?"), { folderPath });
+        execQuery(db, QStringLiteral("DELETE FROM tag WHERE parent = ?"), { folderPath });
+    });
+}
+
+QSharedPointer<NodeLoadData> SqliteNotebookConfigMgr::readNodeLoadData(const QString &p_path) const
+{
+    Q_UNUSED(p_path);
+    return nullptr;
+}
+
+void SqliteNotebookConfigMgr::renameNode(Node *p_node, const QString &p_name)
+{
+    const auto oldPath = p_node->fetchPath();
+    VXNotebookConfigMgr::renameNode(p_node, p_name);
+    if (p_node->isContainer()) {
+        renameFolder(oldPath, p_node->fetchPath());
+    }
+}
+
+void SqliteNotebookConfigMgr::moveNodeConfigs(const QString &p_oldFolderPath, const QString &p_newFolderPath)
+{
+    renameFolder(p_oldFolderPath, p_newFolderPath);
+}
+
+void SqliteNotebookConfigMgr::renameFolder(const QString &p_oldPath, const QString &p_newPath)
+{
+    auto db = getDatabase();
+    const auto oldPrefix = p_oldPath + QLatin1Char('/');
+    // Do not use LIKE, which is case insensitive.
+    // Lengths are computed by SQLite, which counts characters instead of UTF-16 units.
+    const QVariantList values = { p_newPath, p_oldPath, p_oldPath, oldPrefix, oldPrefix };
+
+    runInTransaction(db, [&]() {
+        execQuery(db,
+                  QStringLiteral("UPDATE folder SET path = ? || substr(path, length(?) + 1) "
+                                 "WHERE path = ? OR substr(path, 1, length(?)) = ?"),
+                  values);
+        execQuery(db,
+                  QStringLiteral("UPDATE node SET parent = ? || substr(parent, length(?) + 1) "
+                                 "WHERE parent = ? OR substr(parent, 1, length(?)) = ?"),
+                  values);
+        execQuery(db,
+                  QStringLiteral("UPDATE tag SET parent = ? || substr(parent, length(?) + 1) "
+                                 "WHERE parent = ? OR substr(parent, 1, length(?)) = ?"),
+                  values);
+    });
+}
+
+QStringList SqliteNotebookConfigMgr::queryNotes(const QString &p_sql, const QVariantList &p_values) const
+{
+    QStringList paths;
+
+    QSqlQuery query(getDatabase());
+    query.prepare(p_sql);
+    for (const auto &val : p_values) {
+        query.addBindValue(val);
+    }
+
+    if (!query.exec()) {
+        qWarning() << "failed to query node database" << p_sql << query.lastError().text();
+        return paths;
+    }
+
+    while (query.next()) {
+        paths << PathUtils::concatenateFilePath(query.value(0).toString(), query.value(1).toString());
+    }
+
+    return paths;
+}
+
+QStringList SqliteNotebookConfigMgr::queryNotesByTag(const QString &p_tag) const
+{
+    return queryNotes(QStringLiteral("SELECT parent, name FROM tag WHERE tag = ?"), { p_tag });
+}
+
+QStringList SqliteNotebookConfigMgr::queryNotesCreatedBetween(const QDateTime &p_beginUtc, const QDateTime &p_endUtc) const
+{
+    return queryNotes(QStringLiteral("SELECT parent, name FROM node "
+                                     "WHERE is_folder = 0 AND created_time >= ? AND created_time < ? "
+                                     "ORDER BY created_time"),
+                      { p_beginUtc.toMSecsSinceEpoch(), p_endUtc.toMSecsSinceEpoch() });
+}
+
+QStringList SqliteNotebookConfigMgr::queryNotesModifiedBetween(const QDateTime &p_beginUtc, const QDateTime &p_endUtc) const
+{
+    return queryNotes(QStringLiteral("SELECT parent, name FROM node "
+                                     "WHERE is_folder = 0 AND modified_time >= ? AND modified_time < ? "
+                                     "ORDER BY modified_time"),
+                      { p_beginUtc.toMSecsSinceEpoch(), p_endUtc.toMSecsSinceEpoch() });
+}
+
+QStringList SqliteNotebookConfigMgr::queryNotesByModifiedTime(int p_limit) const
+{
+    return queryNotes(QStringLiteral("SELECT parent, name FROM node "
+                                     "WHERE is_folder = 0 ORDER BY modified_time DESC LIMIT ?"),
+                      { p_limit });
+}
+
+void SqliteNotebookConfigMgr::importFromNodeConfigFiles()
+{
+    auto db = getDatabase();
+    runInTransaction(db, [this]() {
+        importFolder(QString());
+    });
+}
+
+void SqliteNotebookConfigMgr::importFolder(const QString &p_folderPath)
+{
+    if (!getBackend()->existsFile(PathUtils::concatenateFilePath(p_folderPath, c_nodeConfigName))) {
+        qWarning() << "skipped importing folder without config" << p_folderPath;
+        return;
+    }
+
+    auto config = VXNotebookConfigMgr::readNodeConfig(p_folderPath);
+    writeNodeConfig(PathUtils::concatenateFilePath(p_folderPath, c_nodeConfigName), *config);
+
+    for (const auto &folder : config->m_folders) {
+        importFolder(PathUtils::concatenateFilePath(p_folderPath, folder.m_name));
+    }
+}
+
+void SqliteNotebookConfigMgr::exportToNodeConfigFiles() const
+{
+    exportFolder(QString());
+}
+
+void SqliteNotebookConfigMgr::exportFolder(const QString &p_folderPath) const
+{
+    if (!getBackend()->existsDir(p_folderPath)) {
+        qWarning() << "skipped exporting folder that does not exist" << p_folderPath;
+        return;
+    }
+
+    auto config = readNodeConfig(p_folderPath);
+    VXNotebookConfigMgr::writeNodeConfig(PathUtils::concatenateFilePath(p_folderPath, c_nodeConfigName), *config);
+
+    for (const auto &folder : config->m_folders) {
+        exportFolder(PathUtils::concatenateFilePath(p_folderPath, folder.m_name));
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef SQLITENOTEBOOKCONFIGMGR_H
+#define SQLITENOTEBOOKCONFIGMGR_H
+
+#include "vxnotebookconfigmgr.h"
+
+#include <QStringList>
+#include <QVariantList>
+#include <functional>
+
+class QSqlDatabase;
+
+namespace vnotex
+{
+    // Config manager storing node configs in an embedded SQLite database instead of
+    // one vx.json per folder, which scales to very large notebooks and supports
+    // metadata queries via indexes.
+    // Files and folders are managed the same as VXNotebookConfigMgr.
+    class SqliteNotebookConfigMgr : public VXNotebookConfigMgr
+    {
+        Q_OBJECT
+    public:
+        explicit SqliteNotebookConfigMgr(const QString &p_name,
+                                         const QString &p_displayName,
+                                         const QString &p_description,
+                                         const QSharedPointer<INotebookBackend> &p_backend,
+                                         QObject *p_parent = nullptr);
+
+        ~SqliteNotebookConfigMgr();
+
+        // The database connection could only be used in the thread creating it,
+        // so nodes are loaded in the main thread.
+        QSharedPointer<NodeLoadData> readNodeLoadData(const QString &p_path) const Q_DECL_OVERRIDE;
+
+        void renameNode(Node *p_node, const QString &p_name) Q_DECL_OVERRIDE;
+
+        // Metadata queries.
+        // Return paths of notes relative to the notebook root folder.
+        QStringList queryNotesByTag(const QString &p_tag) const;
+
+        QStringList queryNotesCreatedBetween(const QDateTime &p_beginUtc, const QDateTime &p_endUtc) const;
+
+        QStringList queryNotesModifiedBetween(const QDateTime &p_beginUtc, const QDateTime &p_endUtc) const;
+
+        // Sorted by modified time in descending order.
+        // @p_limit: negative for no limit.
+        QStringList queryNotesByModifiedTime(int p_limit = -1) const;
+
+        // Convert all the vx.json files of the notebook into the database.
+        void importFromNodeConfigFiles();
+
+        // Write the database back as vx.json files of the notebook.
+        void exportToNodeConfigFiles() const;
+
+    protected:
+        QSharedPointer<VXNotebookConfigMgr::NodeConfig> readNodeConfig(const QString &p_path) const Q_DECL_OVERRIDE;
+
+        void writeNodeConfig(const QString &p_path, const NodeConfig &p_config) const Q_DECL_OVERRIDE;
+
+        void removeNodeConfig(const QString &p_folderPath) Q_DECL_OVERRIDE;
+
+        void moveNodeConfigs(const QString &p_oldFolderPath, const QString &p_newFolderPath) Q_DECL_OVERRIDE;
+
+    private:
+        // Open the database and create the schema if needed.
+        QSqlDatabase getDatabase() const;
+
+        void createSchema(QSqlDatabase &p_db) const;
+
+        void importFolder(const QString &p_folderPath);
+
+        void exportFolder(const QString &p_folderPath) const;
+
+        // Update the paths of folder @p_oldPath and its descendants.
+        void renameFolder(const QString &p_oldPath, const QString &p_newPath);
+
+        QStringList queryNotes(const QString &p_sql, const QVariantList &p_values) const;
+
+        void execQuery(const QSqlDatabase &p_db, const QString &p_sql, const QVariantList &p_values) const;
+
+        // Run @p_func within a transaction, which is rolled back if @p_func throws.
+        // Nested calls run within the outer transaction.
+        void runInTransaction(QSqlDatabase &p_db, const std::function<void()> &p_func) const;
+
+        QString getDatabaseFilePath() const;
+
+        // Get folder path from the path of its config file.
+        static QString configPathToFolderPath(const QString &p_configPath);
+
+        QString m_connectionName;
+
+        mutable bool m_databaseOpened = false;
+
+        // Name of the database file within the notebook config folder.
+        static const QString c_databaseName;
+    };
+} // ns vnotex
+
+#endif // SQLITENOTEBOOKCONFIGMGR_H
@@ -0,0 +1,35 @@
+#include "sqlitenotebookconfigmgrfactory.h"
+
+#include <QObject>
+
+#include "sqlitenotebookconfigmgr.h"
+#include "../notebookbackend/inotebookbackend.h"
+
+using namespace vnotex;
+
+SqliteNotebookConfigMgrFactory::SqliteNotebookConfigMgrFactory()
+{
+}
+
+QString SqliteNotebookConfigMgrFactory::getName() const
+{
+    return QStringLiteral("sqlite.vnotex");
+}
+
+QString SqliteNotebookConfigMgrFactory::getDisplayName() const
+{
+    return QObject::tr("VNoteX SQLite Notebook Configuration");
+}
+
+QString SqliteNotebookConfigMgrFactory::getDescription() const
+{
+    return QObject::tr("VNoteX notebook configuration stored in a SQLite database for large notebooks");
+}
+
+QSharedPointer<INotebookConfigMgr> SqliteNotebookConfigMgrFactory::createNotebookConfigMgr(const QSharedPointer<INotebookBackend> &p_backend)
+{
+    return QSharedPointer<SqliteNotebookConfigMgr>::create(getName(),
+                                                           getDisplayName(),
+                                                           getDescription(),
+                                                           p_backend);
+}
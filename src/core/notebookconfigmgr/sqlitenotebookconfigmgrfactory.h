@@ -0,0 +1,25 @@
+#ifndef SQLITENOTEBOOKCONFIGMGRFACTORY_H
+#define SQLITENOTEBOOKCONFIGMGRFACTORY_H
+
+
+#include "inotebookconfigmgrfactory.h"
+
+
+namespace vnotex
+{
+    class SqliteNotebookConfigMgrFactory : public INotebookConfigMgrFactory
+    {
+    public:
+        SqliteNotebookConfigMgrFactory();
+
+        QString getName() const Q_DECL_OVERRIDE;
+
+        QString getDisplayName() const Q_DECL_OVERRIDE;
+
+        QString getDescription()const Q_DECL_OVERRIDE;
+
+        QSharedPointer<INotebookConfigMgr> createNotebookConfigMgr(const QSharedPointer<INotebookBackend> &p_backend) Q_DECL_OVERRIDE;
+    };
+} // ns vnotex
+
+#endif // SQLITENOTEBOOKCONFIGMGRFACTORY_H
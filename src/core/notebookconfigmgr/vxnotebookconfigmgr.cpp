@@ -4,6 +4,10 @@
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QDebug>
+#include <QTimer>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QSet>
 
 #include <notebookbackend/inotebookbackend.h>
 #include <notebook/notebookparameters.h>
@@ -20,6 +24,9 @@
 
 #include <utils/contentmediautils.h>
 
+#include "nodeconfigsnapshot.h"
+#include "nodeconfigjournal.h"
+
 using namespace vnotex;
 
 const QString VXNotebookConfigMgr::NodeConfig::c_version = "version";
@@ -40,6 +47,8 @@ const QString VXNotebookConfigMgr::NodeConfig::c_attachmentFolder = "attachment_
 
 const QString VXNotebookConfigMgr::NodeConfig::c_tags = "tags";
 
+const QString VXNotebookConfigMgr::NodeConfig::c_latestModifiedTimeUtc = "latest_modified_time";
+
 QJsonObject VXNotebookConfigMgr::NodeFileConfig::toJson() const
 {
     QJsonObject jobj;
@@ -86,12 +95,24 @@ QJsonObject VXNotebookConfigMgr::NodeFolderConfig::toJson() const
 
     jobj[NodeConfig::c_name] = m_name;
 
+    if (m_createdTimeUtc.isValid()) {
+        jobj[NodeConfig::c_createdTimeUtc] = Utils::dateTimeStringUniform(m_createdTimeUtc);
+        jobj[NodeConfig::c_modifiedTimeUtc] = Utils::dateTimeStringUniform(m_modifiedTimeUtc);
+        jobj[NodeConfig::c_latestModifiedTimeUtc] = Utils::dateTimeStringUniform(m_latestModifiedTimeUtc);
+    }
+
     return jobj;
 }
 
 void VXNotebookConfigMgr::NodeFolderConfig::fromJson(const QJsonObject &p_jobj)
 {
     m_name = p_jobj[NodeConfig::c_name].toString();
+
+    if (p_jobj.contains(NodeConfig::c_createdTimeUtc)) {
+        m_createdTimeUtc = Utils::dateTimeFromStringUniform(p_jobj[NodeConfig::c_createdTimeUtc].toString());
+        m_modifiedTimeUtc = Utils::dateTimeFromStringUniform(p_jobj[NodeConfig::c_modifiedTimeUtc].toString());
+        m_latestModifiedTimeUtc = Utils::dateTimeFromStringUniform(p_jobj[NodeConfig::c_latestModifiedTimeUtc].toString());
+    }
 }
 
 VXNotebookConfigMgr::NodeConfig::NodeConfig()
@@ -167,9 +188,19 @@ const QString VXNotebookConfigMgr::c_nodeConfigName = "vx.json";
 
 const QString VXNotebookConfigMgr::c_recycleBinFolderName = "vx_recycle_bin";
 
+const QString VXNotebookConfigMgr::c_snapshotFileName = "vx_snapshot.cbor";
+
+const QString VXNotebookConfigMgr::c_journalFileName = "vx_journal.jsonl";
+
+const int VXNotebookConfigMgr::c_maxJournalEntries = 256;
+
 bool VXNotebookConfigMgr::s_initialized = false;
 
-QVector<QRegExp> VXNotebookConfigMgr::s_externalNodeExcludePatterns;
+bool VXNotebookConfigMgr::s_snapshotEnabled = true;
+
+bool VXNotebookConfigMgr::s_journalEnabled = true;
+
+QRegularExpression VXNotebookConfigMgr::s_externalNodeExcludeRegExp;
 
 VXNotebookConfigMgr::VXNotebookConfigMgr(const QString &p_name,
                                          const QString &p_displayName,
@@ -182,13 +213,58 @@ VXNotebookConfigMgr::VXNotebookConfigMgr(const QString &p_name,
     if (!s_initialized) {
         s_initialized = true;
 
-        const auto &patterns = ConfigMgr::getInst().getCoreConfig().getExternalNodeExcludePatterns();
-        s_externalNodeExcludePatterns.reserve(patterns.size());
-        for (const auto &pat : patterns) {
+        const auto &coreConfig = ConfigMgr::getInst().getCoreConfig();
+        s_snapshotEnabled = coreConfig.isMetadataSnapshotEnabled();
+        s_journalEnabled = coreConfig.isMetadataJournalEnabled();
+
+        QStringList regExps;
+        for (const auto &pat : coreConfig.getExternalNodeExcludePatterns()) {
             if (!pat.isEmpty()) {
-                s_externalNodeExcludePatterns.push_back(QRegExp(pat, Qt::CaseInsensitive, QRegExp::Wildcard));
+                regExps << QRegularExpression::anchoredPattern(QRegularExpression::wildcardToRegularExpression(pat));
             }
         }
+        if (!regExps.isEmpty()) {
+            s_externalNodeExcludeRegExp.setPattern(regExps.join(QLatin1Char('|')));
+            s_externalNodeExcludeRegExp.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+            s_externalNodeExcludeRegExp.optimize();
+        }
+    }
+
+    m_snapshotSaveTimer = new QTimer(this);
+    m_snapshotSaveTimer->setSingleShot(true);
+    m_snapshotSaveTimer->setInterval(3000);
+    connect(m_snapshotSaveTimer, &QTimer::timeout,
+            this, &VXNotebookConfigMgr::saveSnapshot);
+
+    m_journalFoldTimer = new QTimer(this);
+    m_journalFoldTimer->setSingleShot(true);
+    m_journalFoldTimer->setInterval(5000);
+    connect(m_journalFoldTimer, &QTimer::timeout,
+            this, &VXNotebookConfigMgr::tryFoldJournal);
+
+    m_latestModifiedTimeTimer = new QTimer(this);
+    m_latestModifiedTimeTimer->setSingleShot(true);
+    m_latestModifiedTimeTimer->setInterval(3000);
+    connect(m_latestModifiedTimeTimer, &QTimer::timeout,
+            this, &VXNotebookConfigMgr::updateLatestModifiedTimes);
+}
+
+VXNotebookConfigMgr::~VXNotebookConfigMgr()
+{
+    // Subclasses not supporting journal never create it.
+    // They are gone by now, so only updates via the journal are left to do.
+    if (m_journal) {
+        updateLatestModifiedTimes();
+    }
+
+    if (m_journal && !m_journal->isEmpty()) {
+        tryFoldJournal();
+    }
+
+    try {
+        saveSnapshot();
+    } catch (Exception &p_e) {
+        qWarning() << "failed to save node config snapshot" << p_e.what();
     }
 }
 
@@ -226,6 +302,9 @@ void VXNotebookConfigMgr::createEmptyRootNode()
 
 QSharedPointer<Node> VXNotebookConfigMgr::loadRootNode()
 {
+    // Replay the journal left by last session.
+    foldJournal();
+
     auto nodeConfig = readNodeConfig("");
     QSharedPointer<Node> root = nodeConfigToNode(*nodeConfig, "", nullptr);
     root->setUse(Node::Use::Root);
@@ -291,15 +370,96 @@ QSharedPointer<VXNotebookConfigMgr::NodeConfig> VXNotebookConfigMgr::readNodeCon
                             QString("node (%1) is a file node without config").arg(p_path));
     } else {
         auto configPath = PathUtils::concatenateFilePath(p_path, c_nodeConfigName);
-        auto data = backend->readFile(configPath);
         auto nodeConfig = QSharedPointer<NodeConfig>::create();
-        nodeConfig->fromJson(QJsonDocument::fromJson(data).object());
+        nodeConfig->fromJson(readNodeConfigJson(configPath));
         return nodeConfig;
     }
 
     return nullptr;
 }
 
+QJsonObject VXNotebookConfigMgr::readNodeConfigJson(const QString &p_configPath) const
+{
+    if (m_journal && m_journal->hasEntries(p_configPath) && !foldJournalEntries(p_configPath, true)) {
+        // Apply the pending entries in memory until they could be folded.
+        auto jobj = readNodeConfigFileJson(p_configPath);
+        const auto entries = m_journal->getEntries(p_configPath);
+        for (const auto &entry : entries) {
+            NodeConfigJournal::apply(jobj, entry);
+        }
+        return jobj;
+    }
+
+    return readNodeConfigFileJson(p_configPath);
+}
+
+QJsonObject VXNotebookConfigMgr::readNodeConfigFileJson(const QString &p_configPath) const
+{
+    auto backend = getBackend();
+    auto snapshot = getSnapshot();
+    if (!snapshot) {
+        return QJsonDocument::fromJson(backend->readFile(p_configPath)).object();
+    }
+
+    const auto modifiedTime = backend->getModifiedTimeUtc(p_configPath);
+    const auto size = backend->getFileSize(p_configPath);
+    auto jobj = snapshot->findConfig(p_configPath, modifiedTime, size);
+    if (jobj.isEmpty()) {
+        // Stale or missing. Fall back to the config file.
+        jobj = QJsonDocument::fromJson(backend->readFile(p_configPath)).object();
+        snapshot->updateConfig(p_configPath, modifiedTime, size, jobj);
+        m_snapshotSaveTimer->start();
+    }
+
+    return jobj;
+}
+
+NodeConfigSnapshot *VXNotebookConfigMgr::getSnapshot() const
+{
+    if (!s_snapshotEnabled) {
+        return nullptr;
+    }
+
+    if (!m_snapshotLoaded) {
+        m_snapshotLoaded = true;
+        m_snapshot.reset(new NodeConfigSnapshot());
+
+        const auto snapshotPath = getSnapshotFilePath();
+        if (QFileInfo::exists(snapshotPath)) {
+            try {
+                m_snapshot->fromCbor(FileUtils::readFile(snapshotPath));
+            } catch (Exception &p_e) {
+                qWarning() << "failed to read node config snapshot" << p_e.what();
+            }
+        }
+    }
+
+    return m_snapshot.data();
+}
+
+void VXNotebookConfigMgr::saveSnapshot() const
+{
+    if (!m_snapshot || !m_snapshot->isDirty()) {
+        return;
+    }
+
+    auto backend = getBackend();
+    if (!backend->existsDir(getConfigFolderName())) {
+        // Notebook is removed.
+        return;
+    }
+
+    FileUtils::writeFile(getSnapshotFilePath(), m_snapshot->toCbor());
+    m_snapshot->setDirty(false);
+}
+
+QString VXNotebookConfigMgr::getSnapshotFilePath() const
+{
+    // Kept out of the notebook since modified times differ on synced machines.
+    return PathUtils::concatenateFilePath(ConfigMgr::getInst().getUserNotebookCacheFolder(getBackend()->getRootPath()),
+                                          c_snapshotFileName);
+}
+
 QString VXNotebookConfigMgr::getNodeConfigFilePath(const Node *p_node) const
 {
     Q_ASSERT(p_node->isContainer());
@@ -308,13 +468,215 @@ QString VXNotebookConfigMgr::getNodeConfigFilePath(const Node *p_node) const
 
 void VXNotebookConfigMgr::writeNodeConfig(const QString &p_path, const NodeConfig &p_config) const
 {
-    getBackend()->writeFile(p_path, p_config.toJson());
+    const auto jobj = p_config.toJson();
+    getBackend()->writeFile(p_path, jobj);
+
+    auto snapshot = getSnapshot();
+    if (snapshot) {
+        snapshot->updateConfig(p_path, getBackend()->getModifiedTimeUtc(p_path), getBackend()->getFileSize(p_path), jobj);
+        m_snapshotSaveTimer->start();
+    }
 }
 
 void VXNotebookConfigMgr::writeNodeConfig(const Node *p_node)
 {
     auto config = nodeToNodeConfig(p_node);
-    writeNodeConfig(getNodeConfigFilePath(p_node), *config);
+    const auto configPath = getNodeConfigFilePath(p_node);
+    writeNodeConfig(configPath, *config);
+
+    if (m_journal && m_journal->hasEntries(configPath)) {
+        // Pending entries are covered by the rewrite.
+        appendJournalEntry(NodeConfigJournal::resetEntry(configPath));
+    }
+
+    if (!m_updatingLatestModifiedTimes) {
+        markLatestModifiedTimeDirty(p_node);
+    }
+}
+
+void VXNotebookConfigMgr::markLatestModifiedTimeDirty(const Node *p_folder)
+{
+    for (auto folder = p_folder; folder && !folder->isRoot(); folder = folder->getParent()) {
+        if (m_latestModifiedTimeDirtyFolders.contains(folder)) {
+            // So are its ancestors.
+            break;
+        }
+        m_latestModifiedTimeDirtyFolders.insert(folder, folder->sharedFromThis());
+    }
+
+    if (!m_latestModifiedTimeDirtyFolders.isEmpty() && !m_latestModifiedTimeTimer->isActive()) {
+        m_latestModifiedTimeTimer->start();
+    }
+}
+
+void VXNotebookConfigMgr::updateLatestModifiedTimes()
+{
+    m_latestModifiedTimeTimer->stop();
+    const auto folders = m_latestModifiedTimeDirtyFolders.values();
+    m_latestModifiedTimeDirtyFolders.clear();
+
+    m_updatingLatestModifiedTimes = true;
+    for (const auto &weakFolder : folders) {
+        auto folder = weakFolder.toStrongRef();
+        if (!folder || !folder->getParent() || folder->getNotebook() != getNotebook()) {
+            // Removed meanwhile.
+            continue;
+        }
+
+        try {
+            if (getJournal()) {
+                QJsonObject fields;
+                fields[NodeConfig::c_latestModifiedTimeUtc] = Utils::dateTimeStringUniform(folder->fetchLatestModifiedTimeUtc());
+                appendJournalEntry(NodeConfigJournal::updateChildEntry(getNodeConfigFilePath(folder->getParent()),
+                                                                       NodeConfig::c_folders,
+                                                                       folder->getName(),
+                                                                       fields));
+            } else {
+                writeNodeConfig(folder->getParent());
+            }
+        } catch (Exception &p_e) {
+            qWarning() << "failed to update latest modified time of folder" << folder->fetchPath() << p_e.what();
+        }
+    }
+    m_updatingLatestModifiedTimes = false;
+}
+
+bool VXNotebookConfigMgr::isJournalSupported() const
+{
+    return true;
+}
+
+NodeConfigJournal *VXNotebookConfigMgr::getJournal() const
+{
+    if (!s_journalEnabled || !isJournalSupported()) {
+        return nullptr;
+    }
+
+    if (!m_journal) {
+        m_journal.reset(new NodeConfigJournal());
+
+        const auto journalPath = getJournalFilePath();
+        if (QFileInfo::exists(journalPath)) {
+            try {
+                m_journal->fromData(FileUtils::readFile(journalPath));
+            } catch (Exception &p_e) {
+                qWarning() << "failed to read node config journal" << p_e.what();
+            }
+        }
+    }
+
+    return m_journal.data();
+}
+
+QString VXNotebookConfigMgr::getJournalFilePath() const
+{
+    // Kept out of the notebook so that a journal synced from another machine is not replayed.
+    return PathUtils::concatenateFilePath(ConfigMgr::getInst().getUserNotebookCacheFolder(getBackend()->getRootPath()),
+                                          c_journalFileName);
+}
+
+void VXNotebookConfigMgr::appendJournalEntry(const QJsonObject &p_entry)
+{
+    auto journal = getJournal();
+    Q_ASSERT(journal);
+    const auto line = journal->addEntry(p_entry);
+    try {
+        FileUtils::appendFile(getJournalFilePath(), line);
+    } catch (Exception &p_e) {
+        qWarning() << "failed to append node config journal" << p_e.what();
+        foldJournal();
+        return;
+    }
+
+    if (journal->size() >= c_maxJournalEntries) {
+        foldJournal();
+    } else if (!journal->isEmpty() && !m_journalFoldTimer->isActive()) {
+        m_journalFoldTimer->start();
+    }
+}
+
+void VXNotebookConfigMgr::foldJournal() const
+{
+    m_journalFoldTimer->stop();
+
+    auto journal = getJournal();
+    if (!journal) {
+        return;
+    }
+
+    FileUtils::DirectorySyncBatch syncBatch;
+    bool allFolded = true;
+    const auto configPaths = journal->getConfigPaths();
+    for (const auto &configPath : configPaths) {
+        if (!foldJournalEntries(configPath, false)) {
+            allFolded = false;
+        }
+    }
+
+    // Make sure the folded configs are on disk before removing the journal.
+    syncBatch.flush();
+
+    const auto journalPath = getJournalFilePath();
+    if (allFolded) {
+        journal->clear();
+        if (QFileInfo::exists(journalPath)) {
+            FileUtils::removeFile(journalPath);
+        }
+        return;
+    }
+
+    // Keep only the entries failed to fold and retry later.
+    FileUtils::writeFileDurably(journalPath, journal->toData());
+    m_journalFoldTimer->start();
+}
+
+void VXNotebookConfigMgr::tryFoldJournal() const
+{
+    try {
+        foldJournal();
+    } catch (Exception &p_e) {
+        qWarning() << "failed to fold node config journal" << p_e.what();
+    }
+}
+
+bool VXNotebookConfigMgr::foldJournalEntries(const QString &p_configPath, bool p_markFolded) const
+{
+    const auto entries = m_journal->takeEntries(p_configPath);
+    if (entries.isEmpty()) {
+        return true;
+    }
+
+    try {
+        auto jobj = readNodeConfigFileJson(p_configPath);
+        for (const auto &entry : entries) {
+            NodeConfigJournal::apply(jobj, entry);
+        }
+
+        NodeConfig config;
+        config.fromJson(jobj);
+        writeNodeConfig(p_configPath, config);
+    } catch (Exception &p_e) {
+        if (!getBackend()->existsFile(p_configPath)) {
+            // The folder has been removed along with its config.
+            qWarning() << "dropped node config journal entries of removed config" << p_configPath << p_e.what();
+            return true;
+        }
+
+        qWarning() << "failed to fold node config journal" << p_configPath << p_e.what();
+        m_journal->restoreEntries(p_configPath, entries);
+        return false;
+    }
+
+    if (p_markFolded) {
+        try {
+            FileUtils::appendFile(getJournalFilePath(),
+                                  m_journal->addEntry(NodeConfigJournal::resetEntry(p_configPath)));
+        } catch (Exception &p_e) {
+            qWarning() << "failed to append node config journal" << p_e.what();
+        }
+    }
+
+    return true;
 }
 
 QSharedPointer<Node> VXNotebookConfigMgr::nodeConfigToNode(const NodeConfig &p_config,
@@ -328,11 +690,25 @@ QSharedPointer<Node> VXNotebookConfigMgr::nodeConfigToNode(const NodeConfig &p_c
 
 void VXNotebookConfigMgr::loadFolderNode(Node *p_node, const NodeConfig &p_config) const
 {
+    QVector<bool> foldersExist;
+    QVector<bool> filesExist;
+    checkChildrenExist(p_node->fetchPath(), p_config, foldersExist, filesExist);
+    loadFolderNode(p_node, p_config, foldersExist, filesExist);
+}
+
+void VXNotebookConfigMgr::loadFolderNode(Node *p_node,
+                                         const NodeConfig &p_config,
+                                         const QVector<bool> &p_foldersExist,
+                                         const QVector<bool> &p_filesExist) const
+{
+    Q_ASSERT(p_foldersExist.size() == p_config.m_folders.size());
+    Q_ASSERT(p_filesExist.size() == p_config.m_files.size());
+
     QVector<QSharedPointer<Node>> children;
     children.reserve(p_config.m_files.size() + p_config.m_folders.size());
-    const auto basePath = p_node->fetchPath();
 
-    for (const auto &folder : p_config.m_folders) {
+    for (int i = 0; i < p_config.m_folders.size(); ++i) {
+        const auto &folder = p_config.m_folders[i];
         if (folder.m_name.isEmpty()) {
             // Skip empty name node.
             qWarning() << "skipped loading node with empty name under" << p_node->fetchPath();
@@ -343,11 +719,15 @@ void VXNotebookConfigMgr::loadFolderNode(Node *p_node, const NodeConfig &p_confi
                                                          getNotebook(),
                                                          p_node);
         inheritNodeFlags(p_node, folderNode.data());
-        folderNode->setExists(getBackend()->existsDir(PathUtils::concatenateFilePath(basePath, folder.m_name)));
+        folderNode->setExists(p_foldersExist[i]);
+        folderNode->setCachedTimesUtc(folder.m_createdTimeUtc,
+                                      folder.m_modifiedTimeUtc,
+                                      folder.m_latestModifiedTimeUtc);
         children.push_back(folderNode);
     }
 
-    for (const auto &file : p_config.m_files) {
+    for (int i = 0; i < p_config.m_files.size(); ++i) {
+        const auto &file = p_config.m_files[i];
         if (file.m_name.isEmpty()) {
             // Skip empty name node.
             qWarning() << "skipped loading node with empty name under" << p_node->fetchPath();
@@ -363,7 +743,7 @@ void VXNotebookConfigMgr::loadFolderNode(Node *p_node, const NodeConfig &p_confi
                                                        getNotebook(),
                                                        p_node);
         inheritNodeFlags(p_node, fileNode.data());
-        fileNode->setExists(getBackend()->existsFile(PathUtils::concatenateFilePath(basePath, file.m_name)));
+        fileNode->setExists(p_filesExist[i]);
         children.push_back(fileNode);
     }
 
@@ -374,6 +754,26 @@ void VXNotebookConfigMgr::loadFolderNode(Node *p_node, const NodeConfig &p_confi
                              children);
 }
 
+void VXNotebookConfigMgr::checkChildrenExist(const QString &p_path,
+                                             const NodeConfig &p_config,
+                                             QVector<bool> &p_foldersExist,
+                                             QVector<bool> &p_filesExist) const
+{
+    auto backend = getBackend();
+
+    p_foldersExist.resize(p_config.m_folders.size());
+    for (int i = 0; i < p_config.m_folders.size(); ++i) {
+        const auto &name = p_config.m_folders[i].m_name;
+        p_foldersExist[i] = !name.isEmpty() && backend->existsDir(PathUtils::concatenateFilePath(p_path, name));
+    }
+
+    p_filesExist.resize(p_config.m_files.size());
+    for (int i = 0; i < p_config.m_files.size(); ++i) {
+        const auto &name = p_config.m_files[i].m_name;
+        p_filesExist[i] = !name.isEmpty() && backend->existsFile(PathUtils::concatenateFilePath(p_path, name));
+    }
+}
+
 QSharedPointer<Node> VXNotebookConfigMgr::newNode(Node *p_parent,
                                                   Node::Flags p_flags,
                                                   const QString &p_name,
@@ -503,19 +903,14 @@ QSharedPointer<VXNotebookConfigMgr::NodeConfig> VXNotebookConfigMgr::nodeToNodeC
 
     for (const auto &child : p_node->getChildrenRef()) {
         if (child->hasContent()) {
-            NodeFileConfig fileConfig;
-            fileConfig.m_name = child->getName();
-            fileConfig.m_id = child->getId();
-            fileConfig.m_createdTimeUtc = child->getCreatedTimeUtc();
-            fileConfig.m_modifiedTimeUtc = child->getModifiedTimeUtc();
-            fileConfig.m_attachmentFolder = child->getAttachmentFolder();
-            fileConfig.m_tags = child->getTags();
-
-            config->m_files.push_back(fileConfig);
+            config->m_files.push_back(nodeToFileConfig(child.data()));
         } else {
             Q_ASSERT(child->isContainer());
             NodeFolderConfig folderConfig;
             folderConfig.m_name = child->getName();
+            folderConfig.m_createdTimeUtc = child->getCreatedTimeUtc();
+            folderConfig.m_modifiedTimeUtc = child->getModifiedTimeUtc();
+            folderConfig.m_latestModifiedTimeUtc = child->fetchLatestModifiedTimeUtc();
 
             config->m_folders.push_back(folderConfig);
         }
@@ -524,6 +919,19 @@ QSharedPointer<VXNotebookConfigMgr::NodeConfig> VXNotebookConfigMgr::nodeToNodeC
     return config;
 }
 
+VXNotebookConfigMgr::NodeFileConfig VXNotebookConfigMgr::nodeToFileConfig(const Node *p_node) const
+{
+    Q_ASSERT(p_node->hasContent());
+    NodeFileConfig fileConfig;
+    fileConfig.m_name = p_node->getName();
+    fileConfig.m_id = p_node->getId();
+    fileConfig.m_createdTimeUtc = p_node->getCreatedTimeUtc();
+    fileConfig.m_modifiedTimeUtc = p_node->getModifiedTimeUtc();
+    fileConfig.m_attachmentFolder = p_node->getAttachmentFolder();
+    fileConfig.m_tags = p_node->getTags();
+    return fileConfig;
+}
+
 void VXNotebookConfigMgr::loadNode(Node *p_node) const
 {
     if (p_node->isLoaded() || !p_node->exists()) {
@@ -535,13 +943,65 @@ void VXNotebookConfigMgr::loadNode(Node *p_node) const
     loadFolderNode(p_node, *config);
 }
 
+QSharedPointer<NodeLoadData> VXNotebookConfigMgr::readNodeLoadData(const QString &p_path) const
+{
+    // In a worker thread. The snapshot is left to applyNodeLoadData().
+    auto backend = getBackend();
+    if (!backend->existsDir(p_path)) {
+        return nullptr;
+    }
+
+    const auto configPath = PathUtils::concatenateFilePath(p_path, c_nodeConfigName);
+    auto data = QSharedPointer<VXNodeLoadData>::create();
+    data->m_configModifiedTimeUtc = backend->getModifiedTimeUtc(configPath);
+    data->m_configSize = backend->getFileSize(configPath);
+    data->m_configJson = QJsonDocument::fromJson(backend->readFile(configPath)).object();
+    data->m_config.fromJson(data->m_configJson);
+    checkChildrenExist(p_path, data->m_config, data->m_foldersExist, data->m_filesExist);
+    return data;
+}
+
+void VXNotebookConfigMgr::applyNodeLoadData(Node *p_node, const QSharedPointer<NodeLoadData> &p_data) const
+{
+    if (p_node->isLoaded() || !p_node->exists()) {
+        return;
+    }
+
+    auto data = p_data.dynamicCast<VXNodeLoadData>();
+    if (!data || (m_journal && m_journal->hasEntries(getNodeConfigFilePath(p_node)))) {
+        // Read in place to fold the journal.
+        loadNode(p_node);
+        return;
+    }
+
+    auto snapshot = getSnapshot();
+    if (snapshot) {
+        snapshot->updateConfig(getNodeConfigFilePath(p_node),
+                               data->m_configModifiedTimeUtc,
+                               data->m_configSize,
+                               data->m_configJson);
+        m_snapshotSaveTimer->start();
+    }
+
+    Q_ASSERT(p_node->isContainer());
+    loadFolderNode(p_node, data->m_config, data->m_foldersExist, data->m_filesExist);
+}
+
 void VXNotebookConfigMgr::saveNode(const Node *p_node)
 {
     if (p_node->isContainer()) {
         writeNodeConfig(p_node);
     } else {
         Q_ASSERT(!p_node->isRoot());
-        writeNodeConfig(p_node->getParent());
+        if (getJournal()) {
+            appendJournalEntry(NodeConfigJournal::updateChildEntry(getNodeConfigFilePath(p_node->getParent()),
+                                                                   NodeConfig::c_files,
+                                                                   p_node->getName(),
+                                                                   nodeToFileConfig(p_node).toJson()));
+            markLatestModifiedTimeDirty(p_node->getParent());
+        } else {
+            writeNodeConfig(p_node->getParent());
+        }
     }
 }
 
@@ -549,9 +1009,28 @@ void VXNotebookConfigMgr::renameNode(Node *p_node, const QString &p_name)
 {
     Q_ASSERT(!p_node->isRoot());
     if (p_node->isContainer()) {
-        getBackend()->renameDir(p_node->fetchPath(), p_name);
+        // Journal entries of the configs within are keyed by the old path.
+        foldJournal();
+
+        const auto folderPath = p_node->fetchPath();
+        getBackend()->renameDir(folderPath, p_name);
+
+        auto snapshot = getSnapshot();
+        if (snapshot) {
+            snapshot->removeConfigs(folderPath);
+        }
     } else {
         getBackend()->renameFile(p_node->fetchPath(), p_name);
+
+        if (getJournal()) {
+            const auto oldName = p_node->getName();
+            p_node->setName(p_name);
+            appendJournalEntry(NodeConfigJournal::renameChildEntry(getNodeConfigFilePath(p_node->getParent()),
+                                                                   NodeConfig::c_files,
+                                                                   oldName,
+                                                                   p_name));
+            return;
+        }
     }
 
     p_node->setName(p_name);
@@ -607,6 +1086,9 @@ QSharedPointer<Node> VXNotebookConfigMgr::copyNodeAsChildOf(const QSharedPointer
 {
     Q_ASSERT(p_dest->isContainer());
 
+    // Children are copied recursively, writing configs of many folders.
+    FileUtils::DirectorySyncBatch syncBatch;
+
     if (!p_src->exists()) {
         if (p_move) {
             p_src->getNotebook()->removeNode(p_src);
@@ -677,6 +1159,11 @@ QSharedPointer<Node> VXNotebookConfigMgr::copyFolderNodeAsChildOf(const QSharedP
                                                                   Node *p_dest,
                                                                   bool p_move)
 {
+    // Nodes in recycle bin are read-only and should not keep the flag once restored.
+    if (p_move && p_src->getNotebook() == getNotebook() && !p_src->isReadOnly()) {
+        return moveFolderNodeAsChildOf(p_src, p_dest);
+    }
+
     auto srcFolderPath = p_src->fetchAbsolutePath();
     auto destFolderPath = PathUtils::concatenateFilePath(p_dest->fetchPath(),
                                                          PathUtils::fileName(srcFolderPath));
@@ -720,6 +1207,99 @@ QSharedPointer<Node> VXNotebookConfigMgr::copyFolderNodeAsChildOf(const QSharedP
     return destNode;
 }
 
+QSharedPointer<Node> VXNotebookConfigMgr::copyNodeConfigsAsChildOf(const QSharedPointer<Node> &p_src,
+                                                                   Node *p_dest,
+                                                                   const QString &p_name,
+                                                                   bool p_keepIds)
+{
+    Q_ASSERT(p_dest->isContainer());
+
+    FileUtils::DirectorySyncBatch syncBatch;
+
+    auto node = addNodeConfigsAsChildOf(p_src, p_dest, p_name, p_keepIds);
+    writeNodeConfig(p_dest);
+    return node;
+}
+
+QSharedPointer<Node> VXNotebookConfigMgr::addNodeConfigsAsChildOf(const QSharedPointer<Node> &p_src,
+                                                                  Node *p_dest,
+                                                                  const QString &p_name,
+                                                                  bool p_keepIds)
+{
+    auto notebook = getNotebook();
+    const auto id = p_keepIds ? p_src->getId() : notebook->getAndUpdateNextNodeId();
+
+    QSharedPointer<VXNode> destNode;
+    if (p_src->isContainer()) {
+        destNode = QSharedPointer<VXNode>::create(p_name, notebook, p_dest);
+        destNode->loadCompleteInfo(id,
+                                   p_src->getCreatedTimeUtc(),
+                                   p_src->getModifiedTimeUtc(),
+                                   QStringList(),
+                                   QVector<QSharedPointer<Node>>());
+        destNode->setExists(true);
+
+        p_src->load();
+        const auto children = p_src->getChildren();
+        for (const auto &childNode : children) {
+            if (childNode->exists()) {
+                addNodeConfigsAsChildOf(childNode, destNode.data(), childNode->getName(), p_keepIds);
+            }
+        }
+
+        writeNodeConfig(destNode.data());
+    } else {
+        destNode = QSharedPointer<VXNode>::create(id,
+                                                  p_name,
+                                                  p_src->getCreatedTimeUtc(),
+                                                  p_src->getModifiedTimeUtc(),
+                                                  p_src->getTags(),
+                                                  p_src->getAttachmentFolder(),
+                                                  notebook,
+                                                  p_dest);
+        destNode->setExists(getBackend()->existsFile(destNode->fetchPath()));
+    }
+
+    addChildNode(p_dest, destNode);
+    return destNode;
+}
+
+QSharedPointer<Node> VXNotebookConfigMgr::moveFolderNodeAsChildOf(const QSharedPointer<Node> &p_src, Node *p_dest)
+{
+    // Journal entries of the configs within are keyed by the old path.
+    foldJournal();
+
+    auto srcParent = p_src->getParent();
+    Q_ASSERT(srcParent);
+    const auto srcFolderPath = p_src->fetchPath();
+    auto destFolderPath = PathUtils::concatenateFilePath(p_dest->fetchPath(), p_src->getName());
+    destFolderPath = getBackend()->renameIfExistsCaseInsensitive(destFolderPath);
+
+    // A rename on the same file system. Configs are updated only after the files are moved.
+    getBackend()->moveDir(srcFolderPath, destFolderPath);
+
+    srcParent->removeChild(p_src);
+    p_src->setName(PathUtils::fileName(destFolderPath));
+    addChildNode(p_dest, p_src);
+
+    moveNodeConfigs(srcFolderPath, p_src->fetchPath());
+    writeNodeConfig(srcParent);
+    writeNodeConfig(p_dest);
+
+    return p_src;
+}
+
+void VXNotebookConfigMgr::moveNodeConfigs(const QString &p_oldFolderPath, const QString &p_newFolderPath)
+{
+    Q_UNUSED(p_newFolderPath);
+
+    // Entries will be added back on read.
+    auto snapshot = getSnapshot();
+    if (snapshot) {
+        snapshot->removeConfigs(p_oldFolderPath);
+    }
+}
+
 void VXNotebookConfigMgr::removeNode(const QSharedPointer<Node> &p_node, bool p_force, bool p_configOnly)
 {
     auto parentNode = p_node->getParent();
@@ -761,9 +1341,8 @@ void VXNotebookConfigMgr::removeFilesOfNode(Node *p_node, bool p_force)
     } else {
         Q_ASSERT(p_node->getChildrenCount() == 0);
         // Delete node config file and the dir if it is empty.
-        auto configFilePath = getNodeConfigFilePath(p_node);
-        getBackend()->removeFile(configFilePath);
         auto folderPath = p_node->fetchPath();
+        removeNodeConfig(folderPath);
         if (p_force) {
             getBackend()->removeDir(folderPath);
         } else {
@@ -776,6 +1355,22 @@ void VXNotebookConfigMgr::removeFilesOfNode(Node *p_node, bool p_force)
     }
 }
 
+void VXNotebookConfigMgr::removeNodeConfig(const QString &p_folderPath)
+{
+    const auto configPath = PathUtils::concatenateFilePath(p_folderPath, c_nodeConfigName);
+    if (m_journal && m_journal->hasEntries(configPath)) {
+        // Do not replay them on a new folder at the same path.
+        appendJournalEntry(NodeConfigJournal::resetEntry(configPath));
+    }
+
+    getBackend()->removeFile(configPath);
+
+    auto snapshot = getSnapshot();
+    if (snapshot) {
+        snapshot->removeConfigs(p_folderPath);
+    }
+}
+
 QString VXNotebookConfigMgr::fetchNodeImageFolderPath(Node *p_node)
 {
     auto pa = PathUtils::concatenateFilePath(PathUtils::parentDirPath(p_node->fetchAbsolutePath()),
@@ -935,59 +1530,101 @@ QVector<QSharedPointer<ExternalNode>> VXNotebookConfigMgr::fetchExternalChildren
     Q_ASSERT(p_node->isContainer());
     QVector<QSharedPointer<ExternalNode>> externalNodes;
 
-    auto dir = p_node->toDir();
+    const auto &entries = fetchFolderEntries(p_node->fetchAbsolutePath());
+    if (entries.m_folders.isEmpty() && entries.m_files.isEmpty()) {
+        return externalNodes;
+    }
 
-    // Folders.
-    {
-        const auto folders = dir.entryList(QDir::Dirs | QDir::NoSymLinks | QDir::NoDotAndDotDot);
-        for (const auto &folder : folders) {
-            if (isBuiltInFolder(p_node, folder)) {
-                continue;
-            }
+    QSet<QString> containerChildren;
+    QSet<QString> contentChildren;
+    for (const auto &child : p_node->getChildrenRef()) {
+        if (child->isContainer()) {
+            containerChildren.insert(child->getName());
+        } else {
+            contentChildren.insert(child->getName());
+        }
+    }
 
-            if (isExcludedFromExternalNode(folder)) {
-                continue;
-            }
+    // Folders.
+    for (const auto &folder : entries.m_folders) {
+        if (isBuiltInFolder(p_node, folder) || containerChildren.contains(folder)) {
+            continue;
+        }
 
-            if (p_node->containsContainerChild(folder)) {
-                continue;
-            }
+        externalNodes.push_back(QSharedPointer<ExternalNode>::create(p_node, folder, ExternalNode::Type::Folder));
+    }
 
-            externalNodes.push_back(QSharedPointer<ExternalNode>::create(p_node, folder, ExternalNode::Type::Folder));
+    // Files.
+    for (const auto &file : entries.m_files) {
+        if (isBuiltInFile(p_node, file) || contentChildren.contains(file)) {
+            continue;
         }
+
+        externalNodes.push_back(QSharedPointer<ExternalNode>::create(p_node, file, ExternalNode::Type::File));
     }
 
-    // Files.
-    {
-        const auto files = dir.entryList(QDir::Files);
-        for (const auto &file : files) {
-            if (isBuiltInFile(p_node, file)) {
-                continue;
-            }
+    return externalNodes;
+}
 
-            if (isExcludedFromExternalNode(file)) {
-                continue;
-            }
+const VXNotebookConfigMgr::FolderEntries &VXNotebookConfigMgr::fetchFolderEntries(const QString &p_path) const
+{
+    // Changes of entries within a folder always bump its modified time, which is also
+    // what the directory change notifications of the explorer are triggered by.
+    const auto modifiedTimeUtc = QFileInfo(p_path).lastModified().toUTC();
+
+    auto it = m_folderEntriesCache.find(p_path);
+    if (it != m_folderEntriesCache.end()) {
+        // A listing within the same time tick of the modification may miss later
+        // changes in that tick, so it is trusted only if taken well after.
+        if (it->m_modifiedTimeUtc == modifiedTimeUtc
+            && it->m_modifiedTimeUtc.secsTo(it->m_listedTimeUtc) >= 2) {
+            return it.value();
+        }
+    } else {
+        if (m_folderEntriesCache.size() >= 1024) {
+            m_folderEntriesCache.clear();
+        }
+        it = m_folderEntriesCache.insert(p_path, FolderEntries());
+    }
 
-            if (p_node->containsContentChild(file)) {
-                continue;
-            }
+    auto &entries = it.value();
+    entries.m_folders.clear();
+    entries.m_files.clear();
+    entries.m_modifiedTimeUtc = modifiedTimeUtc;
+    entries.m_listedTimeUtc = QDateTime::currentDateTimeUtc();
+
+    // List once for both folders and files.
+    QDirIterator iter(p_path, QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot);
+    while (iter.hasNext()) {
+        iter.next();
+        const auto name = iter.fileName();
+        if (isExcludedFromExternalNode(name)) {
+            continue;
+        }
 
-            externalNodes.push_back(QSharedPointer<ExternalNode>::create(p_node, file, ExternalNode::Type::File));
+        const auto info = iter.fileInfo();
+        if (info.isDir()) {
+            if (!info.isSymLink()) {
+                entries.m_folders << name;
+            }
+        } else {
+            entries.m_files << name;
         }
     }
 
-    return externalNodes;
+    // Keep the order of QDir::entryList().
+    entries.m_folders.sort(Qt::CaseInsensitive);
+    entries.m_files.sort(Qt::CaseInsensitive);
+
+    return entries;
 }
 
 bool VXNotebookConfigMgr::isExcludedFromExternalNode(const QString &p_name) const
 {
-    for (const auto &regExp : s_externalNodeExcludePatterns) {
-        if (regExp.exactMatch(p_name)) {
-            return true;
-        }
+    if (s_externalNodeExcludeRegExp.pattern().isEmpty()) {
+        return false;
     }
-    return false;
+    return s_externalNodeExcludeRegExp.match(p_name).hasMatch();
 }
 
 bool VXNotebookConfigMgr::checkNodeExists(Node *p_node)
@@ -5,14 +5,21 @@
 
 #include <QDateTime>
 #include <QVector>
-#include <QRegExp>
+#include <QRegularExpression>
+#include <QHash>
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <QJsonObject>
 
 #include "../global.h"
 
-class QJsonObject;
+class QTimer;
 
 namespace vnotex
 {
+    class NodeConfigSnapshot;
+    class NodeConfigJournal;
+
     // Config manager for VNoteX's bundle notebook.
     class VXNotebookConfigMgr : public BundleNotebookConfigMgr
     {
@@ -24,6 +31,8 @@ namespace vnotex
                                      const QSharedPointer<INotebookBackend> &p_backend,
                                      QObject *p_parent = nullptr);
 
+        ~VXNotebookConfigMgr();
+
         QString getName() const Q_DECL_OVERRIDE;
 
         QString getDisplayName() const Q_DECL_OVERRIDE;
@@ -37,6 +46,10 @@ namespace vnotex
         void loadNode(Node *p_node) const Q_DECL_OVERRIDE;
         void saveNode(const Node *p_node) Q_DECL_OVERRIDE;
 
+        QSharedPointer<NodeLoadData> readNodeLoadData(const QString &p_path) const Q_DECL_OVERRIDE;
+
+        void applyNodeLoadData(Node *p_node, const QSharedPointer<NodeLoadData> &p_data) const Q_DECL_OVERRIDE;
+
         void renameNode(Node *p_node, const QString &p_name) Q_DECL_OVERRIDE;
 
         QSharedPointer<Node> newNode(Node *p_parent,
@@ -60,6 +73,11 @@ namespace vnotex
                                                Node *p_dest,
                                                bool p_move) Q_DECL_OVERRIDE;
 
+        QSharedPointer<Node> copyNodeConfigsAsChildOf(const QSharedPointer<Node> &p_src,
+                                                      Node *p_dest,
+                                                      const QString &p_name,
+                                                      bool p_keepIds) Q_DECL_OVERRIDE;
+
         void removeNode(const QSharedPointer<Node> &p_node, bool p_force = false, bool p_configOnly = false) Q_DECL_OVERRIDE;
 
         bool isBuiltInFile(const Node *p_node, const QString &p_name) const Q_DECL_OVERRIDE;
@@ -74,7 +92,7 @@ namespace vnotex
 
         bool checkNodeExists(Node *p_node) Q_DECL_OVERRIDE;
 
-    private:
+    protected:
         // Config of a file child.
         struct NodeFileConfig
         {
@@ -98,6 +116,14 @@ namespace vnotex
             void fromJson(const QJsonObject &p_jobj);
 
             QString m_name;
+
+            // Cached times of the folder to sort it without loading.
+            // Invalid if written by older versions.
+            QDateTime m_createdTimeUtc;
+            QDateTime m_modifiedTimeUtc;
+
+            // Latest modified time of the folder and its descendants when the config is written.
+            QDateTime m_latestModifiedTimeUtc;
         };
 
         // Config of a folder node.
@@ -138,21 +164,113 @@ namespace vnotex
             static const QString c_attachmentFolder;
 
             static const QString c_tags;
+
+            static const QString c_latestModifiedTimeUtc;
+        };
+
+        // Storage of node configs. Subclasses could store the configs elsewhere.
+        // @p_path: folder path of the node.
+        virtual QSharedPointer<VXNotebookConfigMgr::NodeConfig> readNodeConfig(const QString &p_path) const;
+
+        // @p_path: path of the config file of the node.
+        virtual void writeNodeConfig(const QString &p_path, const NodeConfig &p_config) const;
+
+        // Remove the config of folder @p_folderPath.
+        virtual void removeNodeConfig(const QString &p_folderPath);
+
+        // Configs of folder @p_oldFolderPath and its descendants are moved to @p_newFolderPath
+        // along with the files.
+        virtual void moveNodeConfigs(const QString &p_oldFolderPath, const QString &p_newFolderPath);
+
+        // Whether metadata updates could be recorded in the journal and folded into
+        // the configs via readNodeConfig() and writeNodeConfig() later.
+        virtual bool isJournalSupported() const;
+
+        // Name of the node's config file.
+        static const QString c_nodeConfigName;
+
+    private:
+        // Data read in a worker thread to load a folder node.
+        struct VXNodeLoadData : public NodeLoadData
+        {
+            NodeConfig m_config;
+
+            // Used to update the snapshot in the main thread.
+            QJsonObject m_configJson;
+
+            QDateTime m_configModifiedTimeUtc;
+
+            qint64 m_configSize = -1;
+
+            QVector<bool> m_foldersExist;
+
+            QVector<bool> m_filesExist;
         };
 
         void createEmptyRootNode();
 
-        QSharedPointer<VXNotebookConfigMgr::NodeConfig> readNodeConfig(const QString &p_path) const;
-        void writeNodeConfig(const QString &p_path, const NodeConfig &p_config) const;
+        // Read config @p_configPath with its journal entries folded.
+        QJsonObject readNodeConfigJson(const QString &p_configPath) const;
+
+        // Read config file @p_configPath via the snapshot if it is up to date.
+        QJsonObject readNodeConfigFileJson(const QString &p_configPath) const;
+
+        // Return nullptr if snapshot is disabled.
+        NodeConfigSnapshot *getSnapshot() const;
+
+        void saveSnapshot() const;
+
+        QString getSnapshotFilePath() const;
 
         void writeNodeConfig(const Node *p_node);
 
+        // Latest modified time of @p_folder and its ancestors, kept in the configs of their
+        // parents, may change. Update them in batch.
+        void markLatestModifiedTimeDirty(const Node *p_folder);
+
+        void updateLatestModifiedTimes();
+
+        // Return nullptr if journal is disabled.
+        // Journal file left by last session is loaded on first access.
+        NodeConfigJournal *getJournal() const;
+
+        QString getJournalFilePath() const;
+
+        void appendJournalEntry(const QJsonObject &p_entry);
+
+        // Fold all the journal entries into configs and remove the journal file.
+        // Entries failed to fold are kept in the journal to retry later.
+        void foldJournal() const;
+
+        // foldJournal() logging instead of throwing, for destructor and timer.
+        void tryFoldJournal() const;
+
+        // Fold journal entries of config @p_configPath.
+        // @p_markFolded: whether record in the journal file that they are folded.
+        // Return false if the entries are kept in the journal since the config fails to write.
+        bool foldJournalEntries(const QString &p_configPath, bool p_markFolded) const;
+
+        NodeFileConfig nodeToFileConfig(const Node *p_node) const;
+
         QSharedPointer<Node> nodeConfigToNode(const NodeConfig &p_config,
                                               const QString &p_name,
                                               Node *p_parent = nullptr) const;
 
         void loadFolderNode(Node *p_node, const NodeConfig &p_config) const;
 
+        // @p_foldersExist and @p_filesExist: existence of children in @p_config.
+        void loadFolderNode(Node *p_node,
+                            const NodeConfig &p_config,
+                            const QVector<bool> &p_foldersExist,
+                            const QVector<bool> &p_filesExist) const;
+
+        // Check existence of children in @p_config of folder @p_path.
+        // Safe to call in a worker thread.
+        void checkChildrenExist(const QString &p_path,
+                                const NodeConfig &p_config,
+                                QVector<bool> &p_foldersExist,
+                                QVector<bool> &p_filesExist) const;
+
         QSharedPointer<VXNotebookConfigMgr::NodeConfig> nodeToNodeConfig(const Node *p_node) const;
 
         QSharedPointer<Node> newFileNode(Node *p_parent,
@@ -174,6 +292,15 @@ namespace vnotex
 
         QSharedPointer<Node> copyFolderNodeAsChildOf(const QSharedPointer<Node> &p_src, Node *p_dest, bool p_move);
 
+        // Add nodes of @p_src to @p_dest without writing the config of @p_dest.
+        QSharedPointer<Node> addNodeConfigsAsChildOf(const QSharedPointer<Node> &p_src,
+                                                     Node *p_dest,
+                                                     const QString &p_name,
+                                                     bool p_keepIds);
+
+        // Move folder node @p_src within the notebook by renaming the folder.
+        QSharedPointer<Node> moveFolderNodeAsChildOf(const QSharedPointer<Node> &p_src, Node *p_dest);
+
         QSharedPointer<Node> copyFileAsChildOf(const QString &p_srcPath, Node *p_dest);
 
         QSharedPointer<Node> copyFolderAsChildOf(const QString &p_srcPath, Node *p_dest);
@@ -195,17 +322,70 @@ namespace vnotex
 
         bool isExcludedFromExternalNode(const QString &p_name) const;
 
+        // Entries of a folder on disk which are not excluded by patterns.
+        struct FolderEntries
+        {
+            QStringList m_folders;
+
+            QStringList m_files;
+
+            // Modified time of the folder when listed.
+            QDateTime m_modifiedTimeUtc;
+
+            // Time of the listing.
+            QDateTime m_listedTimeUtc;
+        };
+
+        // Return cached entries of folder @p_path if it is not modified since listed.
+        const FolderEntries &fetchFolderEntries(const QString &p_path) const;
+
         Info m_info;
 
+        // Folder entries cache of fetchExternalChildren() keyed by absolute path.
+        mutable QHash<QString, FolderEntries> m_folderEntriesCache;
+
+        // Loaded lazily on first config read.
+        mutable QScopedPointer<NodeConfigSnapshot> m_snapshot;
+
+        mutable bool m_snapshotLoaded = false;
+
+        // Timer to save the snapshot in batch.
+        QTimer *m_snapshotSaveTimer = nullptr;
+
+        // Loaded lazily on first access.
+        mutable QScopedPointer<NodeConfigJournal> m_journal;
+
+        // Timer to fold the journal in batch.
+        QTimer *m_journalFoldTimer = nullptr;
+
+        // Folders whose latest modified time in the parent config may be stale.
+        QHash<const Node *, QWeakPointer<const Node>> m_latestModifiedTimeDirtyFolders;
+
+        // Timer to update latest modified time of folders in batch.
+        QTimer *m_latestModifiedTimeTimer = nullptr;
+
+        bool m_updatingLatestModifiedTimes = false;
+
         static bool s_initialized;
 
-        static QVector<QRegExp> s_externalNodeExcludePatterns;
+        static bool s_snapshotEnabled;
 
-        // Name of the node's config file.
-        static const QString c_nodeConfigName;
+        static bool s_journalEnabled;
+
+        // All exclude patterns combined into one expression.
+        static QRegularExpression s_externalNodeExcludeRegExp;
 
         // Name of the recycle bin folder which should be a child of the root node.
         static const QString c_recycleBinFolderName;
+
+        // Name of the snapshot file within the local notebook cache folder.
+        static const QString c_snapshotFileName;
+
+        // Name of the journal file within the local notebook cache folder.
+        static const QString c_journalFileName;
+
+        // Fold the journal once it reaches this many entries.
+        static const int c_maxJournalEntries;
     };
 } // ns vnotex
 
@@ -1,8 +1,15 @@
 #include "notebookmgr.h"
 
+#include <QTimer>
+#include <QtConcurrent>
+#include <QFutureWatcher>
+
+#include <limits>
+
 #include <versioncontroller/dummyversioncontrollerfactory.h>
 #include <versioncontroller/iversioncontroller.h>
 #include <notebookconfigmgr/vxnotebookconfigmgrfactory.h>
+#include <notebookconfigmgr/sqlitenotebookconfigmgrfactory.h>
 #include <notebookconfigmgr/inotebookconfigmgr.h>
 #include <notebookbackend/localnotebookbackendfactory.h>
 #include <notebookbackend/inotebookbackend.h>
@@ -15,6 +22,9 @@
 
 using namespace vnotex;
 
+// Delay before probing pending notebooks to let the UI show up first.
+static const int c_openPendingNotebookInterval = 200;
+
 NotebookMgr::NotebookMgr(QObject *p_parent)
     : QObject(p_parent),
       m_currentNotebookId(Notebook::InvalidId)
@@ -49,6 +59,9 @@ void NotebookMgr::initConfigMgrServer()
     auto vxFactory = QSharedPointer<VXNotebookConfigMgrFactory>::create();
     m_configMgrServer->registerItem(vxFactory->getName(), vxFactory);
 
+    // SQLite Notebook Config Manager.
+    auto sqliteFactory = QSharedPointer<SqliteNotebookConfigMgrFactory>::create();
+    m_configMgrServer->registerItem(sqliteFactory->getName(), sqliteFactory);
 }
 
 void NotebookMgr::initBackendServer()
@@ -140,6 +153,124 @@ void NotebookMgr::loadNotebooks()
     readNotebooksFromConfig();
 
     loadCurrentNotebookId();
+
+    QTimer::singleShot(c_openPendingNotebookInterval, this, &NotebookMgr::probePendingNotebooks);
+}
+
+void NotebookMgr::openPendingNotebooks(const QString &p_path)
+{
+    bool opened = false;
+    for (int i = 0; i < m_pendingNotebookItems.size();) {
+        if (!p_path.isEmpty()
+            && !PathUtils::pathContains(PathUtils::absolutePath(m_pendingNotebookItems[i].m_rootFolderPath), p_path)) {
+            ++i;
+            continue;
+        }
+
+        const auto item = m_pendingNotebookItems.takeAt(i);
+        if (openNotebook(item)) {
+            opened = true;
+        }
+    }
+
+    if (opened) {
+        emit notebooksUpdated();
+    }
+}
+
+bool NotebookMgr::openNotebook(const SessionConfig::NotebookItem &p_item)
+{
+    try {
+        auto nb = readNotebookFromConfig(p_item);
+        addNotebook(nb);
+        return true;
+    } catch (Exception &p_e) {
+        qCritical("failed to read notebook (%s) from config (%s)",
+                  p_item.m_rootFolderPath.toStdString().c_str(),
+                  p_e.what());
+        return false;
+    }
+}
+
+// Probes may hang on an offline volume. Keep them off the I/O pool used by notebooks.
+static QThreadPool *getProbeThreadPool()
+{
+    static QThreadPool *s_pool = []() {
+        // Never deleted, so that a hung probe does not block the exit.
+        auto pool = new QThreadPool();
+        pool->setMaxThreadCount(16);
+        return pool;
+    }();
+    return s_pool;
+}
+
+void NotebookMgr::probePendingNotebooks()
+{
+    for (const auto &item : m_pendingNotebookItems) {
+        if (m_probingRootFolderPaths.contains(item.m_rootFolderPath)) {
+            continue;
+        }
+
+        auto factory = m_notebookServer->getItem(item.m_type);
+        QSharedPointer<INotebookBackend> backend;
+        if (factory && m_backendServer->getItem(item.m_backend)) {
+            backend = createNotebookBackend(item.m_backend, item.m_rootFolderPath);
+        }
+
+        // Probed in parallel so that a hung one does not hold back the others.
+        m_probingRootFolderPaths.insert(item.m_rootFolderPath);
+        auto watcher = new QFutureWatcher<bool>(this);
+        connect(watcher, &QFutureWatcher<bool>::finished,
+                this, [this, watcher, rootFolderPath = item.m_rootFolderPath]() {
+                    finishPendingNotebookProbe(rootFolderPath, watcher->result());
+                    watcher->deleteLater();
+                });
+        watcher->setFuture(QtConcurrent::run(getProbeThreadPool(), [factory, backend]() {
+            // Let openNotebook() report the error.
+            return !backend || factory->checkRootFolder(backend);
+        }));
+    }
+}
+
+void NotebookMgr::finishPendingNotebookProbe(const QString &p_rootFolderPath, bool p_valid)
+{
+    m_probingRootFolderPaths.remove(p_rootFolderPath);
+
+    // It may have been opened on demand meanwhile.
+    auto it = std::find_if(m_pendingNotebookItems.begin(),
+                           m_pendingNotebookItems.end(),
+                           [&p_rootFolderPath](const SessionConfig::NotebookItem &p_item) {
+                               return p_item.m_rootFolderPath == p_rootFolderPath;
+                           });
+    if (it != m_pendingNotebookItems.end()) {
+        const auto item = *it;
+        m_pendingNotebookItems.erase(it);
+        if (!p_valid) {
+            qCritical() << "failed to open notebook with invalid root folder" << item.m_rootFolderPath;
+        } else if (openNotebook(item)) {
+            emit notebooksUpdated();
+        }
+    }
+}
+
+QStringList NotebookMgr::getPendingNotebookRootFolderPaths() const
+{
+    QStringList paths;
+    for (const auto &item : m_pendingNotebookItems) {
+        paths << item.m_rootFolderPath;
+    }
+    return paths;
+}
+
+int NotebookMgr::getSessionOrder(const QString &p_rootFolderPath) const
+{
+    for (int i = 0; i < m_sessionNotebookOrder.size(); ++i) {
+        if (PathUtils::areSamePaths(m_sessionNotebookOrder[i], p_rootFolderPath)) {
+            return i;
+        }
+    }
+
+    return -1;
 }
 
 static SessionConfig &getSessionConfig()
@@ -208,26 +339,37 @@ static SessionConfig::NotebookItem notebookToSessionConfig(const QSharedPointer<
 void NotebookMgr::saveNotebooksToConfig() const
 {
     QVector<SessionConfig::NotebookItem> items;
-    items.reserve(m_notebooks.size());
+    items.reserve(m_notebooks.size() + m_pendingNotebookItems.size());
     for (auto &nb : m_notebooks) {
         items.push_back(notebookToSessionConfig(nb));
     }
 
+    // Keep pending notebooks in their original places.
+    items.append(m_pendingNotebookItems);
+    auto orderOf = [this](const SessionConfig::NotebookItem &p_item) {
+        const int order = getSessionOrder(p_item.m_rootFolderPath);
+        return order == -1 ? std::numeric_limits<int>::max() : order;
+    };
+    std::stable_sort(items.begin(),
+                     items.end(),
+                     [&orderOf](const SessionConfig::NotebookItem &p_a, const SessionConfig::NotebookItem &p_b) {
+                         return orderOf(p_a) < orderOf(p_b);
+                     });
+
     getSessionConfig().setNotebooks(items);
 }
 
 void NotebookMgr::readNotebooksFromConfig()
 {
     Q_ASSERT(m_notebooks.isEmpty());
-    auto items = getSessionConfig().getNotebooks();
-    for (auto &item : items) {
-        try {
-            auto nb = readNotebookFromConfig(item);
-            addNotebook(nb);
-        } catch (Exception &p_e) {
-            qCritical("failed to read notebook (%s) from config (%s)",
-                      item.m_rootFolderPath.toStdString().c_str(),
-                      p_e.what());
+    const auto items = getSessionConfig().getNotebooks();
+    const auto currentRootFolderPath = getSessionConfig().getCurrentNotebookRootFolderPath();
+    for (const auto &item : items) {
+        m_sessionNotebookOrder << item.m_rootFolderPath;
+        if (PathUtils::areSamePaths(item.m_rootFolderPath, currentRootFolderPath)) {
+            openNotebook(item);
+        } else {
+            m_pendingNotebookItems.push_back(item);
         }
     }
 
@@ -274,8 +416,12 @@ void NotebookMgr::setCurrentNotebook(ID p_notebookId)
     getSessionConfig().setCurrentNotebookRootFolderPath(nb ? nb->getRootFolderPath() : "");
 }
 
-QSharedPointer<Notebook> NotebookMgr::findNotebookByRootFolderPath(const QString &p_rootFolderPath) const
+QSharedPointer<Notebook> NotebookMgr::findNotebookByRootFolderPath(const QString &p_rootFolderPath)
 {
+    if (!p_rootFolderPath.isEmpty()) {
+        openPendingNotebooks(PathUtils::absolutePath(p_rootFolderPath));
+    }
+
     for (auto &nb : m_notebooks) {
         if (PathUtils::areSamePaths(nb->getRootFolderPath(), p_rootFolderPath)) {
             return nb;
@@ -368,9 +514,25 @@ void NotebookMgr::setCurrentNotebookAfterUpdate()
 
 void NotebookMgr::addNotebook(const QSharedPointer<Notebook> &p_notebook)
 {
-    m_notebooks.push_back(p_notebook);
+    // Notebooks opened later still follow the order of session.
+    int idx = m_notebooks.size();
+    const int order = getSessionOrder(p_notebook->getRootFolderPath());
+    if (order != -1) {
+        for (int i = 0; i < m_notebooks.size(); ++i) {
+            const int curOrder = getSessionOrder(m_notebooks[i]->getRootFolderPath());
+            if (curOrder == -1 || curOrder > order) {
+                idx = i;
+                break;
+            }
+        }
+    }
+    m_notebooks.insert(idx, p_notebook);
     connect(p_notebook.data(), &Notebook::updated,
             this, [this, notebook = p_notebook.data()]() {
                 emit notebookUpdated(notebook);
             });
+    connect(p_notebook.data(), &Notebook::noteLinksRewriteRequested,
+            this, &NotebookMgr::noteLinksRewriteRequested);
+    connect(p_notebook.data(), &Notebook::nodePathChanged,
+            this, &NotebookMgr::nodePathChanged);
 }
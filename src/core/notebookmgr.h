@@ -5,6 +5,8 @@
 #include <QScopedPointer>
 #include <QList>
 #include <QVector>
+#include <QStringList>
+#include <QSet>
 
 #include "namebasedserver.h"
 #include "sessionconfig.h"
@@ -48,8 +50,16 @@ namespace vnotex
         QSharedPointer<INotebookConfigMgr> createNotebookConfigMgr(const QString &p_mgrName,
                                                                    const QSharedPointer<INotebookBackend> &p_backend) const;
 
+        // Open the current notebook of session. Others are opened one by one later.
         void loadNotebooks();
 
+        // Open notebooks of session not opened yet.
+        // @p_path: if not empty, only open those containing @p_path.
+        void openPendingNotebooks(const QString &p_path = QString());
+
+        // Root folders of notebooks of session not opened yet.
+        QStringList getPendingNotebookRootFolderPaths() const;
+
         QSharedPointer<Notebook> newNotebook(const QSharedPointer<NotebookParameters> &p_parameters);
 
         void importNotebook(const QSharedPointer<Notebook> &p_notebook);
@@ -59,7 +69,8 @@ namespace vnotex
         ID getCurrentNotebookId() const;
 
         // Find the notebook with the same directory as root folder.
-        QSharedPointer<Notebook> findNotebookByRootFolderPath(const QString &p_rootFolderPath) const;
+        // Open it if it is still pending.
+        QSharedPointer<Notebook> findNotebookByRootFolderPath(const QString &p_rootFolderPath);
 
         QSharedPointer<Notebook> findNotebookById(ID p_id) const;
 
@@ -77,6 +88,14 @@ namespace vnotex
 
         void notebookAboutToClose(const Notebook *p_notebook);
 
+        // Forwarded from Notebook::noteLinksRewriteRequested() of all notebooks.
+        void noteLinksRewriteRequested(const QString &p_filePath,
+                                       const std::function<QString(const QString &)> &p_rewrite,
+                                       const QSharedPointer<Event> &p_event);
+
+        // Forwarded from Notebook::nodePathChanged() of all notebooks.
+        void nodePathChanged(const QString &p_oldPath, const QString &p_newPath);
+
         void notebookAboutToRemove(const Notebook *p_notebook);
 
         void currentNotebookChanged(const QSharedPointer<Notebook> &p_notebook);
@@ -97,6 +116,18 @@ namespace vnotex
 
         QSharedPointer<Notebook> readNotebookFromConfig(const SessionConfig::NotebookItem &p_item);
 
+        // Return true if the notebook is opened and added.
+        bool openNotebook(const SessionConfig::NotebookItem &p_item);
+
+        // Probe the root folders of pending notebooks in background so that a slow
+        // or offline volume does not block, then open them.
+        void probePendingNotebooks();
+
+        void finishPendingNotebookProbe(const QString &p_rootFolderPath, bool p_valid);
+
+        // Return -1 if @p_rootFolderPath is not in the session.
+        int getSessionOrder(const QString &p_rootFolderPath) const;
+
         void setCurrentNotebookAfterUpdate();
 
         void addNotebook(const QSharedPointer<Notebook> &p_notebook);
@@ -111,6 +142,15 @@ namespace vnotex
 
         QVector<QSharedPointer<Notebook>> m_notebooks;
 
+        // Notebooks of session not opened yet.
+        QVector<SessionConfig::NotebookItem> m_pendingNotebookItems;
+
+        // Root folders of notebooks of session, to keep their order.
+        QStringList m_sessionNotebookOrder;
+
+        // Root folders of pending notebooks being probed.
+        QSet<QString> m_probingRootFolderPaths;
+
         ID m_currentNotebookId = 0;
     };
 } // ns vnotex
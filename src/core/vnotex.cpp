@@ -6,6 +6,8 @@
 #include <widgets/mainwindow.h>
 #include "notebookmgr.h"
 #include "buffermgr.h"
+#include "filewatcher.h"
+#include "fileoperationqueue.h"
 #include "configmgr.h"
 #include "coreconfig.h"
 #include "location.h"
@@ -29,6 +31,10 @@ VNoteX::VNoteX(QObject *p_parent)
 
     initNotebookMgr();
 
+    initFileWatcher();
+
+    initFileOperationQueue();
+
     initBufferMgr();
 
     initDocsUtils();
@@ -79,6 +85,28 @@ void VNoteX::initNotebookMgr()
     m_notebookMgr->init();
 }
 
+void VNoteX::initFileWatcher()
+{
+    Q_ASSERT(!m_fileWatcher);
+    m_fileWatcher = new FileWatcher(this);
+}
+
+FileWatcher &VNoteX::getFileWatcher() const
+{
+    return *m_fileWatcher;
+}
+
+void VNoteX::initFileOperationQueue()
+{
+    Q_ASSERT(!m_fileOperationQueue);
+    m_fileOperationQueue = new FileOperationQueue(this);
+}
+
+FileOperationQueue &VNoteX::getFileOperationQueue() const
+{
+    return *m_fileOperationQueue;
+}
+
 void VNoteX::initBufferMgr()
 {
     Q_ASSERT(!m_bufferMgr);
@@ -90,6 +118,11 @@ void VNoteX::initBufferMgr()
 
     connect(this, &VNoteX::openFileRequested,
             m_bufferMgr, QOverload<const QString &, const QSharedPointer<FileOpenParameters> &>::of(&BufferMgr::open));
+
+    connect(m_notebookMgr, &NotebookMgr::noteLinksRewriteRequested,
+            m_bufferMgr, &BufferMgr::rewriteNoteLinks);
+    connect(m_notebookMgr, &NotebookMgr::nodePathChanged,
+            m_bufferMgr, &BufferMgr::updateBufferPathsUnder);
 }
 
 NotebookMgr &VNoteX::getNotebookMgr() const
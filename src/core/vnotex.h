@@ -13,6 +13,8 @@ namespace vnotex
     class MainWindow;
     class NotebookMgr;
     class BufferMgr;
+    class FileWatcher;
+    class FileOperationQueue;
     class Node;
     struct FileOpenParameters;
     class Event;
@@ -42,6 +44,10 @@ namespace vnotex
 
         BufferMgr &getBufferMgr() const;
 
+        FileWatcher &getFileWatcher() const;
+
+        FileOperationQueue &getFileOperationQueue() const;
+
         ID getInstanceId() const;
 
     public slots:
@@ -114,6 +120,10 @@ namespace vnotex
 
         void initNotebookMgr();
 
+        void initFileWatcher();
+
+        void initFileOperationQueue();
+
         void initBufferMgr();
 
         void initDocsUtils();
@@ -128,6 +138,12 @@ namespace vnotex
         // QObject managed.
         NotebookMgr *m_notebookMgr;
 
+        // QObject managed.
+        FileWatcher *m_fileWatcher = nullptr;
+
+        // QObject managed.
+        FileOperationQueue *m_fileOperationQueue = nullptr;
+
         // QObject managed.
         BufferMgr *m_bufferMgr;
 
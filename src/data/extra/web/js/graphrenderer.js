@@ -22,7 +22,10 @@ class GraphRenderer extends VxWorker {
     }
 
     reset() {
-        this.graphIdx = 0;
+        // Graphs kept from last render still hold their indexes.
+        if (!this.vnotex.getWorker('markdownit').hasReusedNodes()) {
+            this.graphIdx = 0;
+        }
         this.nodesToRender = [];
         this.numOfRenderedNodes = 0;
     }
@@ -112,6 +112,17 @@ class MarkdownIt extends VxWorker {
         // Pre nodes collection.
         this.preNodes = null;
 
+        // Keys of top level blocks of last render in lastContainerNode, which are the raw
+        // HTML without source line numbers. Used to patch only the changed blocks.
+        this.blockKeys = null;
+
+        // Top level nodes kept from last render, which other workers could skip.
+        this.reusedNodes = new Set();
+
+        // Selectors of rendered nodes which need a full render once present,
+        // such as numbered equations.
+        this.fullRenderSelectors = [];
+
         this.codeNodesStore = new CodeNodeStoreByLang();
 
         this.codeNodesCollected = false;
@@ -260,17 +271,28 @@ class MarkdownIt extends VxWorker {
         if (p_node != this.lastContainerNode) {
             this.lastContainerNode = p_node;
             this.preNodes = null;
+            this.blockKeys = null;
         }
 
+        this.reusedNodes.clear();
+
         if (!p_text) {
             p_node.innerHTML = '';
+            this.blockKeys = null;
             this.finishWork();
             this.markdownRenderFinished();
             return;
         }
 
         let html = this.mdit.render(p_text);
-        p_node.innerHTML = html + this.loadedGuard(p_finishCbStr);
+        let blocks = this.parseBlocks(html);
+        if (blocks && this.canPatch(p_node, blocks)) {
+            this.patchBlocks(p_node, blocks);
+            p_node.insertAdjacentHTML('beforeend', this.loadedGuard(p_finishCbStr));
+        } else {
+            p_node.innerHTML = html + this.loadedGuard(p_finishCbStr);
+        }
+        this.blockKeys = blocks && !this.frontMatterNode ? blocks.keys : null;
 
         if (this.preNodes == null) {
             this.preNodes = p_node.getElementsByTagName('pre');
@@ -289,7 +311,126 @@ class MarkdownIt extends VxWorker {
         }
         // Add 1x1 transparent GIF image at the end to monitor the load process.
         return '<img src="data:image/gif;base64,R0lGODlhAQABAIAAAP///wAAACH5BAEAAAAALAAAAAABAAEAAAICRAEAOw==" onload="'
-               + p_cbStr + ' this.parentNode.removeChild(this);">';
+               + p_cbStr + ' this.remove();" class="vx-loaded-guard">';
+    }
+
+    // Split rendered @p_html into top level element nodes with their keys.
+    // Return null if there is top level text which could not be patched by elements.
+    parseBlocks(p_html) {
+        let tpl = document.createElement('template');
+        tpl.innerHTML = p_html;
+
+        let nodes = [];
+        let keys = [];
+        for (let node of Array.from(tpl.content.childNodes)) {
+            if (node.nodeType == Node.ELEMENT_NODE) {
+                nodes.push(node);
+                keys.push(MarkdownIt.blockKey(node));
+            } else if (node.nodeType != Node.TEXT_NODE || node.textContent.trim()) {
+                return null;
+            }
+        }
+        return { nodes: nodes, keys: keys };
+    }
+
+    static blockKey(p_node) {
+        return p_node.outerHTML.replace(/ data-source-line="\d+"/g, '');
+    }
+
+    canPatch(p_node, p_blocks) {
+        if (!this.blockKeys || this.frontMatterNode) {
+            return false;
+        }
+
+        // Drop the guard of last render if the new round starts within its callback.
+        p_node.querySelectorAll(':scope > .vx-loaded-guard').forEach((p_guard) => {
+            p_guard.remove();
+        });
+
+        if (p_node.children.length != this.blockKeys.length) {
+            return false;
+        }
+
+        if (this.fullRenderSelectors.length > 0
+            && p_node.querySelector(this.fullRenderSelectors.join(','))) {
+            return false;
+        }
+
+        return true;
+    }
+
+    // Keep the unchanged top level blocks of @p_node and replace the others by @p_blocks.
+    patchBlocks(p_node, p_blocks) {
+        let oldNodes = Array.from(p_node.children);
+        let oldKeys = this.blockKeys;
+        let newKeys = p_blocks.keys;
+        let minLen = Math.min(oldKeys.length, newKeys.length);
+
+        let prefix = 0;
+        while (prefix < minLen && oldKeys[prefix] === newKeys[prefix]) {
+            ++prefix;
+        }
+
+        let suffix = 0;
+        while (suffix < minLen - prefix
+               && oldKeys[oldKeys.length - 1 - suffix] === newKeys[newKeys.length - 1 - suffix]) {
+            ++suffix;
+        }
+
+        for (let i = 0; i < prefix; ++i) {
+            this.reuseNode(oldNodes[i], p_blocks.nodes[i]);
+        }
+        for (let i = 1; i <= suffix; ++i) {
+            this.reuseNode(oldNodes[oldNodes.length - i], p_blocks.nodes[newKeys.length - i]);
+        }
+
+        for (let i = prefix; i < oldNodes.length - suffix; ++i) {
+            oldNodes[i].remove();
+        }
+
+        let fragment = document.createDocumentFragment();
+        for (let i = prefix; i < newKeys.length - suffix; ++i) {
+            fragment.appendChild(document.adoptNode(p_blocks.nodes[i]));
+        }
+        p_node.insertBefore(fragment, suffix > 0 ? oldNodes[oldNodes.length - suffix] : null);
+    }
+
+    // Keep @p_node in place of @p_newNode, which may have different source line numbers.
+    reuseNode(p_node, p_newNode) {
+        this.reusedNodes.add(p_node);
+
+        let oldLine = p_node.getAttribute('data-source-line');
+        let newLine = p_newNode.getAttribute('data-source-line');
+        if (oldLine === null || newLine === null || oldLine === newLine) {
+            return;
+        }
+
+        let delta = parseInt(newLine) - parseInt(oldLine);
+        let shift = (p_ele) => {
+            p_ele.setAttribute('data-source-line', parseInt(p_ele.getAttribute('data-source-line')) + delta);
+        };
+        shift(p_node);
+        p_node.querySelectorAll('[data-source-line]').forEach(shift);
+    }
+
+    // Whether @p_node is within a top level node kept from last render.
+    isReused(p_node) {
+        if (this.reusedNodes.size == 0) {
+            return false;
+        }
+
+        while (p_node && p_node.parentNode != this.lastContainerNode) {
+            p_node = p_node.parentNode;
+        }
+        return !!p_node && this.reusedNodes.has(p_node);
+    }
+
+    hasReusedNodes() {
+        return this.reusedNodes.size > 0;
+    }
+
+    addFullRenderSelector(p_selector) {
+        this.fullRenderSelectors.push(p_selector);
     }
 
     addLangsToSkipHighlight(p_langs) {
@@ -315,7 +456,9 @@ class MarkdownIt extends VxWorker {
             // Collect code nodes.
             this.codeNodesCollected = true;
             for (let i = 0; i < this.preNodes.length; ++i) {
-                this.codeNodesStore.addNode(this.preNodes[i].firstElementChild);
+                if (!this.isReused(this.preNodes[i])) {
+                    this.codeNodesStore.addNode(this.preNodes[i].firstElementChild);
+                }
             }
         }
 
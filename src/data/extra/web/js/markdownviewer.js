@@ -7,8 +7,16 @@ new QWebChannel(qt.webChannelTransport,
         window.vxMarkdownAdapter = adapter;
 
         // Connect signals from CPP side.
-        adapter.textUpdated.connect(function(p_text) {
-            window.vnotex.setMarkdownText(p_text);
+        adapter.textUpdated.connect(function(p_text, p_revision) {
+            window.vnotex.updateMarkdownText(p_text, p_revision);
+        });
+
+        adapter.textDeltaUpdated.connect(function(p_baseRevision, p_revision, p_startLine, p_removedLines, p_text) {
+            window.vnotex.applyMarkdownTextDelta(p_baseRevision, p_revision, p_startLine, p_removedLines, p_text);
+        });
+
+        adapter.baseUrlUpdated.connect(function(p_baseUrl) {
+            window.vnotex.setBaseUrl(p_baseUrl);
         });
 
         adapter.editLineNumberUpdated.connect(function(p_lineNumber) {
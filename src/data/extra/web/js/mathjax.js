@@ -46,7 +46,11 @@ class MathJaxRenderer extends VxWorker {
             this.render(this.vnotex.contentContainer, 'tex-to-render');
         });
 
-        this.vnotex.getWorker('markdownit').addLangsToSkipHighlight(this.langs);
+        let markdownIt = this.vnotex.getWorker('markdownit');
+        markdownIt.addLangsToSkipHighlight(this.langs);
+
+        // Equations are numbered and referenced across the whole document.
+        markdownIt.addFullRenderSelector('mjx-container[display]');
     }
 
     initialize(p_callback) {
@@ -73,15 +77,16 @@ class MathJaxRenderer extends VxWorker {
         let extraNodes = this.vnotex.getWorker('markdownit').getCodeNodes(this.langs);
         this.transformExtraNodes(p_node, p_className, extraNodes);
 
-        // Collect nodes to render.
-        let nodes = p_node.getElementsByClassName(p_className);
-        if (nodes.length == 0) {
+        // Collect nodes to render, skipping those kept from last render.
+        let markdownIt = this.vnotex.getWorker('markdownit');
+        this.nodesToRender = Array.from(p_node.getElementsByClassName(p_className)).filter((p_ele) => {
+            return !markdownIt.isReused(p_ele);
+        });
+        if (this.nodesToRender.length == 0) {
             this.finishWork();
             return;
         }
 
-        this.nodesToRender = Array.from(nodes);
-
         if (!this.initialize(() => {
             this.renderNodes();
             })) {
@@ -31,6 +31,10 @@ class VNoteX extends EventEmitter {
             anchor: null
         }
 
+        // Markdown text from CPP side and its revision, which text deltas are based on.
+        this.markdownText = '';
+        this.markdownTextRevision = -1;
+
         this.numOfMuteScroll = 0;
 
         this.os = VNoteX.detectOS();
@@ -149,6 +153,43 @@ class VNoteX extends EventEmitter {
         }
     }
 
+    updateMarkdownText(p_text, p_revision) {
+        this.markdownText = p_text;
+        this.markdownTextRevision = p_revision;
+        this.setMarkdownText(p_text);
+    }
+
+    // Replace @p_removedLines lines from line @p_startLine with @p_text.
+    applyMarkdownTextDelta(p_baseRevision, p_revision, p_startLine, p_removedLines, p_text) {
+        if (p_baseRevision != this.markdownTextRevision) {
+            console.warn('text delta is based on revision', p_baseRevision,
+                         'instead of', this.markdownTextRevision);
+            this.markdownTextRevision = -1;
+            window.vxMarkdownAdapter.requestFullText();
+            return;
+        }
+
+        let start = VNoteX.lineOffset(this.markdownText, p_startLine, 0);
+        let end = VNoteX.lineOffset(this.markdownText, p_removedLines, start);
+        this.markdownText = this.markdownText.substring(0, start) + p_text + this.markdownText.substring(end);
+        this.markdownTextRevision = p_revision;
+        this.setMarkdownText(this.markdownText);
+    }
+
+    // Offset of the start of the @p_lines-th line after offset @p_from in @p_text,
+    // or length of @p_text if there are not so many lines.
+    static lineOffset(p_text, p_lines, p_from) {
+        let offset = p_from;
+        for (let i = 0; i < p_lines; ++i) {
+            let idx = p_text.indexOf('\n', offset);
+            if (idx == -1) {
+                return p_text.length;
+            }
+            offset = idx + 1;
+        }
+        return offset;
+    }
+
     scrollToLine(p_lineNumber) {
         if (p_lineNumber < 0) {
             return;
@@ -175,6 +216,31 @@ class VNoteX extends EventEmitter {
         }
     }
 
+    // Resolve relative links against @p_baseUrl instead of the URL the page is loaded with.
+    setBaseUrl(p_baseUrl) {
+        let base = document.head.querySelector('base');
+        if (!base) {
+            base = document.createElement('base');
+            document.head.insertBefore(base, document.head.firstChild);
+
+            // In-page anchors do not match the document URL any more.
+            document.addEventListener('click', (p_event) => {
+                let link = p_event.target.closest('a');
+                if (!link) {
+                    return;
+                }
+
+                let href = link.getAttribute('href');
+                if (href && href.length > 1 && href.startsWith('#')) {
+                    p_event.preventDefault();
+                    this.scrollToAnchor(decodeURIComponent(href.substring(1)));
+                }
+            });
+        }
+
+        base.href = p_baseUrl;
+    }
+
     setBasicMarkdownRendered() {
         this.emit('basicMarkdownRendered');
     }
@@ -12,6 +12,20 @@ class WaveDromRenderer extends GraphRenderer {
         this.langs = ['wavedrom', 'wave'];
     }
 
+    registerInternal() {
+        super.registerInternal();
+
+        // WaveDrom graphs share the styles of the first one.
+        this.vnotex.getWorker('markdownit').addFullRenderSelector('.' + this.graphDivClass);
+    }
+
+    reset() {
+        super.reset();
+
+        // No WaveDrom graph is kept from last render.
+        this.graphIdx = 0;
+    }
+
     // Render @p_node as WaveDrom graph.
     // Return true on success.
     renderOne(p_node, p_idx) {
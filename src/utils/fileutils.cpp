@@ -1,16 +1,205 @@
 #include "fileutils.h"
 
 #include <QFile>
+#include <QBuffer>
+#include <QSaveFile>
+#include <QTextStream>
 #include <QMimeDatabase>
 #include <QDateTime>
 #include <QTemporaryFile>
 #include <QJsonDocument>
+#include <QtEndian>
+
+#include <cstring>
 
 #include "../core/exception.h"
 #include "pathutils.h"
 
+#if defined(Q_OS_WIN)
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+#if defined(Q_OS_LINUX)
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/sendfile.h>
+#include <linux/fs.h>
+#endif
+
 using namespace vnotex;
 
+// Directories to sync of the outermost DirectorySyncBatch in current thread.
+static thread_local QSet<QString> *t_pendingDirSyncs = nullptr;
+
+static void syncDirectory(const QString &p_dirPath)
+{
+#if !defined(Q_OS_WIN)
+    // Make the rename itself durable.
+    const int fd = ::open(QFile::encodeName(p_dirPath).constData(), O_RDONLY);
+    if (fd != -1) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+#else
+    // Directory entries could not be synced separately on Windows.
+    Q_UNUSED(p_dirPath);
+#endif
+}
+
+static void syncParentDirectory(const QString &p_filePath)
+{
+    const auto dirPath = PathUtils::parentDirPath(p_filePath);
+    if (t_pendingDirSyncs) {
+        t_pendingDirSyncs->insert(dirPath);
+    } else {
+        syncDirectory(dirPath);
+    }
+}
+
+namespace
+{
+    // Streaming XXH64, which is fast enough to hash files on every external change.
+    class Xxh64
+    {
+    public:
+        void update(const char *p_data, qint64 p_size)
+        {
+            auto p = reinterpret_cast<const uchar *>(p_data);
+            const auto end = p + p_size;
+            m_totalSize += p_size;
+
+            if (m_bufferSize + p_size < c_stripeSize) {
+                memcpy(m_buffer + m_bufferSize, p, p_size);
+                m_bufferSize += static_cast<int>(p_size);
+                return;
+            }
+
+            if (m_bufferSize > 0) {
+                const int fill = c_stripeSize - m_bufferSize;
+                memcpy(m_buffer + m_bufferSize, p, fill);
+                consumeStripe(m_buffer);
+                p += fill;
+                m_bufferSize = 0;
+            }
+
+            for (; p + c_stripeSize <= end; p += c_stripeSize) {
+                consumeStripe(p);
+            }
+
+            m_bufferSize = static_cast<int>(end - p);
+            memcpy(m_buffer, p, m_bufferSize);
+        }
+
+        quint64 digest() const
+        {
+            quint64 h = 0;
+            if (m_totalSize >= c_stripeSize) {
+                h = rotl(m_acc[0], 1) + rotl(m_acc[1], 7) + rotl(m_acc[2], 12) + rotl(m_acc[3], 18);
+                for (auto acc : m_acc) {
+                    h ^= round(0, acc);
+                    h = h * c_prime1 + c_prime4;
+                }
+            } else {
+                h = c_prime5;
+            }
+            h += static_cast<quint64>(m_totalSize);
+
+            auto p = m_buffer;
+            const auto end = m_buffer + m_bufferSize;
+            for (; p + 8 <= end; p += 8) {
+                h ^= round(0, qFromLittleEndian<quint64>(p));
+                h = rotl(h, 27) * c_prime1 + c_prime4;
+            }
+            if (p + 4 <= end) {
+                h ^= qFromLittleEndian<quint32>(p) * c_prime1;
+                h = rotl(h, 23) * c_prime2 + c_prime3;
+                p += 4;
+            }
+            for (; p < end; ++p) {
+                h ^= *p * c_prime5;
+                h = rotl(h, 11) * c_prime1;
+            }
+
+            h ^= h >> 33;
+            h *= c_prime2;
+            h ^= h >> 29;
+            h *= c_prime3;
+            h ^= h >> 32;
+            return h;
+        }
+
+    private:
+        static quint64 rotl(quint64 p_x, int p_r)
+        {
+            return (p_x << p_r) | (p_x >> (64 - p_r));
+        }
+
+        static quint64 round(quint64 p_acc, quint64 p_input)
+        {
+            p_acc += p_input * c_prime2;
+            return rotl(p_acc, 31) * c_prime1;
+        }
+
+        void consumeStripe(const uchar *p_data)
+        {
+            for (int i = 0; i < 4; ++i) {
+                m_acc[i] = round(m_acc[i], qFromLittleEndian<quint64>(p_data + i * 8));
+            }
+        }
+
+        static const int c_stripeSize = 32;
+
+        static const quint64 c_prime1 = 11400714785074694791ULL;
+
+        static const quint64 c_prime2 = 14029467366897019727ULL;
+
+        static const quint64 c_prime3 = 1609587929392839161ULL;
+
+        static const quint64 c_prime4 = 9650029242287828579ULL;
+
+        static const quint64 c_prime5 = 2870177450012600261ULL;
+
+        quint64 m_acc[4] = {c_prime1 + c_prime2, c_prime2, 0, 0 - c_prime1};
+
+        uchar m_buffer[c_stripeSize];
+
+        int m_bufferSize = 0;
+
+        qint64 m_totalSize = 0;
+    };
+}
+
+FileUtils::DirectorySyncBatch::DirectorySyncBatch()
+{
+    if (!t_pendingDirSyncs) {
+        t_pendingDirSyncs = &m_dirPaths;
+        m_owner = true;
+    }
+}
+
+FileUtils::DirectorySyncBatch::~DirectorySyncBatch()
+{
+    if (!m_owner) {
+        return;
+    }
+
+    flush();
+    t_pendingDirSyncs = nullptr;
+}
+
+void FileUtils::DirectorySyncBatch::flush()
+{
+    Q_ASSERT(t_pendingDirSyncs);
+    for (const auto &dirPath : *t_pendingDirSyncs) {
+        syncDirectory(dirPath);
+    }
+    t_pendingDirSyncs->clear();
+}
+
 QByteArray FileUtils::readFile(const QString &p_filePath)
 {
     QFile file(p_filePath);
@@ -35,6 +224,56 @@ QString FileUtils::readTextFile(const QString &p_filePath)
     return text;
 }
 
+QString FileUtils::decodeText(const QByteArray &p_data)
+{
+    QBuffer buffer;
+    buffer.setData(p_data);
+    buffer.open(QIODevice::ReadOnly | QIODevice::Text);
+    return QString(buffer.readAll());
+}
+
+QByteArray FileUtils::encodeText(const QString &p_text)
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly | QIODevice::Text);
+    QTextStream stream(&buffer);
+    stream << p_text;
+    stream.flush();
+    return data;
+}
+
+quint64 FileUtils::hashFile(const QString &p_filePath)
+{
+    QFile file(p_filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        Exception::throwOne(Exception::Type::FailToReadFile,
+                            QString("failed to read file: %1").arg(p_filePath));
+    }
+
+    Xxh64 hasher;
+    QByteArray chunk(1024 * 1024, Qt::Uninitialized);
+    while (true) {
+        const auto size = file.read(chunk.data(), chunk.size());
+        if (size < 0) {
+            Exception::throwOne(Exception::Type::FailToReadFile,
+                                QString("failed to read file: %1 (%2)").arg(p_filePath, file.errorString()));
+        } else if (size == 0) {
+            break;
+        }
+        hasher.update(chunk.constData(), size);
+    }
+
+    return hasher.digest();
+}
+
+quint64 FileUtils::hashData(const QByteArray &p_data)
+{
+    Xxh64 hasher;
+    hasher.update(p_data.constData(), p_data.size());
+    return hasher.digest();
+}
+
 QJsonObject FileUtils::readJsonFile(const QString &p_filePath)
 {
     return QJsonDocument::fromJson(readFile(p_filePath)).object();
@@ -70,6 +309,57 @@ void FileUtils::writeFile(const QString &p_filePath, const QJsonObject &p_jobj)
     writeFile(p_filePath, QJsonDocument(p_jobj).toJson());
 }
 
+void FileUtils::writeFileDurably(const QString &p_filePath, const QByteArray &p_data)
+{
+    // QSaveFile syncs the temporary file to disk before renaming it on commit.
+    QSaveFile file(p_filePath);
+    if (!file.open(QIODevice::WriteOnly)
+        || file.write(p_data) != p_data.size()
+        || !file.commit()) {
+        Exception::throwOne(Exception::Type::FailToWriteFile,
+                            QString("failed to write to file: %1 (%2)").arg(p_filePath, file.errorString()));
+    }
+
+    syncParentDirectory(p_filePath);
+}
+
+void FileUtils::writeFileDurably(const QString &p_filePath, const QString &p_text)
+{
+    QSaveFile file(p_filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        Exception::throwOne(Exception::Type::FailToWriteFile,
+                            QString("failed to write to file: %1 (%2)").arg(p_filePath, file.errorString()));
+    }
+
+    QTextStream stream(&file);
+    stream << p_text;
+    stream.flush();
+    if (stream.status() != QTextStream::Ok || !file.commit()) {
+        Exception::throwOne(Exception::Type::FailToWriteFile,
+                            QString("failed to write to file: %1 (%2)").arg(p_filePath, file.errorString()));
+    }
+
+    syncParentDirectory(p_filePath);
+}
+
+void FileUtils::appendFile(const QString &p_filePath, const QByteArray &p_data)
+{
+    QFile file(p_filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)
+        || file.write(p_data) != p_data.size()
+        || !file.flush()) {
+        Exception::throwOne(Exception::Type::FailToWriteFile,
+                            QString("failed to append to file: %1").arg(p_filePath));
+    }
+
+#if defined(Q_OS_WIN)
+    _commit(file.handle());
+#else
+    ::fsync(file.handle());
+#endif
+    file.close();
+}
+
 void FileUtils::renameFile(const QString &p_path, const QString &p_name)
 {
     Q_ASSERT(PathUtils::isLegalFileName(p_name));
@@ -125,7 +415,7 @@ void FileUtils::copyFile(const QString &p_filePath,
             failed = true;
         }
     } else {
-        if (!QFile::copy(p_filePath, p_destPath)) {
+        if (!copyFileInKernel(p_filePath, p_destPath) && !QFile::copy(p_filePath, p_destPath)) {
             failed = true;
         }
     }
@@ -136,6 +426,80 @@ void FileUtils::copyFile(const QString &p_filePath,
     }
 }
 
+bool FileUtils::copyFileInKernel(const QString &p_filePath, const QString &p_destPath)
+{
+#if defined(Q_OS_LINUX)
+    const int srcFd = ::open(QFile::encodeName(p_filePath).constData(), O_RDONLY | O_CLOEXEC);
+    if (srcFd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(srcFd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(srcFd);
+        return false;
+    }
+
+    // Fail if exists, just like QFile::copy().
+    const auto destName = QFile::encodeName(p_destPath);
+    const int destFd = ::open(destName.constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, st.st_mode & 0777);
+    if (destFd < 0) {
+        ::close(srcFd);
+        return false;
+    }
+
+    // Share the extents on btrfs and xfs.
+    bool done = st.st_size == 0 || ::ioctl(destFd, FICLONE, srcFd) == 0;
+
+    off_t copied = 0;
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+    while (!done) {
+        const auto ret = ::copy_file_range(srcFd, nullptr, destFd, nullptr, st.st_size - copied, 0);
+        if (ret < 0) {
+            // Not supported by the kernel or across file systems on old kernels.
+            break;
+        } else if (ret == 0) {
+            done = copied >= st.st_size;
+            break;
+        }
+
+        copied += ret;
+        done = copied >= st.st_size;
+    }
+#endif
+
+    while (!done) {
+        const auto ret = ::sendfile(destFd, srcFd, nullptr, st.st_size - copied);
+        if (ret <= 0) {
+            break;
+        }
+
+        copied += ret;
+        done = copied >= st.st_size;
+    }
+
+    if (done) {
+        // Do not depend on umask.
+        ::fchmod(destFd, st.st_mode & 07777);
+    }
+
+    ::close(srcFd);
+    if (::close(destFd) != 0) {
+        done = false;
+    }
+
+    if (!done) {
+        ::unlink(destName.constData());
+    }
+
+    return done;
+#else
+    Q_UNUSED(p_filePath);
+    Q_UNUSED(p_destPath);
+    return false;
+#endif
+}
+
 void FileUtils::copyDir(const QString &p_dirPath,
                         const QString &p_destPath,
                         bool p_move)
@@ -149,7 +513,25 @@ void FileUtils::copyDir(const QString &p_dirPath,
                             QString("target directory %1 already exists").arg(p_destPath));
     }
 
-    // QDir.rename() could not move directory across dirves.
+    if (p_move) {
+        // Fast path on the same file system.
+        QDir dir;
+        if (dir.mkpath(PathUtils::parentDirPath(p_destPath)) && dir.rename(p_dirPath, p_destPath)) {
+            return;
+        }
+
+        // QDir.rename() could not move directory across dirves.
+        // Copy everything first so that the source is intact if it fails.
+        try {
+            copyDir(p_dirPath, p_destPath, false);
+        } catch (Exception &p_e) {
+            QDir(p_destPath).removeRecursively();
+            throw;
+        }
+
+        removeDir(p_dirPath);
+        return;
+    }
 
     // Create target directory.
     QDir destDir(p_destPath);
@@ -168,17 +550,10 @@ void FileUtils::copyDir(const QString &p_dirPath,
     for (const auto &node : nodes) {
         auto name = node.fileName();
         if (node.isDir()) {
-            copyDir(srcDir.filePath(name), destDir.filePath(name), p_move);
+            copyDir(srcDir.filePath(name), destDir.filePath(name), false);
         } else {
             Q_ASSERT(node.isFile());
-            copyFile(srcDir.filePath(name), destDir.filePath(name), p_move);
-        }
-    }
-
-    if (p_move) {
-        if (!destDir.rmdir(p_dirPath)) {
-            Exception::throwOne(Exception::Type::FailToRemoveDir,
-                QString("failed to remove source directory after move: %1").arg(p_dirPath));
+            copyFile(srcDir.filePath(name), destDir.filePath(name), false);
         }
     }
 }
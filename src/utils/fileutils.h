@@ -6,6 +6,7 @@
 #include <QImage>
 #include <QPixmap>
 #include <QJsonObject>
+#include <QSet>
 
 class QTemporaryFile;
 
@@ -20,6 +21,18 @@ namespace vnotex
 
         static QString readTextFile(const QString &p_filePath);
 
+        // Decode @p_data as readTextFile() does with the bytes of a file.
+        static QString decodeText(const QByteArray &p_data);
+
+        // Encode @p_text into the bytes writeFile() writes for it.
+        static QByteArray encodeText(const QString &p_text);
+
+        // Fast non-cryptographic hash (XXH64) of the bytes of @p_filePath, read in chunks.
+        static quint64 hashFile(const QString &p_filePath);
+
+        // Same hash as hashFile() of @p_data.
+        static quint64 hashData(const QByteArray &p_data);
+
         static QJsonObject readJsonFile(const QString &p_filePath);
 
         static void writeFile(const QString &p_filePath, const QByteArray &p_data);
@@ -28,6 +41,39 @@ namespace vnotex
 
         static void writeFile(const QString &p_filePath, const QJsonObject &p_jobj);
 
+        // Write to a temporary file beside @p_filePath, flush it to the storage device and
+        // rename it over @p_filePath, so that a crash or full disk never leaves a truncated file.
+        // The parent directory is synced too, or later by the DirectorySyncBatch of current thread.
+        static void writeFileDurably(const QString &p_filePath, const QByteArray &p_data);
+
+        static void writeFileDurably(const QString &p_filePath, const QString &p_text);
+
+        // Append @p_data to @p_filePath and flush it to the storage device.
+        static void appendFile(const QString &p_filePath, const QByteArray &p_data);
+
+        // Defer directory syncs of durable writes in current thread until its destruction,
+        // so that each directory is synced once in bulk operations.
+        // Nested batches join the outermost one.
+        class DirectorySyncBatch
+        {
+        public:
+            DirectorySyncBatch();
+
+            ~DirectorySyncBatch();
+
+            // Sync pending directories of current thread now, such as before dropping
+            // a journal which the durable writes replace.
+            void flush();
+
+        private:
+            Q_DISABLE_COPY(DirectorySyncBatch)
+
+            // Whether this is the outermost batch.
+            bool m_owner = false;
+
+            QSet<QString> m_dirPaths;
+        };
+
         // Rename file or dir.
         static void renameFile(const QString &p_path, const QString &p_name);
 
@@ -75,6 +121,12 @@ namespace vnotex
         // Go through @p_dirPath recursively and delete all empty dirs.
         // @p_dirPath itself is not deleted.
         static void removeEmptyDir(const QString &p_dirPath);
+
+    private:
+        // Copy within the kernel by reflink, copy_file_range() or sendfile() without
+        // passing data through user space.
+        // Return false with nothing created if not supported so that caller could fall back.
+        static bool copyFileInKernel(const QString &p_filePath, const QString &p_destPath);
     };
 } // ns vnotex
 
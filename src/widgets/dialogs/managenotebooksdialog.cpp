@@ -151,6 +151,7 @@ void ManageNotebooksDialog::loadNotebooks(const Notebook *p_notebook)
 
     bool hasCurrentItem = false;
     auto &notebookMgr = VNoteX::getInst().getNotebookMgr();
+    notebookMgr.openPendingNotebooks();
     const auto &notebooks = notebookMgr.getNotebooks();
     for (auto &nb : notebooks) {
         auto item = new QListWidgetItem(nb->getName());
@@ -787,7 +787,7 @@ int MarkdownEditor::getCurrentHeadingIndex() const
 void MarkdownEditor::updateHeadings(const QVector<vte::peg::ElementRegion> &p_headerRegions)
 {
     bool needUpdateSectionNumber = false;
-    if (isReadOnly()) {
+    if (isReadOnly() || m_sectionNumberSuspended) {
         m_sectionNumberEnabled = false;
     } else {
         needUpdateSectionNumber = m_config.getSectionNumberMode() == MarkdownEditorConfig::SectionNumberMode::Edit;
@@ -1269,6 +1269,20 @@ void MarkdownEditor::overrideSectionNumber(OverrideState p_state)
     getHighlighter()->updateHighlight();
 }
 
+void MarkdownEditor::suspendSectionNumber(bool p_suspended)
+{
+    if (m_sectionNumberSuspended == p_suspended) {
+        return;
+    }
+
+    m_sectionNumberSuspended = p_suspended;
+    if (m_sectionNumberSuspended) {
+        m_sectionNumberTimer->stop();
+    } else {
+        getHighlighter()->updateHighlight();
+    }
+}
+
 void MarkdownEditor::updateFromConfig(bool p_initialized)
 {
     if (m_config.getTextEditorConfig().getZoomDelta() != 0) {
@@ -98,6 +98,9 @@ namespace vnotex
 
         void overrideSectionNumber(OverrideState p_state);
 
+        // Stop updating section number without touching the existing ones.
+        void suspendSectionNumber(bool p_suspended);
+
         void updateFromConfig(bool p_initialized = true);
 
         QRgb getPreviewBackground() const;
@@ -201,6 +204,8 @@ namespace vnotex
 
         OverrideState m_overriddenSectionNumber = OverrideState::NoOverride;
 
+        bool m_sectionNumberSuspended = false;
+
         // Managed by QObject.
         MarkdownTableHelper *m_tableHelper = nullptr;
     };
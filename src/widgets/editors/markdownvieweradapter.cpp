@@ -89,7 +89,7 @@ void MarkdownViewerAdapter::setText(int p_revision,
 
     m_revision = p_revision;
     if (m_viewerReady) {
-        emit textUpdated(p_text);
+        sendText(p_text);
         scrollToPosition(Position(p_lineNumber, ""));
     } else {
         m_pendingData.reset(new MarkdownData(p_text, p_lineNumber, ""));
@@ -100,12 +100,21 @@ void MarkdownViewerAdapter::setText(const QString &p_text)
 {
     m_revision = 0;
     if (m_viewerReady) {
-        emit textUpdated(p_text);
+        sendText(p_text);
     } else {
         m_pendingData.reset(new MarkdownData(p_text, -1, ""));
     }
 }
 
+void MarkdownViewerAdapter::setBaseUrl(const QString &p_baseUrl)
+{
+    if (m_viewerReady) {
+        emit baseUrlUpdated(p_baseUrl);
+    } else {
+        m_pendingBaseUrl = p_baseUrl;
+    }
+}
+
 void MarkdownViewerAdapter::setReady(bool p_ready)
 {
     if (m_viewerReady == p_ready) {
@@ -114,8 +123,13 @@ void MarkdownViewerAdapter::setReady(bool p_ready)
 
     m_viewerReady = p_ready;
     if (m_viewerReady) {
+        if (!m_pendingBaseUrl.isEmpty()) {
+            emit baseUrlUpdated(m_pendingBaseUrl);
+            m_pendingBaseUrl.clear();
+        }
+
         if (m_pendingData) {
-            emit textUpdated(m_pendingData->m_text);
+            sendText(m_pendingData->m_text);
             scrollToPosition(m_pendingData->m_position);
             m_pendingData.reset();
         }
@@ -125,6 +139,75 @@ void MarkdownViewerAdapter::setReady(bool p_ready)
 
 }
 
+void MarkdownViewerAdapter::sendText(const QString &p_text)
+{
+    if (!m_sentText.isEmpty() && p_text == m_sentText) {
+        return;
+    }
+
+    const int baseRevision = m_sentTextRevision++;
+    if (m_sentText.isEmpty() || p_text.isEmpty()) {
+        m_sentText = p_text;
+        emit textUpdated(m_sentText, m_sentTextRevision);
+        return;
+    }
+
+    // Find the changed lines by the common prefix and suffix.
+    const int oldLen = m_sentText.size();
+    const int newLen = p_text.size();
+    const int minLen = qMin(oldLen, newLen);
+    int prefixLen = 0;
+    while (prefixLen < minLen && m_sentText[prefixLen] == p_text[prefixLen]) {
+        ++prefixLen;
+    }
+
+    // Align to line start.
+    const int startPos = prefixLen == 0 ? 0 : p_text.lastIndexOf(QLatin1Char('\n'), prefixLen - 1) + 1;
+    const int startLine = p_text.leftRef(startPos).count(QLatin1Char('\n'));
+
+    int suffixLen = 0;
+    const int maxSuffixLen = minLen - startPos;
+    while (suffixLen < maxSuffixLen && m_sentText[oldLen - 1 - suffixLen] == p_text[newLen - 1 - suffixLen]) {
+        ++suffixLen;
+    }
+
+    // Align to line start of the old text, which web side counts lines in.
+    int oldSuffixPos = oldLen - suffixLen;
+    if (oldSuffixPos > 0 && oldSuffixPos < oldLen && m_sentText[oldSuffixPos - 1] != QLatin1Char('\n')) {
+        int idx = m_sentText.indexOf(QLatin1Char('\n'), oldSuffixPos);
+        oldSuffixPos = idx == -1 ? oldLen : idx + 1;
+    }
+    suffixLen = oldLen - oldSuffixPos;
+    const int newSuffixPos = newLen - suffixLen;
+
+    const auto removedText = m_sentText.midRef(startPos, oldSuffixPos - startPos);
+    int removedLines = removedText.count(QLatin1Char('\n'));
+    if (oldSuffixPos == oldLen && !removedText.isEmpty() && !removedText.endsWith(QLatin1Char('\n'))) {
+        // The last line without trailing '\n'.
+        ++removedLines;
+    }
+
+    const int insertedLen = newSuffixPos - startPos;
+    if (insertedLen > newLen / 2) {
+        // Not worth a delta.
+        m_sentText = p_text;
+        emit textUpdated(m_sentText, m_sentTextRevision);
+        return;
+    }
+
+    m_sentText = p_text;
+    emit textDeltaUpdated(baseRevision,
+                          m_sentTextRevision,
+                          startLine,
+                          removedLines,
+                          p_text.mid(startPos, insertedLen));
+}
+
+void MarkdownViewerAdapter::requestFullText()
+{
+    emit textUpdated(m_sentText, m_sentTextRevision);
+}
+
 void MarkdownViewerAdapter::scrollToLine(int p_lineNumber)
 {
     if (p_lineNumber == -1) {
@@ -366,8 +449,11 @@ void MarkdownViewerAdapter::setSavedContent(const QString &p_headContent,
 void MarkdownViewerAdapter::reset()
 {
     m_revision = 0;
+    m_sentText.clear();
+    m_sentTextRevision = 0;
     m_viewerReady = false;
     m_pendingData.reset();
+    m_pendingBaseUrl.clear();
     m_topLineNumber = -1;
     m_headings.clear();
     m_currentHeadingIndex = -1;
@@ -102,6 +102,10 @@ namespace vnotex
 
         void setText(const QString &p_text);
 
+        // Set the URL to resolve relative links against, for a viewer whose template is
+        // loaded before knowing the file.
+        void setBaseUrl(const QString &p_baseUrl);
+
         void scrollToPosition(const Position &p_pos);
 
         int getTopLineNumber() const;
@@ -132,6 +136,9 @@ namespace vnotex
 
         void setWorkFinished();
 
+        // Web fails to apply a text delta and asks for the whole text.
+        void requestFullText();
+
         // The line number at the top.
         void setTopLineNumber(int p_lineNumber);
 
@@ -182,7 +189,19 @@ namespace vnotex
         // Signals to be connected at web side.
     signals:
         // Current Markdown text is updated.
-        void textUpdated(const QString &p_text);
+        // @p_revision: revision of the text which later deltas are based on.
+        void textUpdated(const QString &p_text, int p_revision);
+
+        // Current Markdown text is updated by replacing @p_removedLines lines from
+        // line @p_startLine (0-based) with @p_text.
+        // @p_baseRevision: revision of the text the delta is based on.
+        void textDeltaUpdated(int p_baseRevision,
+                              int p_revision,
+                              int p_startLine,
+                              int p_removedLines,
+                              const QString &p_text);
+
+        void baseUrlUpdated(const QString &p_baseUrl);
 
         // Current editor line number is updated.
         void editLineNumberUpdated(int p_lineNumber);
@@ -255,14 +274,25 @@ namespace vnotex
 
         void scrollToAnchor(const QString &p_anchor);
 
+        // Send @p_text to web side as a delta against the last sent text if possible.
+        void sendText(const QString &p_text);
+
         int m_revision = 0;
 
+        // Last text sent to web side and its revision.
+        QString m_sentText;
+
+        int m_sentTextRevision = 0;
+
         // Whether web side viewer is ready to handle text update.
         bool m_viewerReady = false;
 
         // Pending Markdown data for the viewer once it is ready.
         QScopedPointer<MarkdownData> m_pendingData;
 
+        // Pending base URL for the viewer once it is ready.
+        QString m_pendingBaseUrl;
+
         // Source line number of the top element node at web side.
         int m_topLineNumber = -1;
 
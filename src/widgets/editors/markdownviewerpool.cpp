@@ -0,0 +1,122 @@
+#include "markdownviewerpool.h"
+
+#include <QCoreApplication>
+#include <QTimer>
+
+#include <core/configmgr.h>
+#include <core/editorconfig.h>
+#include <core/markdowneditorconfig.h>
+#include <core/htmltemplatehelper.h>
+#include <core/vnotex.h>
+#include <core/thememgr.h>
+#include <utils/pathutils.h>
+
+#include "markdownviewer.h"
+#include "editormarkdownvieweradapter.h"
+
+using namespace vnotex;
+
+const int MarkdownViewerPool::c_capacity = 2;
+
+MarkdownViewerPool &MarkdownViewerPool::getInst()
+{
+    static MarkdownViewerPool pool;
+    return pool;
+}
+
+MarkdownViewerPool::MarkdownViewerPool()
+{
+    // Web views could not outlive the application.
+    connect(qApp, &QCoreApplication::aboutToQuit,
+            this, &MarkdownViewerPool::clear);
+}
+
+void MarkdownViewerPool::warmUp()
+{
+    if (m_closed || m_fillPending || m_entries.size() >= c_capacity) {
+        return;
+    }
+
+    // Leave the event loop to the opening window first.
+    m_fillPending = true;
+    QTimer::singleShot(1000, this, &MarkdownViewerPool::fill);
+}
+
+void MarkdownViewerPool::fill()
+{
+    m_fillPending = false;
+    if (m_closed) {
+        return;
+    }
+
+    while (m_entries.size() < c_capacity) {
+        addViewer(createViewer());
+    }
+}
+
+MarkdownViewer *MarkdownViewerPool::createViewer() const
+{
+    const auto &markdownEditorConfig = ConfigMgr::getInst().getEditorConfig().getMarkdownEditorConfig();
+    return new MarkdownViewer(new EditorMarkdownViewerAdapter(nullptr),
+                              VNoteX::getInst().getThemeMgr().getBaseBackground(),
+                              markdownEditorConfig.getZoomFactorInReadMode(),
+                              nullptr);
+}
+
+void MarkdownViewerPool::addViewer(MarkdownViewer *p_viewer)
+{
+    const auto &markdownEditorConfig = ConfigMgr::getInst().getEditorConfig().getMarkdownEditorConfig();
+    HtmlTemplateHelper::updateMarkdownViewerTemplate(markdownEditorConfig);
+
+    Entry entry;
+    entry.m_viewer = p_viewer;
+    entry.m_templateRevision = HtmlTemplateHelper::getMarkdownViewerTemplateRevision();
+
+    // The real base URL will be set by the one checking it out.
+    const auto templateFile = ConfigMgr::getInst().getUserOrAppFile(markdownEditorConfig.getViewerResource().m_template);
+    p_viewer->adapter()->reset();
+    p_viewer->setHtml(HtmlTemplateHelper::getMarkdownViewerTemplate(), PathUtils::pathToUrl(templateFile));
+
+    m_entries.push_back(entry);
+}
+
+MarkdownViewer *MarkdownViewerPool::checkOut(bool *p_templateLoaded)
+{
+    *p_templateLoaded = false;
+
+    MarkdownViewer *viewer = nullptr;
+    if (!m_entries.isEmpty()) {
+        const auto entry = m_entries.takeFirst();
+        viewer = entry.m_viewer;
+        *p_templateLoaded = entry.m_templateRevision == HtmlTemplateHelper::getMarkdownViewerTemplateRevision();
+    } else {
+        viewer = createViewer();
+    }
+
+    warmUp();
+
+    return viewer;
+}
+
+void MarkdownViewerPool::checkIn(MarkdownViewer *p_viewer)
+{
+    p_viewer->hide();
+    p_viewer->setParent(nullptr);
+
+    if (m_closed || m_entries.size() >= c_capacity) {
+        p_viewer->deleteLater();
+        return;
+    }
+
+    // Load the template again to drop the content of previous owner.
+    addViewer(p_viewer);
+}
+
+void MarkdownViewerPool::clear()
+{
+    m_closed = true;
+    for (const auto &entry : m_entries) {
+        delete entry.m_viewer;
+    }
+    m_entries.clear();
+}
@@ -0,0 +1,62 @@
+#ifndef MARKDOWNVIEWERPOOL_H
+#define MARKDOWNVIEWERPOOL_H
+
+#include <QObject>
+#include <QVector>
+
+namespace vnotex
+{
+    class MarkdownViewer;
+
+    // Pool of idle MarkdownViewers with the viewer template loaded in background, so that
+    // entering read mode only needs to send the text instead of loading all the scripts.
+    class MarkdownViewerPool : public QObject
+    {
+        Q_OBJECT
+    public:
+        static MarkdownViewerPool &getInst();
+
+        // Fill the pool in background if it is not full.
+        void warmUp();
+
+        // Take an idle viewer, or a new one if there is none.
+        // @p_templateLoaded: set to whether current viewer template is loaded in the viewer,
+        // of which the base URL should be set via MarkdownViewerAdapter::setBaseUrl().
+        MarkdownViewer *checkOut(bool *p_templateLoaded);
+
+        // Give @p_viewer back. Its owner should have cut its connections to the viewer.
+        void checkIn(MarkdownViewer *p_viewer);
+
+    private:
+        struct Entry
+        {
+            MarkdownViewer *m_viewer = nullptr;
+
+            // Revision of the template loaded.
+            int m_templateRevision = -1;
+        };
+
+        MarkdownViewerPool();
+
+        MarkdownViewer *createViewer() const;
+
+        // Load current viewer template in @p_viewer and put it into the pool.
+        void addViewer(MarkdownViewer *p_viewer);
+
+        void fill();
+
+        void clear();
+
+        QVector<Entry> m_entries;
+
+        bool m_fillPending = false;
+
+        // Whether the application is quitting.
+        bool m_closed = false;
+
+        // Number of idle viewers to keep.
+        static const int c_capacity;
+    };
+} // ns vnotex
+
+#endif // MARKDOWNVIEWERPOOL_H
@@ -484,6 +484,33 @@ void PreviewHelper::setWebGraphvizEnabled(bool p_enabled)
     m_webGraphvizEnabled = p_enabled;
 }
 
+void PreviewHelper::setInplacePreviewSourcesEnabled(SourceFlags p_sources, bool p_enabled)
+{
+    const auto sources = p_enabled ? (m_inplacePreviewSources | p_sources) : (m_inplacePreviewSources & ~p_sources);
+    if (sources == m_inplacePreviewSources) {
+        return;
+    }
+
+    m_inplacePreviewSources = sources;
+    if (p_enabled) {
+        // Previews will come with the next update of code blocks and math blocks.
+        return;
+    }
+
+    // Previews of the sources still enabled will be back with the next update.
+    if (m_previousInplacePreviewCodeBlockSize > 0) {
+        m_codeBlocksData.clear();
+        m_previousInplacePreviewCodeBlockSize = 0;
+        emit inplacePreviewCodeBlockUpdated(QVector<QSharedPointer<vte::PreviewItem>>());
+    }
+
+    if ((p_sources & SourceFlag::Math) && m_previousInplacePreviewMathBlockSize > 0) {
+        m_mathBlocksData.clear();
+        m_previousInplacePreviewMathBlockSize = 0;
+        emit inplacePreviewMathBlockUpdated(QVector<QSharedPointer<vte::PreviewItem>>());
+    }
+}
+
 void PreviewHelper::handleLocalData(quint64 p_id,
                                     TimeStamp p_timeStamp,
                                     const QString &p_format,
@@ -47,6 +47,10 @@ namespace vnotex
 
         void setWebGraphvizEnabled(bool p_enabled);
 
+        // Enable or disable in-place preview of @p_sources.
+        // Previews of disabled sources are cleared at once.
+        void setInplacePreviewSourcesEnabled(SourceFlags p_sources, bool p_enabled);
+
     public slots:
         void codeBlocksUpdated(vte::TimeStamp p_timeStamp,
                                const QVector<vte::peg::FencedCodeBlock> &p_codeBlocks);
@@ -0,0 +1,66 @@
+#include "fileoperationstatuswidget.h"
+
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QProgressBar>
+#include <QToolButton>
+
+#include <core/fileoperationqueue.h>
+#include "vnotex.h"
+#include "thememgr.h"
+#include <utils/iconutils.h>
+
+using namespace vnotex;
+
+FileOperationStatusWidget::FileOperationStatusWidget(FileOperationQueue *p_queue, QWidget *p_parent)
+    : QWidget(p_parent),
+      m_queue(p_queue)
+{
+    setupUI();
+
+    connect(m_queue, &FileOperationQueue::progressChanged,
+            this, &FileOperationStatusWidget::updateProgress);
+    connect(m_queue, &FileOperationQueue::finished,
+            this, &QWidget::hide);
+
+    setVisible(m_queue->isBusy());
+}
+
+void FileOperationStatusWidget::setupUI()
+{
+    auto mainLayout = new QHBoxLayout(this);
+    mainLayout->setContentsMargins(0, 0, 0, 0);
+
+    m_label = new QLabel(this);
+    mainLayout->addWidget(m_label);
+
+    m_progressBar = new QProgressBar(this);
+    m_progressBar->setRange(0, 0);
+    m_progressBar->setTextVisible(false);
+    m_progressBar->setMaximumWidth(160);
+    mainLayout->addWidget(m_progressBar);
+
+    m_cancelBtn = new QToolButton(this);
+    m_cancelBtn->setIcon(IconUtils::fetchIconWithDisabledState(
+        VNoteX::getInst().getThemeMgr().getIconFile(QStringLiteral("cancel.svg"))));
+    m_cancelBtn->setToolTip(tr("Cancel"));
+    m_cancelBtn->setAutoRaise(true);
+    connect(m_cancelBtn, &QToolButton::clicked,
+            m_queue, &FileOperationQueue::cancel);
+    mainLayout->addWidget(m_cancelBtn);
+}
+
+void FileOperationStatusWidget::updateProgress(const QString &p_description, int p_done, int p_total, int p_pending)
+{
+    if (p_pending > 0) {
+        m_label->setText(tr("%1 (%n more)", "", p_pending).arg(p_description));
+    } else {
+        m_label->setText(p_description);
+    }
+
+    // Busy indicator until the work is counted.
+    m_progressBar->setMaximum(p_total);
+    m_progressBar->setValue(p_done);
+
+    show();
+}
@@ -0,0 +1,36 @@
+#ifndef FILEOPERATIONSTATUSWIDGET_H
+#define FILEOPERATIONSTATUSWIDGET_H
+
+#include <QWidget>
+
+class QLabel;
+class QProgressBar;
+class QToolButton;
+
+namespace vnotex
+{
+    class FileOperationQueue;
+
+    // Show progress of the background file operations in status bar.
+    class FileOperationStatusWidget : public QWidget
+    {
+        Q_OBJECT
+    public:
+        FileOperationStatusWidget(FileOperationQueue *p_queue, QWidget *p_parent = nullptr);
+
+    private:
+        void setupUI();
+
+        void updateProgress(const QString &p_description, int p_done, int p_total, int p_pending);
+
+        FileOperationQueue *m_queue = nullptr;
+
+        QLabel *m_label = nullptr;
+
+        QProgressBar *m_progressBar = nullptr;
+
+        QToolButton *m_cancelBtn = nullptr;
+    };
+} // ns vnotex
+
+#endif // FILEOPERATIONSTATUSWIDGET_H
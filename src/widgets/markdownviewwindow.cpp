@@ -7,6 +7,8 @@
 #include <QCoreApplication>
 #include <QScrollBar>
 #include <QLabel>
+#include <QToolButton>
+#include <QMenu>
 
 #include <core/fileopenparameters.h>
 #include <core/editorconfig.h>
@@ -22,6 +24,7 @@
 #include "editors/markdowneditor.h"
 #include "textviewwindowhelper.h"
 #include "editors/markdownviewer.h"
+#include "editors/markdownviewerpool.h"
 #include "editors/editormarkdownvieweradapter.h"
 #include "editors/previewhelper.h"
 #include "dialogs/deleteconfirmdialog.h"
@@ -31,6 +34,7 @@
 #include "editors/statuswidget.h"
 #include "editors/plantumlhelper.h"
 #include "editors/graphvizhelper.h"
+#include "widgetsfactory.h"
 
 using namespace vnotex;
 
@@ -43,10 +47,14 @@ MarkdownViewWindow::MarkdownViewWindow(QWidget *p_parent)
     setupUI();
 
     setupPreviewHelper();
+
+    MarkdownViewerPool::getInst().warmUp();
 }
 
 MarkdownViewWindow::~MarkdownViewWindow()
 {
+    releaseViewer();
+
     if (m_textEditorStatusWidget) {
         getMainStatusWidget()->removeWidget(m_textEditorStatusWidget.get());
         m_textEditorStatusWidget->setParent(nullptr);
@@ -236,9 +244,11 @@ void MarkdownViewWindow::doSyncEditorFromBufferContent(bool p_syncPosition)
 
 void MarkdownViewWindow::handleBufferChangedInternal(const QSharedPointer<FileOpenParameters> &p_paras)
 {
+    updateLargeFileMode();
+
     if (getBuffer()) {
         // Will sync buffer right behind this.
-        setModeInternal(p_paras ? p_paras->m_mode : ViewWindowMode::Read, false);
+        setModeInternal(adjustModeForLargeFile(p_paras ? p_paras->m_mode : ViewWindowMode::Read), false);
     }
 
     TextViewWindowHelper::handleBufferChanged(this);
@@ -286,6 +296,7 @@ void MarkdownViewWindow::setupToolBar()
     addAction(toolBar, ViewWindowToolBarHelper::TypeTable);
 
     ToolBarHelper::addSpacer(toolBar);
+    setupLargeFileAction(toolBar);
     addAction(toolBar, ViewWindowToolBarHelper::FindAndReplace);
     addAction(toolBar, ViewWindowToolBarHelper::Outline);
 }
@@ -316,6 +327,8 @@ void MarkdownViewWindow::setupTextEditor()
     m_previewHelper->setMarkdownEditor(m_editor);
     m_editor->setPreviewHelper(m_previewHelper);
 
+    m_editor->suspendSectionNumber(!isLargeFileFeatureEnabled(LargeFileFeature::SectionNumber));
+
     // Connect viewer and editor.
     connect(adapter(), &MarkdownViewerAdapter::viewerReady,
             m_editor->getHighlighter(), &vte::PegMarkdownHighlighter::updateHighlight);
@@ -389,12 +402,10 @@ void MarkdownViewWindow::setupViewer()
 
     HtmlTemplateHelper::updateMarkdownViewerTemplate(markdownEditorConfig);
 
-    auto adapter = new EditorMarkdownViewerAdapter(nullptr, this);
-    m_viewer = new MarkdownViewer(adapter,
-                                  VNoteX::getInst().getThemeMgr().getBaseBackground(),
-                                  markdownEditorConfig.getZoomFactorInReadMode(),
-                                  this);
+    m_viewer = MarkdownViewerPool::getInst().checkOut(&m_viewerTemplateLoaded);
+    m_viewer->setZoomFactor(markdownEditorConfig.getZoomFactorInReadMode());
     m_splitter->addWidget(m_viewer);
+    auto adapter = this->adapter();
 
     // Status widget.
     {
@@ -495,11 +506,25 @@ void MarkdownViewWindow::syncViewerFromBuffer(bool p_syncPositionFromEditMode)
         // TODO: Check buffer for last position recover.
 
         // Use getPath() instead of getBasePath() to make in-page anchor work.
-        adapter()->reset();
-        m_viewer->setHtml(HtmlTemplateHelper::getMarkdownViewerTemplate(),
-                          PathUtils::pathToUrl(buffer->getContentPath()));
+        if (m_viewerTemplateLoaded) {
+            // Loaded by the pool. Just send the text.
+            m_viewerTemplateLoaded = false;
+            adapter()->setBaseUrl(PathUtils::pathToUrl(buffer->getContentPath()).toString());
+        } else {
+            adapter()->reset();
+            m_viewer->setHtml(HtmlTemplateHelper::getMarkdownViewerTemplate(),
+                              PathUtils::pathToUrl(buffer->getContentPath()));
+        }
+        if (!isReadMode() && !isLargeFileFeatureEnabled(LargeFileFeature::Preview)) {
+            // Defer rendering of a large file until entering read mode.
+            adapter()->setText(0, "", -1);
+            m_viewerBufferRevision = -1;
+            return;
+        }
+
         adapter()->setText(m_bufferRevision, buffer->getContent(), lineNumber);
     } else {
+        m_viewerTemplateLoaded = false;
         adapter()->reset();
         m_viewer->setHtml("");
         adapter()->setText(0, "", -1);
@@ -565,6 +590,29 @@ void MarkdownViewWindow::setBufferRevisionAfterInvalidation(int p_bufferRevision
     }
 }
 
+void MarkdownViewWindow::releaseViewer()
+{
+    if (!m_viewer) {
+        return;
+    }
+
+    auto adapter = this->adapter();
+    disconnect(m_viewer, nullptr, this, nullptr);
+    disconnect(adapter, nullptr, this, nullptr);
+    disconnect(m_previewHelper, nullptr, m_viewer, nullptr);
+    disconnect(adapter, nullptr, m_previewHelper, nullptr);
+    if (m_editor) {
+        disconnect(m_editor, nullptr, adapter, nullptr);
+        disconnect(adapter, nullptr, m_editor, nullptr);
+        disconnect(adapter, nullptr, m_editor->getHighlighter(), nullptr);
+    }
+    adapter->setBuffer(nullptr);
+
+    MarkdownViewerPool::getInst().checkIn(m_viewer);
+    m_viewer = nullptr;
+    m_viewerTemplateLoaded = false;
+}
+
 EditorMarkdownViewerAdapter *MarkdownViewWindow::adapter() const
 {
     if (m_viewer) {
@@ -708,6 +756,41 @@ void MarkdownViewWindow::detachFromBufferInternal()
     }
 }
 
+void MarkdownViewWindow::hibernateInternal()
+{
+    m_propogateEditorToBuffer = false;
+
+    if (m_textEditorStatusWidget) {
+        getMainStatusWidget()->removeWidget(m_textEditorStatusWidget.get());
+        m_textEditorStatusWidget->setParent(nullptr);
+        m_textEditorStatusWidget.reset();
+    }
+
+    if (m_viewerStatusWidget) {
+        getMainStatusWidget()->removeWidget(m_viewerStatusWidget.get());
+        m_viewerStatusWidget->setParent(nullptr);
+        m_viewerStatusWidget.reset();
+    }
+
+    // Editor and viewer will be set up again on demand by setModeInternal().
+    releaseViewer();
+
+    if (m_editor) {
+        m_editor->deleteLater();
+        m_editor = nullptr;
+    }
+
+    // PreviewHelper is bound to one editor.
+    m_previewHelper->deleteLater();
+    m_previewHelper = nullptr;
+    setupPreviewHelper();
+
+    m_mode = ViewWindowMode::Invalid;
+    m_previousMode = ViewWindowMode::Invalid;
+    m_textEditorBufferRevision = 0;
+    m_viewerBufferRevision = 0;
+}
+
 void MarkdownViewWindow::clearObsoleteImages()
 {
     const auto obsoleteImages = static_cast<MarkdownBuffer *>(getBuffer())->clearObsoleteImages();
@@ -917,7 +1000,7 @@ void MarkdownViewWindow::handleFileOpenParameters(const QSharedPointer<FileOpenP
         }
     } else {
         if (!p_twice || p_paras->m_forceMode) {
-            setMode(p_paras->m_mode);
+            setMode(p_paras->m_forceMode ? p_paras->m_mode : adjustModeForLargeFile(p_paras->m_mode));
         }
 
         scrollToLine(p_paras->m_lineNumber);
@@ -952,6 +1035,10 @@ void MarkdownViewWindow::openTwice(const QSharedPointer<FileOpenParameters> &p_p
 
 ViewWindowSession MarkdownViewWindow::saveSession() const
 {
+    if (isHibernated()) {
+        return getHibernatedSession();
+    }
+
     auto session = ViewWindow::saveSession();
     if (getBuffer()) {
         session.m_lineNumber = isReadMode() ? adapter()->getTopLineNumber()
@@ -1000,3 +1087,119 @@ QPoint MarkdownViewWindow::getFloatingWidgetPosition()
 {
     return TextViewWindowHelper::getFloatingWidgetPosition(this);
 }
+
+void MarkdownViewWindow::setupLargeFileAction(QToolBar *p_toolBar)
+{
+    Q_ASSERT(!m_largeFileAct);
+    m_largeFileAct = p_toolBar->addAction(tr("Large File"));
+    m_largeFileAct->setToolTip(tr("Some features are disabled for this large file. Enable them here."));
+
+    auto toolBtn = dynamic_cast<QToolButton *>(p_toolBar->widgetForAction(m_largeFileAct));
+    Q_ASSERT(toolBtn);
+    toolBtn->setPopupMode(QToolButton::InstantPopup);
+    toolBtn->setToolButtonStyle(Qt::ToolButtonTextOnly);
+
+    auto menu = WidgetsFactory::createMenu(p_toolBar);
+    auto addFeatureAction = [this, menu](const QString &p_text, LargeFileFeature p_feature) {
+        auto act = menu->addAction(p_text);
+        act->setCheckable(true);
+        act->setData(static_cast<int>(p_feature));
+        connect(act, &QAction::triggered,
+                this, [this, p_feature](bool p_checked) {
+                    setLargeFileFeatureEnabled(p_feature, p_checked);
+                });
+    };
+    addFeatureAction(tr("Preview"), LargeFileFeature::Preview);
+    addFeatureAction(tr("Code Block Preview"), LargeFileFeature::CodeBlockPreview);
+    addFeatureAction(tr("Math Preview"), LargeFileFeature::MathPreview);
+    addFeatureAction(tr("Section Number"), LargeFileFeature::SectionNumber);
+    m_largeFileAct->setMenu(menu);
+
+    m_largeFileAct->setVisible(false);
+}
+
+void MarkdownViewWindow::updateLargeFileMode()
+{
+    auto buffer = static_cast<MarkdownBuffer *>(getBuffer());
+    const bool wasLargeFile = m_largeFile;
+    m_largeFile = buffer && buffer->isLargeFile();
+    // Waking up from hibernation keeps the features enabled before.
+    m_largeFileFeatures = LargeFileFeatures(m_largeFile ? buffer->getLargeFileFeatures() : 0);
+
+    if (m_largeFile && !wasLargeFile) {
+        showMessage(tr("Large file mode: preview, in-place preview and section number are disabled"));
+    }
+
+    applyLargeFileFeatures();
+}
+
+bool MarkdownViewWindow::isLargeFileFeatureEnabled(LargeFileFeature p_feature) const
+{
+    return !m_largeFile || m_largeFileFeatures.testFlag(p_feature);
+}
+
+void MarkdownViewWindow::setLargeFileFeatureEnabled(LargeFileFeature p_feature, bool p_enabled)
+{
+    if (!m_largeFile || m_largeFileFeatures.testFlag(p_feature) == p_enabled) {
+        return;
+    }
+
+    m_largeFileFeatures.setFlag(p_feature, p_enabled);
+    static_cast<MarkdownBuffer *>(getBuffer())->setLargeFileFeatures(static_cast<int>(m_largeFileFeatures));
+    applyLargeFileFeatures();
+
+    if (!p_enabled) {
+        return;
+    }
+
+    switch (p_feature) {
+    case LargeFileFeature::Preview:
+        // Render the deferred content.
+        if (m_viewer && getBuffer()) {
+            syncViewerFromBufferContent(false);
+        }
+        break;
+
+    case LargeFileFeature::CodeBlockPreview:
+        Q_FALLTHROUGH();
+    case LargeFileFeature::MathPreview:
+        if (m_editor) {
+            m_editor->getHighlighter()->updateHighlight();
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+void MarkdownViewWindow::applyLargeFileFeatures()
+{
+    m_previewHelper->setInplacePreviewSourcesEnabled(PreviewHelper::SourceFlag::FlowChart
+                                                     | PreviewHelper::SourceFlag::Mermaid
+                                                     | PreviewHelper::SourceFlag::WaveDrom
+                                                     | PreviewHelper::SourceFlag::PlantUml
+                                                     | PreviewHelper::SourceFlag::Graphviz,
+                                                     isLargeFileFeatureEnabled(LargeFileFeature::CodeBlockPreview));
+    m_previewHelper->setInplacePreviewSourcesEnabled(PreviewHelper::SourceFlag::Math,
+                                                     isLargeFileFeatureEnabled(LargeFileFeature::MathPreview));
+
+    if (m_editor) {
+        m_editor->suspendSectionNumber(!isLargeFileFeatureEnabled(LargeFileFeature::SectionNumber));
+    }
+
+    m_largeFileAct->setVisible(m_largeFile);
+    const auto actions = m_largeFileAct->menu()->actions();
+    for (auto act : actions) {
+        act->setChecked(m_largeFileFeatures.testFlag(static_cast<LargeFileFeature>(act->data().toInt())));
+    }
+}
+
+ViewWindowMode MarkdownViewWindow::adjustModeForLargeFile(ViewWindowMode p_mode) const
+{
+    if (p_mode == ViewWindowMode::Read && !isLargeFileFeatureEnabled(LargeFileFeature::Preview)) {
+        return ViewWindowMode::Edit;
+    }
+
+    return p_mode;
+}
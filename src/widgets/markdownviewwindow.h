@@ -7,6 +7,8 @@
 
 class QSplitter;
 class QStackedWidget;
+class QAction;
+class QToolBar;
 
 namespace vte
 {
@@ -81,6 +83,8 @@ namespace vnotex
 
         void detachFromBufferInternal() Q_DECL_OVERRIDE;
 
+        void hibernateInternal() Q_DECL_OVERRIDE;
+
         void scrollUp() Q_DECL_OVERRIDE;
 
         void scrollDown() Q_DECL_OVERRIDE;
@@ -90,6 +94,17 @@ namespace vnotex
         QPoint getFloatingWidgetPosition() Q_DECL_OVERRIDE;
 
     private:
+        // Expensive features disabled in large file mode until enabled for the file.
+        enum LargeFileFeature
+        {
+            // Keep the viewer in sync with the buffer out of read mode, and open in read mode.
+            Preview = 0x1,
+            CodeBlockPreview = 0x2,
+            MathPreview = 0x4,
+            SectionNumber = 0x8
+        };
+        Q_DECLARE_FLAGS(LargeFileFeatures, LargeFileFeature);
+
         void setupUI();
 
         void setupToolBar();
@@ -103,6 +118,9 @@ namespace vnotex
 
         void setupViewer();
 
+        // Give the viewer back to MarkdownViewerPool.
+        void releaseViewer();
+
         void setupPreviewHelper();
 
         void syncTextEditorFromBuffer(bool p_syncPositionFromReadMode);
@@ -145,6 +163,21 @@ namespace vnotex
 
         bool isReadMode() const;
 
+        void setupLargeFileAction(QToolBar *p_toolBar);
+
+        // Enter or leave large file mode according to current buffer.
+        void updateLargeFileMode();
+
+        bool isLargeFileFeatureEnabled(LargeFileFeature p_feature) const;
+
+        void setLargeFileFeatureEnabled(LargeFileFeature p_feature, bool p_enabled);
+
+        // Apply the state of large file features to the editor, the preview helper and the indicator.
+        void applyLargeFileFeatures();
+
+        // Mode to open current buffer in if @p_mode is requested.
+        ViewWindowMode adjustModeForLargeFile(ViewWindowMode p_mode) const;
+
         template <class T>
         static QSharedPointer<Outline> headingsToOutline(const QVector<T> &p_headings);
 
@@ -177,10 +210,21 @@ namespace vnotex
 
         int m_viewerBufferRevision = 0;
 
+        // Whether the viewer template is loaded in the viewer checked out from the pool.
+        bool m_viewerTemplateLoaded = false;
+
         int m_markdownEditorConfigRevision = 0;
 
         ViewWindowMode m_previousMode = ViewWindowMode::Invalid;
 
+        bool m_largeFile = false;
+
+        // Features enabled by user in large file mode.
+        LargeFileFeatures m_largeFileFeatures;
+
+        // Indicator of large file mode with a menu to enable features.
+        QAction *m_largeFileAct = nullptr;
+
         QSharedPointer<OutlineProvider> m_outlineProvider;
     };
 }
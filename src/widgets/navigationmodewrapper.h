@@ -8,9 +8,11 @@
 
 #include <QListWidgetItem>
 #include <QTreeWidgetItem>
+#include <QPersistentModelIndex>
 
 #include "listwidget.h"
 #include "treewidget.h"
+#include "treeview.h"
 
 namespace vnotex
 {
@@ -95,6 +97,68 @@ namespace vnotex
     {
         return ListWidget::getVisibleItems(m_widget);
     }
+
+    // Wrapper for QTreeView, whose items are model indexes instead of pointers.
+    class TreeViewNavigationModeWrapper : public NavigationMode
+    {
+    public:
+        TreeViewNavigationModeWrapper(QTreeView *p_view)
+            : NavigationMode(NavigationMode::Type::DoubleKeys, p_view),
+              m_view(p_view)
+        {
+        }
+
+    // NavigationMode.
+    protected:
+        QVector<void *> getVisibleNavigationItems() Q_DECL_OVERRIDE
+        {
+            m_indexes.clear();
+            const auto indexes = TreeView::getVisibleIndexes(m_view);
+            for (const auto &idx : indexes) {
+                m_indexes.append(idx);
+            }
+
+            // Pointers are valid until next call.
+            QVector<void *> items;
+            items.reserve(m_indexes.size());
+            for (auto &idx : m_indexes) {
+                items.push_back(&idx);
+            }
+            return items;
+        }
+
+        void placeNavigationLabel(int p_idx, void *p_item, QLabel *p_label) Q_DECL_OVERRIDE
+        {
+            Q_UNUSED(p_idx);
+            Q_ASSERT(p_item);
+
+            int extraWidth = p_label->width() + 2;
+            auto vbar = m_view->verticalScrollBar();
+            if (vbar && vbar->minimum() != vbar->maximum()) {
+                extraWidth += vbar->width();
+            }
+
+            const auto rt = m_view->visualRect(*static_cast<QPersistentModelIndex *>(p_item));
+            const int x = rt.x() + m_view->width() - extraWidth;
+            const int y = rt.y();
+            p_label->move(x, y);
+        }
+
+        void handleTargetHit(void *p_item) Q_DECL_OVERRIDE
+        {
+            Q_ASSERT(p_item);
+            const QModelIndex idx = *static_cast<QPersistentModelIndex *>(p_item);
+            if (idx.isValid()) {
+                m_view->setCurrentIndex(idx);
+            }
+            m_view->setFocus();
+        }
+
+    private:
+        QTreeView *m_view = nullptr;
+
+        QVector<QPersistentModelIndex> m_indexes;
+    };
 }
 
 #endif // NAVIGATIONMODEWRAPPER_H
@@ -173,6 +173,9 @@ void NotebookExplorer::loadNotebooks()
     const auto &notebooks = notebookMgr.getNotebooks();
     m_selector->setNotebooks(notebooks);
 
+    // Notebooks may be added while current one stays the same.
+    m_selector->setCurrentNotebook(m_currentNotebook ? m_currentNotebook->getId() : static_cast<ID>(Notebook::InvalidId));
+
     emit updateTitleBarMenuActions();
 }
 
@@ -1,6 +1,5 @@
 #include "notebooknodeexplorer.h"
 
-#include <QTreeWidget>
 #include <QVBoxLayout>
 #include <QSplitter>
 #include <QTreeWidget>
@@ -8,6 +7,8 @@
 #include <QAction>
 #include <QSet>
 #include <QShortcut>
+#include <QItemSelectionModel>
+#include <QDebug>
 
 #include <notebook/notebook.h>
 #include <notebook/node.h>
@@ -19,7 +20,8 @@
 #include <utils/iconutils.h>
 #include <utils/docsutils.h>
 #include <utils/processutils.h>
-#include "treewidget.h"
+#include "treeview.h"
+#include "notebooknodemodel.h"
 #include "dialogs/notepropertiesdialog.h"
 #include "dialogs/folderpropertiesdialog.h"
 #include "dialogs/deleteconfirmdialog.h"
@@ -36,91 +38,26 @@
 #include <core/configmgr.h>
 #include <core/coreconfig.h>
 #include <core/sessionconfig.h>
+#include <core/fileoperationqueue.h>
 
 using namespace vnotex;
 
-QIcon NotebookNodeExplorer::s_folderNodeIcon;
-
-QIcon NotebookNodeExplorer::s_fileNodeIcon;
-
-QIcon NotebookNodeExplorer::s_invalidFolderNodeIcon;
-
-QIcon NotebookNodeExplorer::s_invalidFileNodeIcon;
-
-QIcon NotebookNodeExplorer::s_recycleBinNodeIcon;
-
-QIcon NotebookNodeExplorer::s_externalFolderNodeIcon;
-
-QIcon NotebookNodeExplorer::s_externalFileNodeIcon;
-
 NotebookNodeExplorer::NodeData::NodeData()
 {
 }
 
-NotebookNodeExplorer::NodeData::NodeData(Node *p_node, bool p_loaded)
+NotebookNodeExplorer::NodeData::NodeData(Node *p_node)
     : m_type(NodeType::Node),
-      m_node(p_node),
-      m_loaded(p_loaded)
+      m_node(p_node)
 {
 }
 
 NotebookNodeExplorer::NodeData::NodeData(const QSharedPointer<ExternalNode> &p_externalNode)
     : m_type(NodeType::ExternalNode),
-      m_externalNode(p_externalNode),
-      m_loaded(true)
+      m_externalNode(p_externalNode)
 {
 }
 
-NotebookNodeExplorer::NodeData::NodeData(const NodeData &p_other)
-{
-    m_type = p_other.m_type;
-    switch (m_type) {
-    case NodeType::Node:
-        m_node = p_other.m_node;
-        break;
-
-    case NodeType::ExternalNode:
-        m_externalNode = p_other.m_externalNode;
-        break;
-
-    default:
-        Q_ASSERT(false);
-        break;
-    }
-
-    m_loaded = p_other.m_loaded;
-}
-
-NotebookNodeExplorer::NodeData::~NodeData()
-{
-}
-
-NotebookNodeExplorer::NodeData &NotebookNodeExplorer::NodeData::operator=(const NodeData &p_other)
-{
-    if (&p_other == this) {
-        return *this;
-    }
-
-    m_type = p_other.m_type;
-    switch (m_type) {
-    case NodeType::Node:
-        m_node = p_other.m_node;
-        break;
-
-    case NodeType::ExternalNode:
-        m_externalNode = p_other.m_externalNode;
-        break;
-
-    default:
-        Q_ASSERT(false);
-        break;
-    }
-
-    m_loaded = p_other.m_loaded;
-
-    return *this;
-}
-
 bool NotebookNodeExplorer::NodeData::isValid() const
 {
     return m_type != NodeType::Invalid;
@@ -158,7 +95,6 @@ void NotebookNodeExplorer::NodeData::clear()
     m_type = NodeType::Invalid;
     m_node = nullptr;
     m_externalNode.clear();
-    m_loaded = false;
 }
 
 bool NotebookNodeExplorer::NodeData::matched(const Node *p_node) const
@@ -170,50 +106,22 @@ bool NotebookNodeExplorer::NodeData::matched(const Node *p_node) const
     return false;
 }
 
-bool NotebookNodeExplorer::NodeData::isLoaded() const
+
+void NotebookNodeExplorer::TreeState::clear()
 {
-    return m_loaded;
+    m_expandedNodes.clear();
+    m_currentNode = nullptr;
 }
 
 
 NotebookNodeExplorer::NotebookNodeExplorer(QWidget *p_parent)
     : QWidget(p_parent)
 {
-    initNodeIcons();
-
     setupUI();
 
     setupShortcuts();
 }
 
-void NotebookNodeExplorer::initNodeIcons() const
-{
-    if (!s_folderNodeIcon.isNull()) {
-        return;
-    }
-
-    const QString nodeIconFgName = "widgets#notebookexplorer#node_icon#fg";
-    const QString invalidNodeIconFgName = "widgets#notebookexplorer#node_icon#invalid#fg";
-    const QString externalNodeIconFgName = "widgets#notebookexplorer#external_node_icon#fg";
-
-    const auto &themeMgr = VNoteX::getInst().getThemeMgr();
-    const auto fg = themeMgr.paletteColor(nodeIconFgName);
-    const auto invalidFg = themeMgr.paletteColor(invalidNodeIconFgName);
-    const auto externalFg = themeMgr.paletteColor(externalNodeIconFgName);
-
-    const QString folderIconName("folder_node.svg");
-    const QString fileIconName("file_node.svg");
-    const QString recycleBinIconName("recycle_bin.svg");
-
-    s_folderNodeIcon = IconUtils::fetchIcon(themeMgr.getIconFile(folderIconName), fg);
-    s_fileNodeIcon = IconUtils::fetchIcon(themeMgr.getIconFile(fileIconName), fg);
-    s_invalidFolderNodeIcon = IconUtils::fetchIcon(themeMgr.getIconFile(folderIconName), invalidFg);
-    s_invalidFileNodeIcon = IconUtils::fetchIcon(themeMgr.getIconFile(fileIconName), invalidFg);
-    s_recycleBinNodeIcon = IconUtils::fetchIcon(themeMgr.getIconFile(recycleBinIconName), fg);
-    s_externalFolderNodeIcon = IconUtils::fetchIcon(themeMgr.getIconFile(folderIconName), externalFg);
-    s_externalFileNodeIcon = IconUtils::fetchIcon(themeMgr.getIconFile(fileIconName), externalFg);
-}
-
 void NotebookNodeExplorer::setupUI()
 {
     auto mainLayout = new QVBoxLayout(this);
@@ -230,28 +138,31 @@ void NotebookNodeExplorer::setupUI()
 
 void NotebookNodeExplorer::setupMasterExplorer(QWidget *p_parent)
 {
-    m_masterExplorer = new TreeWidget(TreeWidget::ClickSpaceToClearSelection, p_parent);
-    TreeWidget::setupSingleColumnHeaderlessTree(m_masterExplorer, true, true);
-    TreeWidget::showHorizontalScrollbar(m_masterExplorer);
+    m_model = new NotebookNodeModel(this);
 
-    m_navigationWrapper.reset(new NavigationModeWrapper<QTreeWidget, QTreeWidgetItem>(m_masterExplorer));
+    m_masterExplorer = new TreeView(TreeView::ClickSpaceToClearSelection, p_parent);
+    m_masterExplorer->setModel(m_model);
+    TreeView::setupSingleColumnHeaderlessTree(m_masterExplorer, true, true);
+    TreeView::showHorizontalScrollbar(m_masterExplorer);
+
+    m_navigationWrapper.reset(new TreeViewNavigationModeWrapper(m_masterExplorer));
     NavigationModeMgr::getInst().registerNavigationTarget(m_navigationWrapper.data());
 
-    connect(m_masterExplorer, &QTreeWidget::itemExpanded,
-            this, &NotebookNodeExplorer::loadItemChildren);
+    connect(m_model, &QAbstractItemModel::rowsInserted,
+            this, &NotebookNodeExplorer::expandPendingNodes);
 
-    connect(m_masterExplorer, &QTreeWidget::customContextMenuRequested,
+    connect(m_masterExplorer, &QTreeView::customContextMenuRequested,
             this, [this](const QPoint &p_pos) {
                 if (!m_notebook) {
                     return;
                 }
 
-                auto item = m_masterExplorer->itemAt(p_pos);
-                auto data = getItemNodeData(item);
+                const auto idx = m_masterExplorer->indexAt(p_pos);
+                auto data = NotebookNodeModel::nodeData(idx);
                 QScopedPointer<QMenu> menu(WidgetsFactory::createMenu());
-                if (!data.isValid()) {
+                if (!idx.isValid()) {
                     createContextMenuOnRoot(menu.data());
-                } else {
+                } else if (data.isValid()) {
                     if (!allSelectedItemsSameType()) {
                         return;
                     }
@@ -268,10 +179,9 @@ void NotebookNodeExplorer::setupMasterExplorer(QWidget *p_parent)
                 }
             });
 
-    connect(m_masterExplorer, &QTreeWidget::itemActivated,
-            this, [this](QTreeWidgetItem *p_item, int p_column) {
-                Q_UNUSED(p_column);
-                auto data = getItemNodeData(p_item);
+    connect(m_masterExplorer, &QTreeView::activated,
+            this, [this](const QModelIndex &p_index) {
+                auto data = NotebookNodeModel::nodeData(p_index);
                 if (!data.isValid()) {
                     return;
                 }
@@ -322,23 +232,12 @@ void NotebookNodeExplorer::setNotebook(const QSharedPointer<Notebook> &p_noteboo
     generateNodeTree();
 }
 
-void NotebookNodeExplorer::clearExplorer()
-{
-    m_masterExplorer->clear();
-}
-
 void NotebookNodeExplorer::generateNodeTree()
 {
-    clearExplorer();
-
-    if (!m_notebook) {
-        return;
-    }
+    m_pendingExpandNodes.clear();
 
     try {
-        auto rootNode = m_notebook->getRootNode();
-
-        loadRootNode(rootNode.data());
+        m_model->setNotebook(m_notebook);
     } catch (Exception &p_e) {
         QString msg = tr("Failed to load nodes of notebook (%1) (%2).")
                         .arg(m_notebook->getName(), p_e.what());
@@ -346,407 +245,154 @@ void NotebookNodeExplorer::generateNodeTree()
         MessageBoxHelper::notify(MessageBoxHelper::Critical, msg, VNoteX::getInst().getMainWindow());
     }
 
-    // Restore current item.
-    auto currentNode = stateCache()->getCurrentItem();
-
-    if (currentNode) {
-        setCurrentNode(currentNode);
-    } else {
-        // Do not focus the recycle bin.
-        focusNormalNode();
+    if (!m_notebook) {
+        return;
     }
 
-    stateCache()->clear();
+    restoreNotebookTreeState(true);
 }
 
-void NotebookNodeExplorer::loadRootNode(const Node *p_node) const
+Node *NotebookNodeExplorer::getCurrentNode() const
 {
-    Q_ASSERT(p_node->isLoaded() && p_node->isContainer());
-
-    // Render recycle bin node first.
-    auto recycleBinNode = m_notebook->getRecycleBinNode();
-    if (recycleBinNode) {
-        loadRecycleBinNode(recycleBinNode.data());
-    }
-
-    // External children.
-    if (m_externalFilesVisible) {
-        auto externalChildren = p_node->fetchExternalChildren();
-        // TODO: Sort external children.
-        for (const auto &child : externalChildren) {
-            auto item = new QTreeWidgetItem(m_masterExplorer);
-            loadNode(item, child);
-        }
-    }
-
-    // Children.
-    auto children = p_node->getChildren();
-    sortNodes(children);
-    for (const auto &child : children) {
-        if (recycleBinNode == child) {
-            continue;
+    auto idx = m_masterExplorer->currentIndex();
+    while (idx.isValid()) {
+        auto data = NotebookNodeModel::nodeData(idx);
+        if (data.isNode()) {
+            return data.getNode();
         }
 
-        auto item = new QTreeWidgetItem(m_masterExplorer);
-        loadNode(item, child.data(), 1);
+        idx = idx.parent();
     }
-}
-
-static void clearTreeWigetItemChildren(QTreeWidgetItem *p_item)
-{
-    auto children = p_item->takeChildren();
-    for (auto &child : children) {
-        delete child;
-    }
-}
-
-void NotebookNodeExplorer::loadNode(QTreeWidgetItem *p_item, Node *p_node, int p_level) const
-{
-    if (!p_node->isLoaded()) {
-        p_node->load();
-    }
-
-    clearTreeWigetItemChildren(p_item);
-
-    fillTreeItem(p_item, p_node, p_level > 0);
-
-    loadChildren(p_item, p_node, p_level - 1);
-
-    if (stateCache()->contains(p_item) && p_item->childCount() > 0) {
-        if (p_item->isExpanded()) {
-            loadItemChildren(p_item);
-        } else {
-            // itemExpanded() will trigger loadItemChildren().
-            p_item->setExpanded(true);
-        }
-    }
-}
-
-void NotebookNodeExplorer::loadNode(QTreeWidgetItem *p_item, const QSharedPointer<ExternalNode> &p_node) const
-{
-    clearTreeWigetItemChildren(p_item);
 
-    fillTreeItem(p_item, p_node);
-
-    // No children for external node.
+    return nullptr;
 }
 
-void NotebookNodeExplorer::loadChildren(QTreeWidgetItem *p_item, Node *p_node, int p_level) const
+void NotebookNodeExplorer::updateNode(Node *p_node)
 {
-    if (p_level < 0) {
+    if (p_node && p_node->getNotebook() != m_notebook) {
         return;
     }
 
-    // External children.
-    if (m_externalFilesVisible && p_node->isContainer()) {
-        auto externalChildren = p_node->fetchExternalChildren();
-        // TODO: Sort external children.
-        for (const auto &child : externalChildren) {
-            auto item = new QTreeWidgetItem(p_item);
-            loadNode(item, child);
-        }
-    }
-
-    auto children = p_node->getChildren();
-    sortNodes(children);
-    for (const auto &child : children) {
-        auto item = new QTreeWidgetItem(p_item);
-        loadNode(item, child.data(), p_level);
-    }
-}
-
-void NotebookNodeExplorer::loadRecycleBinNode(Node *p_node) const
-{
-    if (!m_recycleBinNodeVisible) {
+    if (!m_notebook) {
         return;
     }
 
-    auto item = new QTreeWidgetItem();
-    item->setWhatsThis(Column::Name,
-                       tr("Recycle bin of this notebook. Deleted files could be found here. "
-                          "It is organized in folders named by date. Nodes could be moved to "
-                          "other folders by Cut and Paste."));
-    m_masterExplorer->insertTopLevelItem(0, item);
-
-    loadRecycleBinNode(item, p_node, 1);
-}
-
-void NotebookNodeExplorer::loadRecycleBinNode(QTreeWidgetItem *p_item, Node *p_node, int p_level) const
-{
-    if (!m_recycleBinNodeVisible) {
+    if (!p_node) {
+        // The whole tree may be rebuilt if nodes are reloaded.
+        saveNotebookTreeState(false);
+        m_model->updateNode(nullptr);
+        restoreNotebookTreeState(false);
         return;
     }
 
-    if (!p_node->isLoaded()) {
-        p_node->load();
-    }
-
-    clearTreeWigetItemChildren(p_item);
-
-    setItemNodeData(p_item, NodeData(p_node, true));
-    p_item->setText(Column::Name, tr("Recycle Bin"));
-    p_item->setIcon(Column::Name, getNodeItemIcon(p_node));
-
-    loadChildren(p_item, p_node, p_level - 1);
-
-    // No need to restore state.
-}
-
-void NotebookNodeExplorer::fillTreeItem(QTreeWidgetItem *p_item, Node *p_node, bool p_loaded) const
-{
-    setItemNodeData(p_item, NodeData(p_node, p_loaded));
-    p_item->setText(Column::Name, p_node->getName());
-    p_item->setIcon(Column::Name, getNodeItemIcon(p_node));
-    p_item->setToolTip(Column::Name, p_node->exists() ? p_node->getName() : (tr("[Invalid] %1").arg(p_node->getName())));
-}
-
-void NotebookNodeExplorer::fillTreeItem(QTreeWidgetItem *p_item, const QSharedPointer<ExternalNode> &p_node) const
-{
-    setItemNodeData(p_item, NodeData(p_node));
-    p_item->setText(Column::Name, p_node->getName());
-    p_item->setIcon(Column::Name, getNodeItemIcon(p_node.data()));
-    p_item->setToolTip(Column::Name, tr("[External] %1").arg(p_node->getName()));
+    m_model->updateNode(p_node);
 }
 
-const QIcon &NotebookNodeExplorer::getNodeItemIcon(const Node *p_node) const
+void NotebookNodeExplorer::setCurrentNode(Node *p_node)
 {
-    if (p_node->hasContent()) {
-        return p_node->exists() ? s_fileNodeIcon : s_invalidFileNodeIcon;
-    } else {
-        if (p_node->getUse() == Node::Use::RecycleBin) {
-            return s_recycleBinNodeIcon;
-        }
-
-        return p_node->exists() ? s_folderNodeIcon : s_invalidFolderNodeIcon;
+    if (!p_node || !p_node->getParent()) {
+        m_masterExplorer->setCurrentIndex(QModelIndex());
+        return;
     }
-}
 
-const QIcon &NotebookNodeExplorer::getNodeItemIcon(const ExternalNode *p_node) const
-{
-    return p_node->isFolder() ? s_externalFolderNodeIcon : s_externalFileNodeIcon;
-}
-
-Node *NotebookNodeExplorer::getCurrentNode() const
-{
-    auto item = m_masterExplorer->currentItem();
-    if (item) {
-        auto data = getItemNodeData(item);
-        while (item && !data.isNode()) {
-            item = item->parent();
-            if (item) {
-                data = getItemNodeData(item);
-            } else {
-                data.clear();
-            }
-        }
+    Q_ASSERT(p_node->getNotebook() == m_notebook);
 
-        if (data.isNode()) {
-            return data.getNode();
-        }
+    const auto idx = m_model->fetchIndexOfNode(p_node);
+    if (!idx.isValid()) {
+        return;
     }
 
-    return nullptr;
-}
-
-void NotebookNodeExplorer::setItemNodeData(QTreeWidgetItem *p_item, const NodeData &p_data)
-{
-    p_item->setData(Column::Name, Qt::UserRole, QVariant::fromValue(p_data));
-}
-
-NotebookNodeExplorer::NodeData NotebookNodeExplorer::getItemNodeData(const QTreeWidgetItem *p_item)
-{
-    if (!p_item) {
-        return NodeData();
+    // Do not expand the node itself.
+    for (auto parentIdx = idx.parent(); parentIdx.isValid(); parentIdx = parentIdx.parent()) {
+        m_masterExplorer->expand(parentIdx);
     }
 
-    return p_item->data(Column::Name, Qt::UserRole).value<NotebookNodeExplorer::NodeData>();
+    m_masterExplorer->setCurrentIndex(idx);
+    m_masterExplorer->scrollTo(idx);
 }
 
-void NotebookNodeExplorer::updateNode(Node *p_node)
+void NotebookNodeExplorer::saveNotebookTreeState(bool p_saveCurrentNode)
 {
-    if (p_node && p_node->getNotebook() != m_notebook) {
+    if (!m_notebook) {
         return;
     }
 
-    auto item = findNode(p_node);
-    if (item) {
-        bool expanded = item->isExpanded();
-        item->setExpanded(false);
-
-        if (m_notebook->isRecycleBinNode(p_node)) {
-            loadRecycleBinNode(item, p_node, 1);
-        } else {
-            loadNode(item, p_node, 1);
-        }
-
-        item->setExpanded(expanded);
-    } else {
-        if (m_notebook->isRecycleBinNode(p_node) && !m_recycleBinNodeVisible) {
-            // No need to update.
-            return;
-        }
-
-        saveNotebookTreeState(false);
-
-        generateNodeTree();
+    auto &state = stateCache();
+    state.clear();
+    saveExpandedNodes(QModelIndex(), state.m_expandedNodes);
+    if (p_saveCurrentNode) {
+        state.m_currentNode = getCurrentNode();
     }
 }
 
-QTreeWidgetItem *NotebookNodeExplorer::findNode(const Node *p_node) const
+void NotebookNodeExplorer::saveExpandedNodes(const QModelIndex &p_parent, QSet<const Node *> &p_nodes) const
 {
-    if (!p_node) {
-        return nullptr;
-    }
-
-    auto cnt = m_masterExplorer->topLevelItemCount();
+    const int cnt = m_model->rowCount(p_parent);
     for (int i = 0; i < cnt; ++i) {
-        auto item = findNode(m_masterExplorer->topLevelItem(i), p_node);
-        if (item) {
-            return item;
+        const auto idx = m_model->index(i, 0, p_parent);
+        if (!m_masterExplorer->isExpanded(idx)) {
+            continue;
         }
-    }
-
-    return nullptr;
-}
-
-QTreeWidgetItem *NotebookNodeExplorer::findNode(QTreeWidgetItem *p_item, const Node *p_node) const
-{
-    auto data = getItemNodeData(p_item);
-    if (data.matched(p_node)) {
-        return p_item;
-    }
 
-    auto cnt = p_item->childCount();
-    for (int i = 0; i < cnt; ++i) {
-        auto item = findNode(p_item->child(i), p_node);
-        if (item) {
-            return item;
+        auto data = NotebookNodeModel::nodeData(idx);
+        if (data.isNode()) {
+            p_nodes.insert(data.getNode());
         }
-    }
 
-    return nullptr;
+        saveExpandedNodes(idx, p_nodes);
+    }
 }
 
-QTreeWidgetItem *NotebookNodeExplorer::findNodeChild(QTreeWidgetItem *p_item, const Node *p_node) const
+void NotebookNodeExplorer::restoreNotebookTreeState(bool p_restoreCurrentNode)
 {
-    auto cnt = p_item->childCount();
-    for (int i = 0; i < cnt; ++i) {
-        auto child = p_item->child(i);
-        auto data = getItemNodeData(child);
-        if (data.matched(p_node)) {
-            return child;
-        }
-    }
+    auto &state = stateCache();
 
-    return nullptr;
-}
+    m_pendingExpandNodes = state.m_expandedNodes;
+    expandPendingNodes(QModelIndex(), 0, m_model->rowCount() - 1);
 
-QTreeWidgetItem *NotebookNodeExplorer::findNodeTopLevelItem(QTreeWidget *p_tree, const Node *p_node) const
-{
-    auto cnt = p_tree->topLevelItemCount();
-    for (int i = 0; i < cnt; ++i) {
-        auto child = p_tree->topLevelItem(i);
-        auto data = getItemNodeData(child);
-        if (data.matched(p_node)) {
-            return child;
+    if (p_restoreCurrentNode) {
+        if (state.m_currentNode) {
+            setCurrentNode(state.m_currentNode);
+        } else {
+            // Do not focus the recycle bin.
+            focusNormalNode();
         }
     }
 
-    return nullptr;
+    state.clear();
 }
 
-void NotebookNodeExplorer::setCurrentNode(Node *p_node)
+void NotebookNodeExplorer::expandPendingNodes(const QModelIndex &p_parent, int p_first, int p_last)
 {
-    if (!p_node || !p_node->getParent()) {
-        m_masterExplorer->setCurrentItem(nullptr);
-        return;
-    }
-
-    Q_ASSERT(p_node->getNotebook() == m_notebook);
-
-    // Nodes from root to p_node.
-    QList<Node *> nodes;
-    auto node = p_node;
-    while (node->getParent()) {
-        nodes.push_front(node);
-        node = node->getParent();
-    }
-
-    QList<QTreeWidgetItem *> items;
-    auto nodeIt = nodes.constBegin();
-    auto item = findNodeTopLevelItem(m_masterExplorer, *nodeIt);
-    if (!item) {
+    if (m_pendingExpandNodes.isEmpty()) {
         return;
     }
-    items.push_back(item);
-
-    ++nodeIt;
-    while (nodeIt != nodes.constEnd()) {
-        if (!item) {
-            return;
-        }
-
-        // Find *nodeIt in children of item.
-        auto data = getItemNodeData(item);
-        Q_ASSERT(data.isNode());
-        if (!data.isLoaded()) {
-            loadNode(item, data.getNode(), 1);
-        }
 
-        auto childItem = findNodeChild(item, *nodeIt);
-        if (!childItem) {
-            return;
+    for (int i = p_first; i <= p_last; ++i) {
+        const auto idx = m_model->index(i, 0, p_parent);
+        auto data = NotebookNodeModel::nodeData(idx);
+        if (!data.isNode() || !m_pendingExpandNodes.remove(data.getNode())) {
+            continue;
         }
-        items.push_back(childItem);
-
-        item = childItem;
-        ++nodeIt;
-    }
-
-    Q_ASSERT(getItemNodeData(item).getNode() == p_node);
-
-    // Do not expand the last item.
-    for (int i = 0; i < items.size() - 1; ++i) {
-        items[i]->setExpanded(true);
-    }
-
-    m_masterExplorer->setCurrentItem(item);
-}
 
-void NotebookNodeExplorer::saveNotebookTreeState(bool p_saveCurrentItem)
-{
-    if (m_notebook) {
-        stateCache()->save(m_masterExplorer, p_saveCurrentItem);
+        // Children fetched in background will be handled once inserted.
+        m_model->fetchChildren(idx, true);
+        m_masterExplorer->expand(idx);
+        expandPendingNodes(idx, 0, m_model->rowCount(idx) - 1);
     }
 }
 
-QSharedPointer<QTreeWidgetStateCache<Node *>> NotebookNodeExplorer::stateCache() const
+NotebookNodeExplorer::TreeState &NotebookNodeExplorer::stateCache()
 {
     Q_ASSERT(m_notebook);
-    auto it = m_stateCache.find(m_notebook.data());
-    if (it == m_stateCache.end()) {
-        auto keyFunc = [](const QTreeWidgetItem *p_item, bool &p_ok) {
-                           auto data = NotebookNodeExplorer::getItemNodeData(p_item);
-                           if (data.isNode()) {
-                               p_ok = true;
-                               return data.getNode();
-                           }
-
-                           p_ok = false;
-                           return static_cast<Node *>(nullptr);
-                       };
-        auto cache = QSharedPointer<QTreeWidgetStateCache<Node *>>::create(keyFunc);
-        it = const_cast<NotebookNodeExplorer *>(this)->m_stateCache.insert(m_notebook.data(), cache);
-    }
-
-    return it.value();
+    return m_stateCache[m_notebook.data()];
 }
 
 void NotebookNodeExplorer::clearStateCache(const Notebook *p_notebook)
 {
     auto it = m_stateCache.find(p_notebook);
     if (it != m_stateCache.end()) {
-        it.value()->clear();
+        it.value().clear();
     }
 }
 
@@ -778,7 +424,7 @@ void NotebookNodeExplorer::createContextMenuOnRoot(QMenu *p_menu)
 
 void NotebookNodeExplorer::createContextMenuOnNode(QMenu *p_menu, const Node *p_node)
 {
-    const int selectedSize = m_masterExplorer->selectedItems().size();
+    const int selectedSize = m_masterExplorer->selectionModel()->selectedRows().size();
     QAction *act = nullptr;
 
     if (m_notebook->isRecycleBinNode(p_node)) {
@@ -912,7 +558,7 @@ void NotebookNodeExplorer::createContextMenuOnExternalNode(QMenu *p_menu, const
 {
     Q_UNUSED(p_node);
 
-    const int selectedSize = m_masterExplorer->selectedItems().size();
+    const int selectedSize = m_masterExplorer->selectionModel()->selectedRows().size();
     QAction *act = nullptr;
 
     act = createAction(Action::Open, p_menu);
@@ -1003,15 +649,15 @@ QAction *NotebookNodeExplorer::createAction(Action p_act, QObject *p_parent)
         act = new QAction(tr("Open &Location"), p_parent);
         connect(act, &QAction::triggered,
                 this, [this]() {
-                    auto item = m_masterExplorer->currentItem();
-                    if (!item) {
+                    const auto idx = m_masterExplorer->currentIndex();
+                    if (!idx.isValid()) {
                         if (m_notebook) {
                             auto locationPath = m_notebook->getRootFolderAbsolutePath();
                             WidgetUtils::openUrlByDesktop(QUrl::fromLocalFile(locationPath));
                         }
                         return;
                     }
-                    auto data = getItemNodeData(item);
+                    auto data = NotebookNodeModel::nodeData(idx);
                     QString locationPath;
                     if (data.isNode()) {
                         auto node = data.getNode();
@@ -1041,11 +687,7 @@ QAction *NotebookNodeExplorer::createAction(Action p_act, QObject *p_parent)
         act = new QAction(tr("Cop&y Path"), p_parent);
         connect(act, &QAction::triggered,
                 this, [this]() {
-                    auto item = m_masterExplorer->currentItem();
-                    if (!item) {
-                        return;
-                    }
-                    auto data = getItemNodeData(item);
+                    auto data = NotebookNodeModel::nodeData(m_masterExplorer->currentIndex());
                     QString nodePath;
                     if (data.isNode()) {
                         auto node = data.getNode();
@@ -1101,15 +743,7 @@ QAction *NotebookNodeExplorer::createAction(Action p_act, QObject *p_parent)
                         return;
                     }
 
-                    try {
-                        m_notebook->emptyNode(rbNode, true);
-                    } catch (Exception &p_e) {
-                        MessageBoxHelper::notify(MessageBoxHelper::Critical,
-                                                 tr("Failed to empty recycle bin (%1) (%2).").arg(rbNodePath, p_e.what()),
-                                                 VNoteX::getInst().getMainWindow());
-                    }
-
-                    updateNode(rbNode);
+                    emptyRecycleBin(rbNode);
                 });
         break;
 
@@ -1248,9 +882,9 @@ QPair<QVector<Node *>, QVector<ExternalNode *>> NotebookNodeExplorer::getSelecte
 {
     QPair<QVector<Node *>, QVector<ExternalNode *>> nodes;
 
-    auto items = m_masterExplorer->selectedItems();
-    for (auto &item : items) {
-        auto data = getItemNodeData(item);
+    const auto indexes = m_masterExplorer->selectionModel()->selectedRows();
+    for (const auto &idx : indexes) {
+        auto data = NotebookNodeModel::nodeData(idx);
         if (data.isNode()) {
             nodes.first.push_back(data.getNode());
         } else if (data.isExternalNode()) {
@@ -1359,6 +993,7 @@ void NotebookNodeExplorer::pasteNodesFromClipboard()
     bool isMove = cdata->getAction() == ClipboardData::MoveNode;
     QVector<const Node *> pastedNodes;
     QSet<Node *> nodesNeedUpdate;
+    auto &queue = VNoteX::getInst().getFileOperationQueue();
     for (auto srcNode : srcNodes) {
         Q_ASSERT(srcNode->exists());
 
@@ -1375,9 +1010,33 @@ void NotebookNodeExplorer::pasteNodesFromClipboard()
         auto srcParentNode = srcNode->getParent();
 
         try {
+            // Folders are copied in background, after which the pasted node is selected.
             auto notebook = destNode->getNotebook();
-            auto pastedNode = notebook->copyNodeAsChildOf(srcNode, destNode, isMove);
-            pastedNodes.push_back(pastedNode.data());
+            QWeakPointer<Node> weakDest = destNode->sharedFromThis();
+            QWeakPointer<Node> weakSrcParent = srcParentNode->sharedFromThis();
+            auto pastedNode = notebook->copyNodeAsChildOf(srcNode, destNode, isMove, &queue, this,
+                [this, srcPath, weakDest, weakSrcParent](const QSharedPointer<Node> &p_node) {
+                    auto srcParent = weakSrcParent.toStrongRef();
+                    if (srcParent && srcParent->getNotebook() == m_notebook.data()) {
+                        updateNode(srcParent.data());
+                        clearStateCache(m_notebook.data());
+                    }
+
+                    auto dest = weakDest.toStrongRef();
+                    if (dest && dest->getNotebook() == m_notebook.data()) {
+                        updateAndExpandNode(dest.data());
+                        if (p_node) {
+                            selectNodes({p_node.data()});
+                        }
+                    }
+
+                    if (!p_node) {
+                        VNoteX::getInst().showStatusMessageShort(tr("Failed to paste (%1)").arg(srcPath));
+                    }
+                });
+            if (pastedNode) {
+                pastedNodes.push_back(pastedNode.data());
+            }
         } catch (Exception &p_e) {
             MessageBoxHelper::notify(MessageBoxHelper::Critical,
                                      tr("Failed to copy source (%1) to destination (%2) (%3).")
@@ -1408,22 +1067,14 @@ void NotebookNodeExplorer::pasteNodesFromClipboard()
     VNoteX::getInst().showStatusMessageShort(tr("Pasted %n item(s)", "", pastedNodes.size()));
 }
 
-void NotebookNodeExplorer::setNodeExpanded(const Node *p_node, bool p_expanded)
-{
-    auto item = findNode(p_node);
-    if (item) {
-        item->setExpanded(p_expanded);
-    }
-}
-
 void NotebookNodeExplorer::selectNodes(const QVector<const Node *> &p_nodes)
 {
     bool firstItem = true;
     for (auto node : p_nodes) {
-        auto item = findNode(node);
-        if (item) {
+        const auto idx = m_model->indexOfNode(node);
+        if (idx.isValid()) {
             auto flags = firstItem ? QItemSelectionModel::ClearAndSelect : QItemSelectionModel::Select;
-            m_masterExplorer->setCurrentItem(item, 0, flags);
+            m_masterExplorer->selectionModel()->setCurrentIndex(idx, flags | QItemSelectionModel::Rows);
             firstItem = false;
         }
     }
@@ -1457,7 +1108,7 @@ QVector<Node *> NotebookNodeExplorer::confirmSelectedNodes(const QString &p_titl
 
     QVector<ConfirmItemInfo> items;
     for (const auto &node : nodes) {
-        items.push_back(ConfirmItemInfo(getNodeItemIcon(node),
+        items.push_back(ConfirmItemInfo(NotebookNodeModel::getNodeIcon(node),
                                         node->getName(),
                                         node->fetchAbsolutePath(),
                                         node->fetchAbsolutePath(),
@@ -1542,6 +1193,62 @@ void NotebookNodeExplorer::removeSelectedNodesFromConfig()
     removeNodes(nodes, false, true);
 }
 
+void NotebookNodeExplorer::emptyRecycleBin(Node *p_rbNode)
+{
+    auto &queue = VNoteX::getInst().getFileOperationQueue();
+
+    // Copy the children.
+    const auto children = p_rbNode->getChildren();
+    for (const auto &child : children) {
+        if (!child->isContainer() || !child->exists()) {
+            try {
+                m_notebook->removeNode(child, true);
+            } catch (Exception &p_e) {
+                MessageBoxHelper::notify(MessageBoxHelper::Critical,
+                                         tr("Failed to delete item (%1) (%2).").arg(child->fetchAbsolutePath(), p_e.what()),
+                                         VNoteX::getInst().getMainWindow());
+            }
+            continue;
+        }
+
+        // The node is removed from config only after its files are all deleted.
+        const auto dirPath = child->fetchAbsolutePath();
+        QWeakPointer<Node> weakChild = child;
+        queue.enqueue(tr("Deleting %1").arg(child->getName()),
+                      [dirPath](FileOperationQueue::Context &p_context) {
+                          return FileOperationQueue::removeDir(p_context, dirPath);
+                      },
+                      this,
+                      [this, weakChild, dirPath](bool p_succeeded) {
+                          auto node = weakChild.toStrongRef();
+                          if (!node || !node->getParent() || node->fetchAbsolutePath() != dirPath) {
+                              // Removed or moved meanwhile.
+                              return;
+                          }
+
+                          auto notebook = node->getNotebook();
+                          auto parentNode = node->getParent();
+                          if (p_succeeded) {
+                              try {
+                                  notebook->removeNode(node, true, true);
+                              } catch (Exception &p_e) {
+                                  qWarning() << "failed to remove node from config" << dirPath << p_e.what();
+                              }
+                          } else {
+                              // Some files may have been deleted.
+                              node->checkExists();
+                              VNoteX::getInst().showStatusMessageShort(tr("Failed to delete (%1)").arg(dirPath));
+                          }
+
+                          if (notebook == m_notebook.data()) {
+                              updateNode(parentNode);
+                          }
+                      });
+    }
+
+    updateNode(p_rbNode);
+}
+
 void NotebookNodeExplorer::filterAwayChildrenNodes(QVector<Node *> &p_nodes)
 {
     for (int i = p_nodes.size() - 1; i >= 0; --i) {
@@ -1561,21 +1268,25 @@ void NotebookNodeExplorer::filterAwayChildrenNodes(QVector<Node *> &p_nodes)
 
 void NotebookNodeExplorer::updateAndExpandNode(Node *p_node)
 {
-    setNodeExpanded(p_node, false);
     updateNode(p_node);
-    setNodeExpanded(p_node, true);
+
+    const auto idx = m_model->fetchIndexOfNode(p_node);
+    if (idx.isValid()) {
+        m_model->fetchChildren(idx, false);
+        m_masterExplorer->expand(idx);
+    }
 }
 
 bool NotebookNodeExplorer::allSelectedItemsSameType() const
 {
-    auto items = m_masterExplorer->selectedItems();
-    if (items.size() < 2) {
+    const auto indexes = m_masterExplorer->selectionModel()->selectedRows();
+    if (indexes.size() < 2) {
         return true;
     }
 
-    auto type = getItemNodeData(items.first()).getType();
-    for (int i = 1; i < items.size(); ++i) {
-        auto itype = getItemNodeData(items[i]).getType();
+    auto type = NotebookNodeModel::nodeData(indexes.first()).getType();
+    for (int i = 1; i < indexes.size(); ++i) {
+        auto itype = NotebookNodeModel::nodeData(indexes[i]).getType();
         if (itype != type) {
             return false;
         }
@@ -1584,8 +1295,8 @@ bool NotebookNodeExplorer::allSelectedItemsSameType() const
     if (type == NodeData::NodeType::Node) {
         bool hasNormalNode = false;
         bool hasNodeInRecycleBin = false;
-        for (auto &item : items) {
-            auto node = getItemNodeData(item).getNode();
+        for (const auto &idx : indexes) {
+            auto node = NotebookNodeModel::nodeData(idx).getNode();
             if (m_notebook->isRecycleBinNode(node)) {
                 return false;
             } else if (m_notebook->isNodeInRecycleBin(node)) {
@@ -1614,90 +1325,13 @@ void NotebookNodeExplorer::reload()
 
 void NotebookNodeExplorer::focusNormalNode()
 {
-    auto item = m_masterExplorer->currentItem();
-    if (item && (!m_recycleBinNodeVisible || item != m_masterExplorer->topLevelItem(0))) {
+    const auto idx = m_masterExplorer->currentIndex();
+    if (idx.isValid() && (!m_recycleBinNodeVisible || idx != m_model->index(0, 0))) {
         // Not recycle bin.
         return;
     }
 
-    m_masterExplorer->setCurrentItem(m_masterExplorer->topLevelItem(m_recycleBinNodeVisible ? 1 : 0));
-}
-
-void NotebookNodeExplorer::sortNodes(QVector<QSharedPointer<Node>> &p_nodes) const
-{
-    if (m_viewOrder == ViewOrder::OrderedByConfiguration) {
-        return;
-    }
-
-    // Put containers first.
-    int firstFileIndex = p_nodes.size();
-    for (int i = 0; i < p_nodes.size(); ++i) {
-        if (p_nodes[i]->isContainer()) {
-            // If it is a container, load it to set its created time and modified time.
-            p_nodes[i]->load();
-        } else {
-            firstFileIndex = i;
-            break;
-        }
-    }
-
-    // Sort containers.
-    sortNodes(p_nodes, 0, firstFileIndex, m_viewOrder);
-
-    // Sort non-containers.
-    sortNodes(p_nodes, firstFileIndex, p_nodes.size(), m_viewOrder);
-}
-
-void NotebookNodeExplorer::sortNodes(QVector<QSharedPointer<Node>> &p_nodes, int p_start, int p_end, int p_viewOrder) const
-{
-    if (p_start >= p_end) {
-        return;
-    }
-
-    bool reversed = false;
-    switch (p_viewOrder) {
-    case ViewOrder::OrderedByNameReversed:
-        reversed = true;
-        Q_FALLTHROUGH();
-    case ViewOrder::OrderedByName:
-        std::sort(p_nodes.begin() + p_start, p_nodes.begin() + p_end, [reversed](const QSharedPointer<Node> &p_a, const QSharedPointer<Node> p_b) {
-            if (reversed) {
-                return p_b->getName() < p_a->getName();
-            } else {
-                return p_a->getName() < p_b->getName();
-            }
-        });
-        break;
-
-    case ViewOrder::OrderedByCreatedTimeReversed:
-        reversed = true;
-        Q_FALLTHROUGH();
-    case ViewOrder::OrderedByCreatedTime:
-        std::sort(p_nodes.begin() + p_start, p_nodes.begin() + p_end, [reversed](const QSharedPointer<Node> &p_a, const QSharedPointer<Node> p_b) {
-            if (reversed) {
-                return p_b->getCreatedTimeUtc() < p_a->getCreatedTimeUtc();
-            } else {
-                return p_a->getCreatedTimeUtc() < p_b->getCreatedTimeUtc();
-            }
-        });
-        break;
-
-    case ViewOrder::OrderedByModifiedTimeReversed:
-        reversed = true;
-        Q_FALLTHROUGH();
-    case ViewOrder::OrderedByModifiedTime:
-        std::sort(p_nodes.begin() + p_start, p_nodes.begin() + p_end, [reversed](const QSharedPointer<Node> &p_a, const QSharedPointer<Node> p_b) {
-            if (reversed) {
-                return p_b->getModifiedTimeUtc() < p_a->getModifiedTimeUtc();
-            } else {
-                return p_a->getModifiedTimeUtc() < p_b->getModifiedTimeUtc();
-            }
-        });
-        break;
-
-    default:
-        break;
-    }
+    m_masterExplorer->setCurrentIndex(m_model->index(m_recycleBinNodeVisible ? 1 : 0, 0));
 }
 
 void NotebookNodeExplorer::setRecycleBinNodeVisible(bool p_visible)
@@ -1707,17 +1341,12 @@ void NotebookNodeExplorer::setRecycleBinNodeVisible(bool p_visible)
     }
 
     m_recycleBinNodeVisible = p_visible;
-    reload();
+    m_model->setRecycleBinNodeVisible(p_visible);
 }
 
 void NotebookNodeExplorer::setExternalFilesVisible(bool p_visible)
 {
-    if (m_externalFilesVisible == p_visible) {
-        return;
-    }
-
-    m_externalFilesVisible = p_visible;
-    reload();
+    m_model->setExternalFilesVisible(p_visible);
 }
 
 void NotebookNodeExplorer::setAutoImportExternalFiles(bool p_enabled)
@@ -1821,12 +1450,7 @@ Node *NotebookNodeExplorer::currentExploredNode() const
 
 void NotebookNodeExplorer::setViewOrder(int p_order)
 {
-    if (m_viewOrder == p_order) {
-        return;
-    }
-
-    m_viewOrder = p_order;
-    reload();
+    m_model->setViewOrder(p_order);
 }
 
 void NotebookNodeExplorer::openSelectedNodes()
@@ -1933,32 +1557,27 @@ bool NotebookNodeExplorer::checkInvalidNode(Node *p_node) const
 
 void NotebookNodeExplorer::expandCurrentNodeAll()
 {
-    auto item = m_masterExplorer->currentItem();
-    if (!item || item->childCount() == 0) {
-        return;
-    }
-    auto data = getItemNodeData(item);
-    if (!data.isNode()) {
+    const auto idx = m_masterExplorer->currentIndex();
+    auto data = NotebookNodeModel::nodeData(idx);
+    if (!data.isNode() || !data.getNode()->isContainer()) {
         return;
     }
 
-    expandItemRecursively(item);
+    expandIndexRecursively(idx);
 }
 
-void NotebookNodeExplorer::expandItemRecursively(QTreeWidgetItem *p_item)
+void NotebookNodeExplorer::expandIndexRecursively(const QModelIndex &p_index)
 {
-    if (!p_item) {
+    if (!p_index.isValid()) {
         return;
     }
 
-    p_item->setExpanded(true);
-    const int cnt = p_item->childCount();
-    if (cnt == 0) {
-        return;
-    }
+    m_model->fetchChildren(p_index, false);
+    m_masterExplorer->expand(p_index);
 
+    const int cnt = m_model->rowCount(p_index);
     for (int i = 0; i < cnt; ++i) {
-        expandItemRecursively(p_item->child(i));
+        expandIndexRecursively(m_model->index(i, 0, p_index));
     }
 }
 
@@ -2051,15 +1670,3 @@ void NotebookNodeExplorer::openSelectedNodesWithExternalProgram(const QString &p
         ProcessUtils::startDetached(command);
     }
 }
-
-void NotebookNodeExplorer::loadItemChildren(QTreeWidgetItem *p_item) const
-{
-    auto cnt = p_item->childCount();
-    for (int i = 0; i < cnt; ++i) {
-        auto child = p_item->child(i);
-        auto data = getItemNodeData(child);
-        if (data.isNode() && !data.isLoaded()) {
-            loadNode(child, data.getNode(), 1);
-        }
-    }
-}
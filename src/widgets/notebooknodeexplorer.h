@@ -4,23 +4,23 @@
 #include <QWidget>
 #include <QSharedPointer>
 #include <QHash>
+#include <QSet>
 #include <QScopedPointer>
 #include <QPair>
 
-#include "qtreewidgetstatecache.h"
 #include "clipboarddata.h"
 #include "navigationmodewrapper.h"
 
 class QSplitter;
-class QTreeWidget;
-class QTreeWidgetItem;
 class QMenu;
+class QModelIndex;
 
 namespace vnotex
 {
     class Notebook;
     class Node;
-    class TreeWidget;
+    class TreeView;
+    class NotebookNodeModel;
     struct FileOpenParameters;
     class Event;
     class ExternalNode;
@@ -29,8 +29,8 @@ namespace vnotex
     {
         Q_OBJECT
     public:
-        // Used for a QTreeWidgetItem to hold the info of a node.
-        // Make it public since we need to hold it in a QTreeWidgetItem.
+        // Used for an index of the node model to hold the info of a node.
+        // Make it public since we need to hold it in a QVariant.
         class NodeData
         {
         public:
@@ -38,16 +38,10 @@ namespace vnotex
 
             NodeData();
 
-            explicit NodeData(Node *p_node, bool p_loaded);
+            explicit NodeData(Node *p_node);
 
             explicit NodeData(const QSharedPointer<ExternalNode> &p_externalNode);
 
-            NodeData(const NodeData &p_other);
-
-            ~NodeData();
-
-            NodeData &operator=(const NodeData &p_other);
-
             bool isValid() const;
 
             bool isNode() const;
@@ -64,16 +58,12 @@ namespace vnotex
 
             bool matched(const Node *p_node) const;
 
-            bool isLoaded() const;
-
         private:
             NodeType m_type = NodeType::Invalid;
 
             Node *m_node = nullptr;
 
             QSharedPointer<ExternalNode> m_externalNode;
-
-            bool m_loaded = false;
         };
 
         enum ViewOrder
@@ -128,7 +118,15 @@ namespace vnotex
         void nodeAboutToReload(Node *p_node, const QSharedPointer<Event> &p_event);
 
     private:
-        enum Column { Name = 0 };
+        // Tree state of a notebook to restore when switching back.
+        struct TreeState
+        {
+            void clear();
+
+            QSet<const Node *> m_expandedNodes;
+
+            Node *m_currentNode = nullptr;
+        };
 
         enum class Action
         {
@@ -159,45 +157,18 @@ namespace vnotex
 
         void setupMasterExplorer(QWidget *p_parent = nullptr);
 
-        void clearExplorer();
-
         void generateNodeTree();
 
-        void loadRootNode(const Node *p_node) const;
-
-        void loadNode(QTreeWidgetItem *p_item, Node *p_node, int p_level) const;
-
-        void loadChildren(QTreeWidgetItem *p_item, Node *p_node, int p_level) const;
-
-        void loadItemChildren(QTreeWidgetItem *p_item) const;
-
-        void loadNode(QTreeWidgetItem *p_item, const QSharedPointer<ExternalNode> &p_node) const;
-
-        void loadRecycleBinNode(Node *p_node) const;
-
-        void loadRecycleBinNode(QTreeWidgetItem *p_item, Node *p_node, int p_level) const;
-
-        void fillTreeItem(QTreeWidgetItem *p_item, Node *p_node, bool p_loaded) const;
-
-        void fillTreeItem(QTreeWidgetItem *p_item, const QSharedPointer<ExternalNode> &p_node) const;
-
-        const QIcon &getNodeItemIcon(const Node *p_node) const;
-
-        const QIcon &getNodeItemIcon(const ExternalNode *p_node) const;
+        void saveNotebookTreeState(bool p_saveCurrentNode = true);
 
-        void initNodeIcons() const;
+        void saveExpandedNodes(const QModelIndex &p_parent, QSet<const Node *> &p_nodes) const;
 
-        QTreeWidgetItem *findNode(const Node *p_node) const;
+        void restoreNotebookTreeState(bool p_restoreCurrentNode);
 
-        QTreeWidgetItem *findNode(QTreeWidgetItem *p_item, const Node *p_node) const;
+        // Expand children of @p_parent within [@p_first, @p_last] pending to be expanded.
+        void expandPendingNodes(const QModelIndex &p_parent, int p_first, int p_last);
 
-        QTreeWidgetItem *findNodeChild(QTreeWidgetItem *p_item, const Node *p_node) const;
-
-        QTreeWidgetItem *findNodeTopLevelItem(QTreeWidget *p_tree, const Node *p_node) const;
-
-        void saveNotebookTreeState(bool p_saveCurrentItem = true);
-
-        QSharedPointer<QTreeWidgetStateCache<Node *>> stateCache() const;
+        TreeState &stateCache();
 
         void clearStateCache(const Notebook *p_notebook);
 
@@ -220,6 +191,9 @@ namespace vnotex
 
         void removeSelectedNodesFromConfig();
 
+        // Folders are deleted in background.
+        void emptyRecycleBin(Node *p_rbNode);
+
         QVector<Node *> confirmSelectedNodes(const QString &p_title,
                                              const QString &p_text,
                                              const QString &p_info) const;
@@ -228,8 +202,6 @@ namespace vnotex
 
         bool isPasteOnNodeAvailable(const Node *p_node) const;
 
-        void setNodeExpanded(const Node *p_node, bool p_expanded);
-
         void selectNodes(const QVector<const Node *> &p_nodes);
 
         // @p_skipRecycleBin is irrelevant if @p_configOnly is true.
@@ -245,11 +217,6 @@ namespace vnotex
         // Skip the recycle bin node if possible.
         void focusNormalNode();
 
-        void sortNodes(QVector<QSharedPointer<Node>> &p_nodes) const;
-
-        // [p_start, p_end).
-        void sortNodes(QVector<QSharedPointer<Node>> &p_nodes, int p_start, int p_end, int p_viewOrder) const;
-
         // Sort nodes in config file.
         void manualSort();
 
@@ -265,7 +232,7 @@ namespace vnotex
 
         void expandCurrentNodeAll();
 
-        void expandItemRecursively(QTreeWidgetItem *p_item);
+        void expandIndexRecursively(const QModelIndex &p_index);
 
         void addOpenWithMenu(QMenu *p_menu);
 
@@ -275,41 +242,24 @@ namespace vnotex
 
         void openSelectedNodesWithExternalProgram(const QString &p_command);
 
-        static NotebookNodeExplorer::NodeData getItemNodeData(const QTreeWidgetItem *p_item);
-
-        static void setItemNodeData(QTreeWidgetItem *p_item, const NodeData &p_data);
-
         QSplitter *m_splitter = nullptr;
 
-        TreeWidget *m_masterExplorer = nullptr;
+        TreeView *m_masterExplorer = nullptr;
 
-        QSharedPointer<Notebook> m_notebook;
+        NotebookNodeModel *m_model = nullptr;
 
-        QHash<const Notebook *, QSharedPointer<QTreeWidgetStateCache<Node *>>> m_stateCache;
+        QSharedPointer<Notebook> m_notebook;
 
-        QScopedPointer<NavigationModeWrapper<QTreeWidget, QTreeWidgetItem>> m_navigationWrapper;
+        QHash<const Notebook *, TreeState> m_stateCache;
 
-        bool m_recycleBinNodeVisible = false;
+        // Nodes to expand once they are fetched.
+        QSet<const Node *> m_pendingExpandNodes;
 
-        int m_viewOrder = ViewOrder::OrderedByConfiguration;
+        QScopedPointer<TreeViewNavigationModeWrapper> m_navigationWrapper;
 
-        bool m_externalFilesVisible = true;
+        bool m_recycleBinNodeVisible = false;
 
         bool m_autoImportExternalFiles = true;
-
-        static QIcon s_folderNodeIcon;
-
-        static QIcon s_fileNodeIcon;
-
-        static QIcon s_invalidFolderNodeIcon;
-
-        static QIcon s_invalidFileNodeIcon;
-
-        static QIcon s_recycleBinNodeIcon;
-
-        static QIcon s_externalFolderNodeIcon;
-
-        static QIcon s_externalFileNodeIcon;
     };
 }
 
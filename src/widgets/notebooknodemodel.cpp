@@ -0,0 +1,1004 @@
+#include "notebooknodemodel.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QSet>
+#include <QTimer>
+
+#include <notebook/notebook.h>
+#include <notebook/node.h>
+#include <notebook/externalnode.h>
+#include <notebook/nodeloader.h>
+#include <utils/iconutils.h>
+#include <utils/pathutils.h>
+#include <core/filewatcher.h>
+#include "exception.h"
+#include "vnotex.h"
+
+using namespace vnotex;
+
+typedef NotebookNodeExplorer::NodeData NodeData;
+
+QIcon NotebookNodeModel::s_folderNodeIcon;
+
+QIcon NotebookNodeModel::s_fileNodeIcon;
+
+QIcon NotebookNodeModel::s_invalidFolderNodeIcon;
+
+QIcon NotebookNodeModel::s_invalidFileNodeIcon;
+
+QIcon NotebookNodeModel::s_recycleBinNodeIcon;
+
+QIcon NotebookNodeModel::s_externalFolderNodeIcon;
+
+QIcon NotebookNodeModel::s_externalFileNodeIcon;
+
+NotebookNodeModel::Item::~Item()
+{
+    qDeleteAll(m_children);
+}
+
+bool NotebookNodeModel::Item::isPlaceholder() const
+{
+    return !m_data.isValid();
+}
+
+bool NotebookNodeModel::Item::isStale() const
+{
+    return m_data.isNode() && m_node.isNull();
+}
+
+NotebookNodeModel::NotebookNodeModel(QObject *p_parent)
+    : QAbstractItemModel(p_parent)
+{
+    initNodeIcons();
+
+    m_changedFoldersTimer = new QTimer(this);
+    m_changedFoldersTimer->setSingleShot(true);
+    m_changedFoldersTimer->setInterval(500);
+    connect(m_changedFoldersTimer, &QTimer::timeout,
+            this, &NotebookNodeModel::syncChangedFolders);
+
+    connect(&VNoteX::getInst().getFileWatcher(), &FileWatcher::directoriesChanged,
+            this, &NotebookNodeModel::handleDirectoriesChanged);
+}
+
+NotebookNodeModel::~NotebookNodeModel()
+{
+    unwatchAllFolders();
+    delete m_root;
+}
+
+void NotebookNodeModel::initNodeIcons()
+{
+    if (!s_folderNodeIcon.isNull()) {
+        return;
+    }
+
+    const QString nodeIconFgName = "widgets#notebookexplorer#node_icon#fg";
+    const QString invalidNodeIconFgName = "widgets#notebookexplorer#node_icon#invalid#fg";
+    const QString externalNodeIconFgName = "widgets#notebookexplorer#external_node_icon#fg";
+
+    const auto &themeMgr = VNoteX::getInst().getThemeMgr();
+    const auto fg = themeMgr.paletteColor(nodeIconFgName);
+    const auto invalidFg = themeMgr.paletteColor(invalidNodeIconFgName);
+    const auto externalFg = themeMgr.paletteColor(externalNodeIconFgName);
+
+    const QString folderIconName("folder_node.svg");
+    const QString fileIconName("file_node.svg");
+    const QString recycleBinIconName("recycle_bin.svg");
+
+    s_folderNodeIcon = IconUtils::fetchIcon(themeMgr.getIconFile(folderIconName), fg);
+    s_fileNodeIcon = IconUtils::fetchIcon(themeMgr.getIconFile(fileIconName), fg);
+    s_invalidFolderNodeIcon = IconUtils::fetchIcon(themeMgr.getIconFile(folderIconName), invalidFg);
+    s_invalidFileNodeIcon = IconUtils::fetchIcon(themeMgr.getIconFile(fileIconName), invalidFg);
+    s_recycleBinNodeIcon = IconUtils::fetchIcon(themeMgr.getIconFile(recycleBinIconName), fg);
+    s_externalFolderNodeIcon = IconUtils::fetchIcon(themeMgr.getIconFile(folderIconName), externalFg);
+    s_externalFileNodeIcon = IconUtils::fetchIcon(themeMgr.getIconFile(fileIconName), externalFg);
+}
+
+const QIcon &NotebookNodeModel::getNodeIcon(const Node *p_node)
+{
+    if (p_node->hasContent()) {
+        return p_node->exists() ? s_fileNodeIcon : s_invalidFileNodeIcon;
+    } else {
+        if (p_node->getUse() == Node::Use::RecycleBin) {
+            return s_recycleBinNodeIcon;
+        }
+
+        return p_node->exists() ? s_folderNodeIcon : s_invalidFolderNodeIcon;
+    }
+}
+
+const QIcon &NotebookNodeModel::getNodeIcon(const ExternalNode *p_node)
+{
+    return p_node->isFolder() ? s_externalFolderNodeIcon : s_externalFileNodeIcon;
+}
+
+void NotebookNodeModel::setNotebook(const QSharedPointer<Notebook> &p_notebook)
+{
+    if (m_notebook) {
+        disconnect(m_notebook->getNodeLoader(), nullptr, this, nullptr);
+    }
+
+    m_notebook = p_notebook;
+
+    if (m_notebook) {
+        connect(m_notebook->getNodeLoader(), &NodeLoader::nodeLoaded,
+                this, &NotebookNodeModel::handleNodeLoaded);
+    }
+
+    beginResetModel();
+    try {
+        resetRoot();
+    } catch (...) {
+        endResetModel();
+        throw;
+    }
+    endResetModel();
+}
+
+void NotebookNodeModel::resetRoot()
+{
+    unwatchAllFolders();
+    delete m_root;
+    m_root = nullptr;
+    m_nodeItems.clear();
+
+    if (!m_notebook) {
+        return;
+    }
+
+    auto rootNode = m_notebook->getRootNode();
+    Q_ASSERT(rootNode->isLoaded() && rootNode->isContainer());
+
+    m_root = createItem(NodeData(rootNode.data()), nullptr);
+    m_root->m_fetched = true;
+    watchFolder(m_root);
+
+    const auto children = fetchChildrenData(m_root);
+    m_root->m_children.reserve(children.size());
+    for (const auto &data : children) {
+        m_root->m_children.push_back(createItem(data, m_root));
+    }
+    updateRows(m_root, 0);
+}
+
+void NotebookNodeModel::setRecycleBinNodeVisible(bool p_visible)
+{
+    if (m_recycleBinNodeVisible == p_visible) {
+        return;
+    }
+
+    m_recycleBinNodeVisible = p_visible;
+    updateNode(nullptr);
+}
+
+void NotebookNodeModel::setExternalFilesVisible(bool p_visible)
+{
+    if (m_externalFilesVisible == p_visible) {
+        return;
+    }
+
+    m_externalFilesVisible = p_visible;
+    updateNode(nullptr);
+}
+
+void NotebookNodeModel::setViewOrder(int p_order)
+{
+    if (m_viewOrder == p_order) {
+        return;
+    }
+
+    m_viewOrder = p_order;
+    updateNode(nullptr);
+}
+
+void NotebookNodeModel::updateNode(Node *p_node)
+{
+    if (!m_root) {
+        return;
+    }
+
+    if (!p_node) {
+        if (m_root->isStale() || m_root->m_data.getNode() != m_notebook->getRootNode().data()) {
+            // Nodes are reloaded.
+            beginResetModel();
+            try {
+                resetRoot();
+            } catch (...) {
+                endResetModel();
+                throw;
+            }
+            endResetModel();
+            return;
+        }
+
+        syncChildren(m_root);
+        return;
+    }
+
+    auto item = m_nodeItems.value(p_node, nullptr);
+    if (!item || item->isStale()) {
+        // Not fetched yet.
+        return;
+    }
+
+    if (item != m_root) {
+        item->m_state = itemState(item->m_data);
+        const auto idx = indexOfItem(item);
+        emit dataChanged(idx, idx);
+    }
+
+    if (item->m_fetched) {
+        syncChildren(item);
+    }
+}
+
+QModelIndex NotebookNodeModel::indexOfNode(const Node *p_node) const
+{
+    auto item = m_nodeItems.value(p_node, nullptr);
+    if (!item || item->isStale()) {
+        return QModelIndex();
+    }
+
+    return indexOfItem(item);
+}
+
+QModelIndex NotebookNodeModel::fetchIndexOfNode(Node *p_node)
+{
+    if (!p_node || !m_root) {
+        return QModelIndex();
+    }
+
+    auto item = m_nodeItems.value(p_node, nullptr);
+    if (item && !item->isStale()) {
+        return indexOfItem(item);
+    }
+
+    auto parentNode = p_node->getParent();
+    if (!parentNode) {
+        return QModelIndex();
+    }
+
+    // Make sure the parent is fetched.
+    const auto parentIdx = fetchIndexOfNode(parentNode);
+    auto parentItem = m_nodeItems.value(parentNode, nullptr);
+    if (!parentItem || parentItem->isStale()) {
+        return QModelIndex();
+    }
+
+    Q_ASSERT(parentItem == itemFromIndex(parentIdx));
+    fetchChildren(parentIdx, false);
+
+    return indexOfNode(p_node);
+}
+
+void NotebookNodeModel::fetchChildren(const QModelIndex &p_parent, bool p_async)
+{
+    auto item = itemFromIndex(p_parent);
+    if (!item || item->m_fetched || !item->m_data.isNode() || item->isStale()) {
+        return;
+    }
+
+    auto node = item->m_data.getNode();
+    if (!node->isContainer()) {
+        return;
+    }
+
+    if (!node->isLoaded()) {
+        if (p_async) {
+            if (item->m_loading) {
+                return;
+            }
+
+            if (m_notebook->getNodeLoader()->load(node->sharedFromThis())) {
+                // Show a placeholder until the node is loaded.
+                item->m_loading = true;
+                insertChildren(item, 0, QVector<NodeData>(1));
+                return;
+            }
+        }
+
+        try {
+            node->load();
+        } catch (Exception &p_e) {
+            qWarning() << "failed to load node" << node->fetchPath() << p_e.what();
+            return;
+        }
+
+        if (!node->isLoaded()) {
+            return;
+        }
+    }
+
+    item->m_fetched = true;
+    item->m_loading = false;
+    watchFolder(item);
+    syncChildren(item);
+}
+
+void NotebookNodeModel::handleNodeLoaded(Node *p_node)
+{
+    auto item = m_nodeItems.value(p_node, nullptr);
+    if (!item || !item->m_loading || item->isStale()) {
+        return;
+    }
+
+    item->m_loading = false;
+    if (p_node->isLoaded()) {
+        item->m_fetched = true;
+        watchFolder(item);
+        syncChildren(item);
+    } else if (!item->m_children.isEmpty()) {
+        // Failed to load. Just drop the placeholder.
+        removeChildren(item, 0, item->m_children.size() - 1);
+    }
+}
+
+void NotebookNodeModel::watchFolder(const Item *p_item)
+{
+    if (!p_item->m_fetched || p_item->isStale()) {
+        return;
+    }
+
+    auto node = p_item->m_data.getNode();
+    const auto path = node->fetchAbsolutePath();
+    auto &watchedFolder = m_watchedFolders[node];
+    if (watchedFolder == path) {
+        return;
+    }
+
+    auto &watcher = VNoteX::getInst().getFileWatcher();
+    if (!watchedFolder.isEmpty()) {
+        watcher.removePath(watchedFolder);
+    }
+    watchedFolder = path;
+    watcher.addPath(watchedFolder);
+}
+
+void NotebookNodeModel::unwatchFolder(const Item *p_item)
+{
+    if (!p_item->m_data.isNode()) {
+        return;
+    }
+
+    // Do not dereference the node which may be deleted.
+    auto it = m_watchedFolders.find(p_item->m_data.getNode());
+    if (it != m_watchedFolders.end()) {
+        VNoteX::getInst().getFileWatcher().removePath(it.value());
+        m_watchedFolders.erase(it);
+    }
+}
+
+void NotebookNodeModel::unwatchAllFolders()
+{
+    auto &watcher = VNoteX::getInst().getFileWatcher();
+    for (const auto &folder : m_watchedFolders) {
+        watcher.removePath(folder);
+    }
+    m_watchedFolders.clear();
+}
+
+void NotebookNodeModel::handleDirectoriesChanged(const QStringList &p_dirs)
+{
+    if (m_watchedFolders.isEmpty()) {
+        return;
+    }
+
+    for (const auto &dir : p_dirs) {
+        for (auto it = m_watchedFolders.constBegin(); it != m_watchedFolders.constEnd(); ++it) {
+            if (PathUtils::areSamePaths(it.value(), dir)) {
+                m_changedFolders.insert(it.key());
+            }
+        }
+    }
+
+    if (!m_changedFolders.isEmpty()) {
+        m_changedFoldersTimer->start();
+    }
+}
+
+void NotebookNodeModel::syncChangedFolders()
+{
+    const auto nodes = m_changedFolders;
+    m_changedFolders.clear();
+
+    for (auto node : nodes) {
+        // Do not dereference the node which may be deleted before its item is looked up.
+        auto item = m_nodeItems.value(node, nullptr);
+        auto it = m_watchedFolders.constFind(node);
+        if (!item || item->isStale() || !item->m_fetched || it == m_watchedFolders.constEnd()) {
+            continue;
+        }
+
+        QSet<QString> names;
+        const auto entries = QDir(it.value()).entryList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+        for (const auto &entry : entries) {
+            names.insert(entry);
+        }
+
+        // Most changes are our own writes of config files, which change nothing shown.
+        bool changed = false;
+        for (const auto &child : item->m_data.getNode()->getChildrenRef()) {
+            const bool exists = names.contains(child->getName());
+            if (exists != child->exists()) {
+                child->setExists(exists);
+                emit m_notebook->nodeUpdated(child.data());
+                changed = true;
+            }
+        }
+
+        // External files may change.
+        if (changed || m_externalFilesVisible) {
+            syncChildren(item);
+        }
+    }
+}
+
+NotebookNodeModel::ItemKey NotebookNodeModel::itemKey(const NodeData &p_data)
+{
+    if (p_data.isNode()) {
+        return ItemKey(p_data.getNode(), QString());
+    } else if (p_data.isExternalNode()) {
+        auto externalNode = p_data.getExternalNode();
+        return ItemKey(nullptr, externalNode->isFolder() ? externalNode->getName() + QLatin1Char('/')
+                                                         : externalNode->getName());
+    }
+
+    return ItemKey(nullptr, QString());
+}
+
+QString NotebookNodeModel::itemState(const NodeData &p_data)
+{
+    if (p_data.isNode()) {
+        // Name of an external node is part of its key.
+        auto node = p_data.getNode();
+        return (node->exists() ? QLatin1Char('1') : QLatin1Char('0')) + node->getName();
+    }
+
+    return QString();
+}
+
+QVector<NodeData> NotebookNodeModel::fetchChildrenData(const Item *p_item) const
+{
+    QVector<NodeData> data;
+
+    auto node = p_item->m_data.getNode();
+    Q_ASSERT(node->isLoaded() && node->isContainer());
+
+    QSharedPointer<Node> recycleBinNode;
+    if (p_item == m_root) {
+        // Render recycle bin node first.
+        recycleBinNode = m_notebook->getRecycleBinNode();
+        if (recycleBinNode && m_recycleBinNodeVisible) {
+            data.push_back(NodeData(recycleBinNode.data()));
+        }
+    }
+
+    // External children.
+    if (m_externalFilesVisible) {
+        const auto externalChildren = node->fetchExternalChildren();
+        // TODO: Sort external children.
+        for (const auto &child : externalChildren) {
+            data.push_back(NodeData(child));
+        }
+    }
+
+    // Children.
+    auto children = node->getChildren();
+    sortNodes(children);
+    data.reserve(data.size() + children.size());
+    for (const auto &child : children) {
+        if (child == recycleBinNode) {
+            continue;
+        }
+
+        data.push_back(NodeData(child.data()));
+    }
+
+    return data;
+}
+
+void NotebookNodeModel::syncChildren(Item *p_item)
+{
+    Q_ASSERT(p_item->m_fetched && !p_item->isStale());
+
+    auto node = p_item->m_data.getNode();
+    if (!node->isLoaded()) {
+        if (!p_item->m_children.isEmpty()) {
+            removeChildren(p_item, 0, p_item->m_children.size() - 1);
+        }
+        p_item->m_fetched = false;
+        unwatchFolder(p_item);
+        return;
+    }
+
+    // Path changes on rename.
+    watchFolder(p_item);
+
+    const auto newData = fetchChildrenData(p_item);
+
+    QSet<ItemKey> newKeys;
+    newKeys.reserve(newData.size());
+    for (const auto &data : newData) {
+        newKeys.insert(itemKey(data));
+    }
+
+    // Remove children gone from the node tree, in runs from the end.
+    auto isObsolete = [&newKeys](const Item *p_child) {
+        return p_child->isStale() || !newKeys.contains(itemKey(p_child->m_data));
+    };
+    for (int i = p_item->m_children.size() - 1; i >= 0;) {
+        if (!isObsolete(p_item->m_children[i])) {
+            --i;
+            continue;
+        }
+
+        const int last = i;
+        while (i >= 0 && isObsolete(p_item->m_children[i])) {
+            --i;
+        }
+        removeChildren(p_item, i + 1, last);
+    }
+
+    // Reorder kept children as a layout change.
+    QHash<ItemKey, Item *> keptItems;
+    keptItems.reserve(p_item->m_children.size());
+    for (auto child : p_item->m_children) {
+        keptItems.insert(itemKey(child->m_data), child);
+    }
+
+    {
+        QVector<Item *> reordered;
+        reordered.reserve(p_item->m_children.size());
+        for (const auto &data : newData) {
+            auto it = keptItems.constFind(itemKey(data));
+            if (it != keptItems.constEnd()) {
+                reordered.push_back(it.value());
+            }
+        }
+        Q_ASSERT(reordered.size() == p_item->m_children.size());
+
+        if (reordered != p_item->m_children) {
+            QList<QPersistentModelIndex> parents;
+            if (p_item != m_root) {
+                parents << QPersistentModelIndex(indexOfItem(p_item));
+            }
+
+            emit layoutAboutToBeChanged(parents, QAbstractItemModel::VerticalSortHint);
+
+            p_item->m_children = reordered;
+            updateRows(p_item, 0);
+
+            QModelIndexList fromIndexes;
+            QModelIndexList toIndexes;
+            const auto persistentIndexes = persistentIndexList();
+            for (const auto &idx : persistentIndexes) {
+                auto child = itemFromIndex(idx);
+                if (child->m_parent == p_item) {
+                    fromIndexes << idx;
+                    toIndexes << createIndex(child->m_row, idx.column(), child);
+                }
+            }
+            changePersistentIndexList(fromIndexes, toIndexes);
+
+            emit layoutChanged(parents, QAbstractItemModel::VerticalSortHint);
+        }
+    }
+
+    // Insert new children in runs and refresh kept ones.
+    QVector<Item *> changedItems;
+    int row = 0;
+    for (int i = 0; i < newData.size();) {
+        if (keptItems.contains(itemKey(newData[i]))) {
+            auto child = p_item->m_children[row];
+            Q_ASSERT(itemKey(child->m_data) == itemKey(newData[i]));
+            // External nodes are fetched anew.
+            child->m_data = newData[i];
+            auto state = itemState(child->m_data);
+            if (state != child->m_state) {
+                child->m_state = state;
+                changedItems.push_back(child);
+            }
+            ++row;
+            ++i;
+            continue;
+        }
+
+        int end = i + 1;
+        while (end < newData.size() && !keptItems.contains(itemKey(newData[end]))) {
+            ++end;
+        }
+
+        insertChildren(p_item, row, newData.mid(i, end - i));
+        row += end - i;
+        i = end;
+    }
+
+    // Refresh changed rows in runs. Rows are final after the insertions.
+    if (!changedItems.isEmpty()) {
+        const auto parentIdx = indexOfItem(p_item);
+        for (int i = 0; i < changedItems.size();) {
+            int end = i + 1;
+            while (end < changedItems.size() && changedItems[end]->m_row == changedItems[end - 1]->m_row + 1) {
+                ++end;
+            }
+
+            emit dataChanged(index(changedItems[i]->m_row, 0, parentIdx),
+                             index(changedItems[end - 1]->m_row, 0, parentIdx));
+            i = end;
+        }
+    }
+
+    for (auto child : p_item->m_children) {
+        if (child->m_fetched) {
+            syncChildren(child);
+        }
+    }
+}
+
+void NotebookNodeModel::removeChildren(Item *p_item, int p_first, int p_last)
+{
+    Q_ASSERT(p_first <= p_last && p_last < p_item->m_children.size());
+    beginRemoveRows(indexOfItem(p_item), p_first, p_last);
+    for (int i = p_first; i <= p_last; ++i) {
+        auto child = p_item->m_children[i];
+        unregisterItem(child);
+        delete child;
+    }
+    p_item->m_children.remove(p_first, p_last - p_first + 1);
+    updateRows(p_item, p_first);
+    endRemoveRows();
+}
+
+void NotebookNodeModel::insertChildren(Item *p_item, int p_row, const QVector<NodeData> &p_data)
+{
+    if (p_data.isEmpty()) {
+        return;
+    }
+
+    beginInsertRows(indexOfItem(p_item), p_row, p_row + p_data.size() - 1);
+    QVector<Item *> children;
+    children.reserve(p_item->m_children.size() + p_data.size());
+    children << p_item->m_children.mid(0, p_row);
+    for (const auto &data : p_data) {
+        children.push_back(createItem(data, p_item));
+    }
+    children << p_item->m_children.mid(p_row);
+    p_item->m_children = children;
+    updateRows(p_item, p_row);
+    endInsertRows();
+}
+
+NotebookNodeModel::Item *NotebookNodeModel::createItem(const NodeData &p_data, Item *p_parent)
+{
+    auto item = new Item();
+    item->m_data = p_data;
+    item->m_state = itemState(p_data);
+    item->m_parent = p_parent;
+    if (p_data.isNode()) {
+        auto node = p_data.getNode();
+        item->m_node = node->sharedFromThis();
+        m_nodeItems.insert(node, item);
+    }
+    return item;
+}
+
+void NotebookNodeModel::unregisterItem(const Item *p_item)
+{
+    unwatchFolder(p_item);
+
+    if (p_item->m_data.isNode()) {
+        auto it = m_nodeItems.find(p_item->m_data.getNode());
+        if (it != m_nodeItems.end() && it.value() == p_item) {
+            m_nodeItems.erase(it);
+        }
+    }
+
+    for (auto child : p_item->m_children) {
+        unregisterItem(child);
+    }
+}
+
+void NotebookNodeModel::updateRows(Item *p_item, int p_first)
+{
+    for (int i = p_first; i < p_item->m_children.size(); ++i) {
+        p_item->m_children[i]->m_row = i;
+    }
+}
+
+NotebookNodeModel::Item *NotebookNodeModel::itemFromIndex(const QModelIndex &p_index) const
+{
+    if (!p_index.isValid()) {
+        return m_root;
+    }
+
+    return static_cast<Item *>(p_index.internalPointer());
+}
+
+QModelIndex NotebookNodeModel::indexOfItem(const Item *p_item) const
+{
+    if (!p_item || p_item == m_root) {
+        return QModelIndex();
+    }
+
+    return createIndex(p_item->m_row, 0, const_cast<Item *>(p_item));
+}
+
+NodeData NotebookNodeModel::nodeData(const QModelIndex &p_index)
+{
+    if (!p_index.isValid()) {
+        return NodeData();
+    }
+
+    return p_index.data(NodeDataRole).value<NodeData>();
+}
+
+QModelIndex NotebookNodeModel::index(int p_row, int p_column, const QModelIndex &p_parent) const
+{
+    if (p_column != 0) {
+        return QModelIndex();
+    }
+
+    auto item = itemFromIndex(p_parent);
+    if (!item || p_row < 0 || p_row >= item->m_children.size()) {
+        return QModelIndex();
+    }
+
+    return createIndex(p_row, p_column, item->m_children[p_row]);
+}
+
+QModelIndex NotebookNodeModel::parent(const QModelIndex &p_index) const
+{
+    if (!p_index.isValid()) {
+        return QModelIndex();
+    }
+
+    return indexOfItem(itemFromIndex(p_index)->m_parent);
+}
+
+int NotebookNodeModel::rowCount(const QModelIndex &p_parent) const
+{
+    if (p_parent.column() > 0) {
+        return 0;
+    }
+
+    auto item = itemFromIndex(p_parent);
+    return item ? item->m_children.size() : 0;
+}
+
+int NotebookNodeModel::columnCount(const QModelIndex &p_parent) const
+{
+    Q_UNUSED(p_parent);
+    return 1;
+}
+
+QVariant NotebookNodeModel::data(const QModelIndex &p_index, int p_role) const
+{
+    if (!p_index.isValid()) {
+        return QVariant();
+    }
+
+    auto item = itemFromIndex(p_index);
+    if (item->isPlaceholder()) {
+        if (p_role == Qt::DisplayRole) {
+            return tr("Loading...");
+        }
+        return QVariant();
+    }
+
+    if (item->isStale()) {
+        // Deleted but not synced yet.
+        return QVariant();
+    }
+
+    const auto &data = item->m_data;
+    if (p_role == NodeDataRole) {
+        return QVariant::fromValue(data);
+    }
+
+    if (data.isNode()) {
+        auto node = data.getNode();
+        const bool isRecycleBin = m_notebook->isRecycleBinNode(node);
+        switch (p_role) {
+        case Qt::DisplayRole:
+            return isRecycleBin ? tr("Recycle Bin") : node->getName();
+
+        case Qt::DecorationRole:
+            return getNodeIcon(node);
+
+        case Qt::ToolTipRole:
+            if (isRecycleBin) {
+                return QVariant();
+            }
+            return node->exists() ? node->getName() : (tr("[Invalid] %1").arg(node->getName()));
+
+        case Qt::WhatsThisRole:
+            if (isRecycleBin) {
+                return tr("Recycle bin of this notebook. Deleted files could be found here. "
+                          "It is organized in folders named by date. Nodes could be moved to "
+                          "other folders by Cut and Paste.");
+            }
+            return QVariant();
+
+        default:
+            return QVariant();
+        }
+    } else {
+        auto externalNode = data.getExternalNode();
+        switch (p_role) {
+        case Qt::DisplayRole:
+            return externalNode->getName();
+
+        case Qt::DecorationRole:
+            return getNodeIcon(externalNode);
+
+        case Qt::ToolTipRole:
+            return tr("[External] %1").arg(externalNode->getName());
+
+        default:
+            return QVariant();
+        }
+    }
+}
+
+Qt::ItemFlags NotebookNodeModel::flags(const QModelIndex &p_index) const
+{
+    if (!p_index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+
+    auto item = itemFromIndex(p_index);
+    if (item->isPlaceholder() || item->isStale()) {
+        return Qt::NoItemFlags;
+    }
+
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+bool NotebookNodeModel::hasChildren(const QModelIndex &p_parent) const
+{
+    auto item = itemFromIndex(p_parent);
+    if (!item) {
+        return false;
+    }
+
+    if (item == m_root || item->m_fetched || item->m_loading) {
+        return !item->m_children.isEmpty();
+    }
+
+    if (!item->m_data.isNode() || item->isStale()) {
+        return false;
+    }
+
+    auto node = item->m_data.getNode();
+    if (!node->isContainer()) {
+        return false;
+    }
+
+    if (!node->isLoaded()) {
+        return node->exists();
+    }
+
+    // External children are unknown until fetched.
+    return node->getChildrenCount() > 0 || m_externalFilesVisible;
+}
+
+bool NotebookNodeModel::canFetchMore(const QModelIndex &p_parent) const
+{
+    auto item = itemFromIndex(p_parent);
+    if (!item || item == m_root || item->m_fetched || item->m_loading) {
+        return false;
+    }
+
+    return item->m_data.isNode() && !item->isStale() && item->m_data.getNode()->isContainer();
+}
+
+void NotebookNodeModel::fetchMore(const QModelIndex &p_parent)
+{
+    fetchChildren(p_parent, true);
+}
+
+void NotebookNodeModel::sortNodes(QVector<QSharedPointer<Node>> &p_nodes) const
+{
+    if (m_viewOrder == NotebookNodeExplorer::ViewOrder::OrderedByConfiguration) {
+        return;
+    }
+
+    // Put containers first.
+    int firstFileIndex = p_nodes.size();
+    for (int i = 0; i < p_nodes.size(); ++i) {
+        if (!p_nodes[i]->isContainer()) {
+            firstFileIndex = i;
+            break;
+        }
+    }
+
+    // Sort containers.
+    sortNodes(p_nodes, 0, firstFileIndex, m_viewOrder);
+
+    // Sort non-containers.
+    sortNodes(p_nodes, firstFileIndex, p_nodes.size(), m_viewOrder);
+}
+
+static qint64 timeSortKey(Node *p_node, bool p_createdTime)
+{
+    if (p_node->isContainer() && !p_node->isLoaded() && !p_node->getCreatedTimeUtc().isValid()) {
+        // Times are not cached in the config of its parent yet.
+        p_node->load();
+    }
+
+    // Folders are ordered by the latest modification within them.
+    const auto time = p_createdTime ? p_node->getCreatedTimeUtc() : p_node->fetchLatestModifiedTimeUtc();
+    return time.isValid() ? time.toMSecsSinceEpoch() : 0;
+}
+
+void NotebookNodeModel::sortNodes(QVector<QSharedPointer<Node>> &p_nodes, int p_start, int p_end, int p_viewOrder) const
+{
+    if (p_start >= p_end) {
+        return;
+    }
+
+    enum class SortKey { Name, CreatedTime, ModifiedTime };
+
+    bool reversed = false;
+    SortKey sortKey = SortKey::Name;
+    switch (p_viewOrder) {
+    case NotebookNodeExplorer::ViewOrder::OrderedByNameReversed:
+        reversed = true;
+        Q_FALLTHROUGH();
+    case NotebookNodeExplorer::ViewOrder::OrderedByName:
+        sortKey = SortKey::Name;
+        break;
+
+    case NotebookNodeExplorer::ViewOrder::OrderedByCreatedTimeReversed:
+        reversed = true;
+        Q_FALLTHROUGH();
+    case NotebookNodeExplorer::ViewOrder::OrderedByCreatedTime:
+        sortKey = SortKey::CreatedTime;
+        break;
+
+    case NotebookNodeExplorer::ViewOrder::OrderedByModifiedTimeReversed:
+        reversed = true;
+        Q_FALLTHROUGH();
+    case NotebookNodeExplorer::ViewOrder::OrderedByModifiedTime:
+        sortKey = SortKey::ModifiedTime;
+        break;
+
+    default:
+        return;
+    }
+
+    // Compute keys once instead of per comparison.
+    struct SortItem
+    {
+        qint64 m_time = 0;
+
+        QSharedPointer<Node> m_node;
+    };
+
+    QVector<SortItem> items;
+    items.reserve(p_end - p_start);
+    for (int i = p_start; i < p_end; ++i) {
+        SortItem item;
+        item.m_node = p_nodes[i];
+        if (sortKey != SortKey::Name) {
+            item.m_time = timeSortKey(item.m_node.data(), sortKey == SortKey::CreatedTime);
+        }
+        items.push_back(item);
+    }
+
+    std::sort(items.begin(), items.end(), [sortKey, reversed](const SortItem &p_a, const SortItem &p_b) {
+        const auto &lhs = reversed ? p_b : p_a;
+        const auto &rhs = reversed ? p_a : p_b;
+        if (sortKey == SortKey::Name) {
+            return lhs.m_node->getName() < rhs.m_node->getName();
+        }
+        return lhs.m_time < rhs.m_time;
+    });
+
+    for (int i = 0; i < items.size(); ++i) {
+        p_nodes[p_start + i] = items[i].m_node;
+    }
+}
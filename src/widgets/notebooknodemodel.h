@@ -0,0 +1,210 @@
+#ifndef NOTEBOOKNODEMODEL_H
+#define NOTEBOOKNODEMODEL_H
+
+#include <QAbstractItemModel>
+#include <QSharedPointer>
+#include <QWeakPointer>
+#include <QHash>
+#include <QSet>
+#include <QIcon>
+
+#include "notebooknodeexplorer.h"
+
+class QTimer;
+
+namespace vnotex
+{
+    class Notebook;
+    class Node;
+    class ExternalNode;
+
+    // Model over the node tree of a notebook.
+    // Children of a node are fetched lazily on expansion and kept in sync with
+    // the node tree by updateNode() via row insertions, removals and moves.
+    class NotebookNodeModel : public QAbstractItemModel
+    {
+        Q_OBJECT
+    public:
+        enum Role
+        {
+            // NotebookNodeExplorer::NodeData of the index.
+            NodeDataRole = Qt::UserRole
+        };
+
+        explicit NotebookNodeModel(QObject *p_parent = nullptr);
+
+        ~NotebookNodeModel();
+
+        // Will throw if failed to load the root node.
+        void setNotebook(const QSharedPointer<Notebook> &p_notebook);
+
+        void setRecycleBinNodeVisible(bool p_visible);
+
+        void setExternalFilesVisible(bool p_visible);
+
+        void setViewOrder(int p_order);
+
+        // Sync the fetched children of @p_node with the node tree recursively.
+        // If @p_node is null, update the whole tree.
+        void updateNode(Node *p_node);
+
+        // Return invalid index if @p_node is not fetched yet.
+        QModelIndex indexOfNode(const Node *p_node) const;
+
+        // Fetch ancestors of @p_node if needed.
+        QModelIndex fetchIndexOfNode(Node *p_node);
+
+        // Fetch children of @p_parent.
+        // @p_async: whether load the node in background if it is not loaded yet.
+        void fetchChildren(const QModelIndex &p_parent, bool p_async);
+
+        static NotebookNodeExplorer::NodeData nodeData(const QModelIndex &p_index);
+
+        static const QIcon &getNodeIcon(const Node *p_node);
+
+        static const QIcon &getNodeIcon(const ExternalNode *p_node);
+
+        QModelIndex index(int p_row, int p_column, const QModelIndex &p_parent = QModelIndex()) const Q_DECL_OVERRIDE;
+
+        QModelIndex parent(const QModelIndex &p_index) const Q_DECL_OVERRIDE;
+
+        int rowCount(const QModelIndex &p_parent = QModelIndex()) const Q_DECL_OVERRIDE;
+
+        int columnCount(const QModelIndex &p_parent = QModelIndex()) const Q_DECL_OVERRIDE;
+
+        QVariant data(const QModelIndex &p_index, int p_role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+
+        Qt::ItemFlags flags(const QModelIndex &p_index) const Q_DECL_OVERRIDE;
+
+        bool hasChildren(const QModelIndex &p_parent = QModelIndex()) const Q_DECL_OVERRIDE;
+
+        bool canFetchMore(const QModelIndex &p_parent) const Q_DECL_OVERRIDE;
+
+        void fetchMore(const QModelIndex &p_parent) Q_DECL_OVERRIDE;
+
+    private:
+        struct Item
+        {
+            ~Item();
+
+            bool isPlaceholder() const;
+
+            // Whether it is a node item whose node has been deleted.
+            bool isStale() const;
+
+            // Invalid for the placeholder shown during loading.
+            NotebookNodeExplorer::NodeData m_data;
+
+            // To tell whether the node of m_data is still alive.
+            QWeakPointer<Node> m_node;
+
+            Item *m_parent = nullptr;
+
+            // Row within the parent.
+            int m_row = 0;
+
+            QVector<Item *> m_children;
+
+            // Whether children are fetched.
+            bool m_fetched = false;
+
+            // Whether the node is being loaded in background.
+            bool m_loading = false;
+
+            // Displayed state of m_data when the row is last refreshed.
+            QString m_state;
+        };
+
+        // Used to match items with nodes without dereferencing the node,
+        // which may have been deleted.
+        typedef QPair<const void *, QString> ItemKey;
+
+        static ItemKey itemKey(const NotebookNodeExplorer::NodeData &p_data);
+
+        // State of @p_data shown in its row apart from its key, to tell whether
+        // a kept row needs a refresh.
+        static QString itemState(const NotebookNodeExplorer::NodeData &p_data);
+
+        static void initNodeIcons();
+
+        Item *itemFromIndex(const QModelIndex &p_index) const;
+
+        QModelIndex indexOfItem(const Item *p_item) const;
+
+        // Data of the children of @p_item in display order.
+        QVector<NotebookNodeExplorer::NodeData> fetchChildrenData(const Item *p_item) const;
+
+        // Sync children of a fetched @p_item with the node tree recursively.
+        void syncChildren(Item *p_item);
+
+        void removeChildren(Item *p_item, int p_first, int p_last);
+
+        void insertChildren(Item *p_item, int p_row, const QVector<NotebookNodeExplorer::NodeData> &p_data);
+
+        Item *createItem(const NotebookNodeExplorer::NodeData &p_data, Item *p_parent);
+
+        // Unregister @p_item and its descendants from the node map.
+        void unregisterItem(const Item *p_item);
+
+        void updateRows(Item *p_item, int p_first);
+
+        void handleNodeLoaded(Node *p_node);
+
+        // Watch the folder of fetched @p_item to catch external changes.
+        void watchFolder(const Item *p_item);
+
+        void unwatchFolder(const Item *p_item);
+
+        void unwatchAllFolders();
+
+        void handleDirectoriesChanged(const QStringList &p_dirs);
+
+        // Check existence of children of changed folders with one listing per folder.
+        void syncChangedFolders();
+
+        void sortNodes(QVector<QSharedPointer<Node>> &p_nodes) const;
+
+        // [p_start, p_end).
+        void sortNodes(QVector<QSharedPointer<Node>> &p_nodes, int p_start, int p_end, int p_viewOrder) const;
+
+        void resetRoot();
+
+        QSharedPointer<Notebook> m_notebook;
+
+        // Hidden item of the root node.
+        Item *m_root = nullptr;
+
+        QHash<const Node *, Item *> m_nodeItems;
+
+        // Folder watched for each fetched node.
+        QHash<const Node *, QString> m_watchedFolders;
+
+        // Watched folders changed since last sync.
+        QSet<const Node *> m_changedFolders;
+
+        // Batch the changes of folders, such as the bursts of our own writes.
+        QTimer *m_changedFoldersTimer = nullptr;
+
+        bool m_recycleBinNodeVisible = false;
+
+        bool m_externalFilesVisible = true;
+
+        int m_viewOrder = NotebookNodeExplorer::ViewOrder::OrderedByConfiguration;
+
+        static QIcon s_folderNodeIcon;
+
+        static QIcon s_fileNodeIcon;
+
+        static QIcon s_invalidFolderNodeIcon;
+
+        static QIcon s_invalidFileNodeIcon;
+
+        static QIcon s_recycleBinNodeIcon;
+
+        static QIcon s_externalFolderNodeIcon;
+
+        static QIcon s_externalFileNodeIcon;
+    };
+} // ns vnotex
+
+#endif // NOTEBOOKNODEMODEL_H
@@ -41,3 +41,8 @@ QVector<Notebook *> SearchInfoProvider::getNotebooks() const
 
     return nbs;
 }
+
+QStringList SearchInfoProvider::getPendingNotebooks() const
+{
+    return m_notebookMgr->getPendingNotebookRootFolderPaths();
+}
@@ -24,6 +24,8 @@ namespace vnotex
 
         QVector<Notebook *> getNotebooks() const Q_DECL_OVERRIDE;
 
+        QStringList getPendingNotebooks() const Q_DECL_OVERRIDE;
+
     private:
         const ViewArea *m_viewArea = nullptr;
 
@@ -473,6 +473,11 @@ SearchState SearchPanel::search(const QSharedPointer<SearchOption> &p_option)
 
     case SearchScope::AllNotebooks:
     {
+        const auto pendingNotebooks = m_provider->getPendingNotebooks();
+        if (!pendingNotebooks.isEmpty()) {
+            appendLog(tr("Notebooks not opened yet are skipped: %1").arg(pendingNotebooks.join(QStringLiteral(", "))));
+        }
+
         auto notebooks = m_provider->getNotebooks();
         if (notebooks.isEmpty()) {
             break;
@@ -4,6 +4,7 @@
 #include <QFrame>
 #include <QSharedPointer>
 #include <QList>
+#include <QStringList>
 
 #include <search/searchdata.h>
 #include <search/searcher.h>
@@ -41,6 +42,9 @@ namespace vnotex
         virtual Notebook *getCurrentNotebook() const = 0;
 
         virtual QVector<Notebook *> getNotebooks() const = 0;
+
+        // Root folders of notebooks not opened yet, which are not searched.
+        virtual QStringList getPendingNotebooks() const = 0;
     };
 
     class SearchPanel : public QFrame
@@ -4,6 +4,8 @@
 #include <QtWidgets>
 
 #include "mainwindow.h"
+#include "fileoperationstatuswidget.h"
+#include "vnotex.h"
 
 using namespace vnotex;
 
@@ -11,4 +13,6 @@ void StatusBarHelper::setupStatusBar(MainWindow *p_win)
 {
     m_statusBar = new QStatusBar(p_win);
     p_win->setStatusBar(m_statusBar);
+
+    m_statusBar->addPermanentWidget(new FileOperationStatusWidget(&VNoteX::getInst().getFileOperationQueue(), m_statusBar));
 }
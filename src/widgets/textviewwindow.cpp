@@ -247,6 +247,10 @@ void TextViewWindow::handleFileOpenParameters(const QSharedPointer<FileOpenParam
 
 ViewWindowSession TextViewWindow::saveSession() const
 {
+    if (isHibernated()) {
+        return getHibernatedSession();
+    }
+
     auto session = ViewWindow::saveSession();
     if (getBuffer()) {
         session.m_lineNumber = m_editor->getCursorPosition().first;
@@ -254,6 +258,14 @@ ViewWindowSession TextViewWindow::saveSession() const
     return session;
 }
 
+void TextViewWindow::hibernateInternal()
+{
+    // The editor lives along with the window. Just drop its document.
+    m_propogateEditorToBuffer = false;
+    m_editor->setText("");
+    m_editor->setModified(false);
+}
+
 void TextViewWindow::applySnippet(const QString &p_name)
 {
     TextViewWindowHelper::applySnippet(this, p_name);
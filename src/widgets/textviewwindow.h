@@ -58,6 +58,8 @@ namespace vnotex
 
         void syncEditorFromBufferContent() Q_DECL_OVERRIDE;
 
+        void hibernateInternal() Q_DECL_OVERRIDE;
+
         void scrollUp() Q_DECL_OVERRIDE;
 
         void scrollDown() Q_DECL_OVERRIDE;
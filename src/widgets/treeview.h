@@ -3,6 +3,8 @@
 
 #include <QTreeView>
 #include <QVariant>
+#include <QVector>
+#include <QModelIndex>
 
 namespace vnotex
 {
@@ -10,11 +12,33 @@ namespace vnotex
     {
         Q_OBJECT
     public:
+        enum Flag
+        {
+            None = 0,
+            ClickSpaceToClearSelection = 0x1
+        };
+        Q_DECLARE_FLAGS(Flags, Flag)
+
         explicit TreeView(QWidget *p_parent = nullptr);
 
+        TreeView(TreeView::Flags p_flags, QWidget *p_parent = nullptr);
+
+        static void setupSingleColumnHeaderlessTree(QTreeView *p_view, bool p_contextMenu, bool p_extendedSelection);
+
+        static void showHorizontalScrollbar(QTreeView *p_view);
+
+        static QVector<QModelIndex> getVisibleIndexes(const QTreeView *p_view);
+
     protected:
+        void mousePressEvent(QMouseEvent *p_event) Q_DECL_OVERRIDE;
+
         void keyPressEvent(QKeyEvent *p_event) Q_DECL_OVERRIDE;
+
+    private:
+        Flags m_flags = Flag::None;
     };
-}
+
+    Q_DECLARE_OPERATORS_FOR_FLAGS(TreeView::Flags)
+} // ns vnotex
 
 #endif // TREEVIEW_H
@@ -22,6 +22,7 @@
 #include <utils/urldragdroputils.h>
 #include <core/events.h>
 #include <core/vnotex.h>
+#include <core/buffermgr.h>
 #include <core/configmgr.h>
 #include <core/coreconfig.h>
 #include <core/editorconfig.h>
@@ -102,16 +103,25 @@ ViewArea::ViewArea(QWidget *p_parent)
             });
 
     m_fileCheckTimer = new QTimer(this);
-    m_fileCheckTimer->setSingleShot(false);
-    m_fileCheckTimer->setInterval(2000);
+    m_fileCheckTimer->setSingleShot(true);
+    m_fileCheckTimer->setInterval(200);
     connect(m_fileCheckTimer, &QTimer::timeout,
             this, [this]() {
                 auto win = getCurrentViewWindow();
-                if (win) {
+                if (win && QApplication::activeWindow()) {
                     win->checkFileMissingOrChangedOutsidePeriodically();
                 }
             });
 
+    // Windows not current will be checked once they become current.
+    connect(&VNoteX::getInst().getBufferMgr(), &BufferMgr::bufferFileChanged,
+            this, [this](Buffer *p_buffer) {
+                auto win = getCurrentViewWindow();
+                if (win && win->getBuffer() == p_buffer) {
+                    m_fileCheckTimer->start();
+                }
+            });
+
     connect(qApp, &QApplication::focusChanged,
             this, [this](QWidget *p_old, QWidget *p_now) {
                 if (!p_now) {
@@ -176,6 +186,10 @@ void ViewArea::openBuffer(Buffer *p_buffer, const QSharedPointer<FileOpenParamet
         // Create a ViewWindow from @p_buffer.
         auto window = p_buffer->createViewWindow(p_paras, nullptr);
         m_currentSplit->addViewWindow(window);
+        if (p_paras->m_deferred) {
+            // Keep it in background.
+            return;
+        }
         setCurrentViewWindow(window);
     } else {
         auto selectedWin = wins.first();
@@ -331,8 +345,6 @@ void ViewArea::postFirstViewSplit()
 
     emit viewSplitsCountChanged();
     checkCurrentViewWindowChange();
-
-    m_fileCheckTimer->start();
 }
 
 static ViewSplit *fetchFirstChildViewSplit(const QSplitter *p_splitter)
@@ -914,6 +926,11 @@ void ViewArea::checkCurrentViewWindowChange()
 
     m_currentWindow = win;
     emit currentViewWindowChanged();
+
+    // Timer is not created yet during setup.
+    if (m_currentWindow && m_fileCheckTimer) {
+        m_fileCheckTimer->start();
+    }
 }
 
 bool ViewArea::closeIf(bool p_force, const ViewSplit::ViewWindowSelector &p_func, bool p_closeEmptySplit)
@@ -1183,6 +1200,12 @@ void ViewArea::loadSession()
             }
         }
 
+        // Restored windows are opened without focus.
+        auto win = getCurrentViewWindow();
+        if (win) {
+            win->setFocus(Qt::OtherFocusReason);
+        }
+
         postFirstViewSplit();
 
         distributeViewSplits();
@@ -1290,6 +1313,8 @@ void ViewArea::openViewWindowFromSession(const ViewWindowSession &p_session)
     paras->m_readOnly = p_session.m_readOnly;
     paras->m_lineNumber = p_session.m_lineNumber;
     paras->m_alwaysNewWindow = true;
+    paras->m_focus = false;
+    paras->m_deferred = true;
 
     emit VNoteX::getInst().openFileRequested(p_session.m_bufferPath, paras);
 }
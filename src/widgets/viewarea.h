@@ -249,7 +249,8 @@ namespace vnotex
 
         QVector<ViewSplit::ViewWindowNavigationModeInfo> m_navigationItems;
 
-        // Timer to check file change outside periodically.
+        // Timer to check file change outside of current view window.
+        // Started on file change events, window switches and app activation.
         QTimer *m_fileCheckTimer = nullptr;
 
         ID m_nextViewSplitId = InvalidViewSplitId + 1;
@@ -326,7 +326,8 @@ void ViewSplit::addViewWindow(ViewWindow *p_win)
     setTabToolTip(idx, p_win->getTitle());
 
     p_win->setViewSplit(this);
-    p_win->setVisible(true);
+    // Leave it to the stacked layout which shows only the current window, so that
+    // deferred windows are not woken up until activated.
 
     connect(p_win, &ViewWindow::focused,
             this, [this]() {
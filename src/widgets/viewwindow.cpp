@@ -68,6 +68,11 @@ ViewWindow::ViewWindow(QWidget *p_parent)
     connect(m_syncBufferContentTimer, &QTimer::timeout,
             this, [this]() {
                 Q_ASSERT(getBuffer());
+                if (m_hibernated) {
+                    // Will sync all on wake up.
+                    return;
+                }
+
                 if (getBuffer()->getRevision() != m_bufferRevision) {
                     syncEditorFromBufferContent();
                 }
@@ -120,6 +125,8 @@ Buffer *ViewWindow::getBuffer() const
 
 void ViewWindow::handleBufferChanged(const QSharedPointer<FileOpenParameters> &p_paras)
 {
+    m_hibernated = false;
+
     auto buffer = getBuffer();
     if (buffer) {
         connect(buffer, &Buffer::modified,
@@ -137,9 +144,22 @@ void ViewWindow::handleBufferChanged(const QSharedPointer<FileOpenParameters> &p
 
         connect(buffer, &Buffer::attachmentChanged,
                 this, &ViewWindow::attachmentChanged);
+
+        connect(buffer, &Buffer::aboutToHibernate,
+                this, &ViewWindow::hibernate);
     }
 
-    handleBufferChangedInternal(p_paras);
+    if (buffer && p_paras && p_paras->m_deferred) {
+        // Start as hibernated and wake up on first show.
+        m_hibernatedSession = ViewWindowSession();
+        m_hibernatedSession.m_bufferPath = buffer->getPath();
+        m_hibernatedSession.m_readOnly = buffer->isReadOnly();
+        m_hibernatedSession.m_viewWindowMode = p_paras->m_mode;
+        m_hibernatedSession.m_lineNumber = p_paras->m_lineNumber;
+        m_hibernated = true;
+    } else {
+        handleBufferChangedInternal(p_paras);
+    }
 
     emit bufferChanged();
 }
@@ -629,7 +649,7 @@ void ViewWindow::detachFromBufferInternal()
 void ViewWindow::checkBackupFileOfPreviousSession()
 {
     Q_ASSERT(m_buffer);
-    const auto &backupFile = m_buffer->getBackupFileOfPreviousSession();
+    const auto backupFile = m_buffer->getBackupFileOfPreviousSession();
     if (backupFile.isEmpty()) {
         return;
     }
@@ -648,7 +668,12 @@ void ViewWindow::checkBackupFileOfPreviousSession()
         this);
     switch (ret) {
     case QMessageBox::Yes:
-        m_buffer->recoverFromBackupFileOfPreviousSession();
+        if (!m_buffer->recoverFromBackupFileOfPreviousSession()) {
+            MessageBoxHelper::notify(MessageBoxHelper::Warning,
+                                     tr("Failed to recover from backup file (%1) since the file has changed since then.")
+                                       .arg(backupFile),
+                                     this);
+        }
         break;
 
     case QMessageBox::No:
@@ -880,6 +905,56 @@ void ViewWindow::setupShortcuts()
     }
 }
 
+void ViewWindow::showEvent(QShowEvent *p_event)
+{
+    QFrame::showEvent(p_event);
+
+    if (m_buffer) {
+        wakeUp();
+        m_buffer->activate();
+    }
+}
+
+bool ViewWindow::isHibernated() const
+{
+    return m_hibernated;
+}
+
+const ViewWindowSession &ViewWindow::getHibernatedSession() const
+{
+    return m_hibernatedSession;
+}
+
+void ViewWindow::hibernate()
+{
+    Q_ASSERT(!isVisible());
+    if (m_hibernated) {
+        // The buffer is woken up by others without showing this window.
+        return;
+    }
+
+    m_hibernatedSession = saveSession();
+    m_syncBufferContentTimer->stop();
+
+    hibernateInternal();
+    m_hibernated = true;
+}
+
+void ViewWindow::wakeUp()
+{
+    if (!m_hibernated) {
+        return;
+    }
+
+    m_hibernated = false;
+
+    auto paras = QSharedPointer<FileOpenParameters>::create();
+    paras->m_mode = m_hibernatedSession.m_viewWindowMode;
+    paras->m_forceMode = true;
+    paras->m_lineNumber = m_hibernatedSession.m_lineNumber;
+    handleBufferChangedInternal(paras);
+}
+
 void ViewWindow::wheelEvent(QWheelEvent *p_event)
 {
     if (p_event->modifiers() & Qt::ControlModifier) {
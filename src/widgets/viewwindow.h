@@ -48,6 +48,9 @@ namespace vnotex
 
         void detachFromBuffer(bool p_quiet = false);
 
+        // Whether the editors are released along with the hibernated buffer.
+        bool isHibernated() const;
+
         // User request to open the buffer attached to this ViewWindow again.
         virtual void openTwice(const QSharedPointer<FileOpenParameters> &p_paras) = 0;
 
@@ -185,6 +188,8 @@ namespace vnotex
 
         void wheelEvent(QWheelEvent *p_event) Q_DECL_OVERRIDE;
 
+        void showEvent(QShowEvent *p_event) Q_DECL_OVERRIDE;
+
         void keyPressEvent(QKeyEvent *p_event) Q_DECL_OVERRIDE;
 
         // Provide some common actions of tool bar for ViewWindow.
@@ -207,6 +212,13 @@ namespace vnotex
 
         virtual void detachFromBufferInternal();
 
+        // Release the editors and their content since the buffer is hibernating.
+        // The window will be synced with the buffer again by handleBufferChangedInternal() once shown.
+        virtual void hibernateInternal() = 0;
+
+        // Session saved on hibernation.
+        const ViewWindowSession &getHibernatedSession() const;
+
         virtual void scrollUp() = 0;
 
         virtual void scrollDown() = 0;
@@ -301,6 +313,11 @@ namespace vnotex
 
         void handleBufferChanged(const QSharedPointer<FileOpenParameters> &p_paras);
 
+        void hibernate();
+
+        // Restore the editors released by hibernate() with the saved position.
+        void wakeUp();
+
         static ViewWindow::TypeAction toolBarActionToTypeAction(ViewWindowToolBarHelper::Action p_action);
 
         Buffer *m_buffer = nullptr;
@@ -343,6 +360,10 @@ namespace vnotex
 
         WindowFlags m_flags = WindowFlag::None;
 
+        bool m_hibernated = false;
+
+        ViewWindowSession m_hibernatedSession;
+
         static QIcon s_savedIcon;
         static QIcon s_modifiedIcon;
     };
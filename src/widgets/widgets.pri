@@ -39,6 +39,7 @@ SOURCES += \
     $$PWD/editors/markdowntablehelper.cpp \
     $$PWD/editors/markdownviewer.cpp \
     $$PWD/editors/markdownvieweradapter.cpp \
+    $$PWD/editors/markdownviewerpool.cpp \
     $$PWD/editors/plantumlhelper.cpp \
     $$PWD/editors/previewhelper.cpp \
     $$PWD/editors/statuswidget.cpp \
@@ -87,6 +88,7 @@ SOURCES += \
     $$PWD/dialogs/scrolldialog.cpp \
     $$PWD/notebookselector.cpp \
     $$PWD/notebooknodeexplorer.cpp \
+    $$PWD/notebooknodemodel.cpp \
     $$PWD/messageboxhelper.cpp \
     $$PWD/dialogs/newfolderdialog.cpp \
     $$PWD/treewidget.cpp \
@@ -98,6 +100,7 @@ SOURCES += \
     $$PWD/dialogs/folderpropertiesdialog.cpp \
     $$PWD/dialogs/nodeinfowidget.cpp \
     $$PWD/statusbarhelper.cpp \
+    $$PWD/fileoperationstatuswidget.cpp \
     $$PWD/dialogs/deleteconfirmdialog.cpp \
     $$PWD/dialogs/importfolderutils.cpp \
     $$PWD/titletoolbar.cpp \
@@ -145,6 +148,7 @@ HEADERS += \
     $$PWD/editors/markdowntablehelper.h \
     $$PWD/editors/markdownviewer.h \
     $$PWD/editors/markdownvieweradapter.h \
+    $$PWD/editors/markdownviewerpool.h \
     $$PWD/editors/plantumlhelper.h \
     $$PWD/editors/previewhelper.h \
     $$PWD/editors/statuswidget.h \
@@ -195,9 +199,9 @@ HEADERS += \
     $$PWD/dialogs/scrolldialog.h \
     $$PWD/notebookselector.h \
     $$PWD/notebooknodeexplorer.h \
+    $$PWD/notebooknodemodel.h \
     $$PWD/messageboxhelper.h \
     $$PWD/dialogs/newfolderdialog.h \
-    $$PWD/qtreewidgetstatecache.h \
     $$PWD/treewidget.h \
     $$PWD/dialogs/newnotedialog.h \
     $$PWD/dialogs/managenotebooksdialog.h \
@@ -207,6 +211,7 @@ HEADERS += \
     $$PWD/dialogs/folderpropertiesdialog.h \
     $$PWD/dialogs/nodeinfowidget.h \
     $$PWD/statusbarhelper.h \
+    $$PWD/fileoperationstatuswidget.h \
     $$PWD/dialogs/deleteconfirmdialog.h \
     $$PWD/titletoolbar.h \
     $$PWD/viewarea.h
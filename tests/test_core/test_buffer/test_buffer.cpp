@@ -0,0 +1,119 @@
+#include "test_buffer.h"
+
+#include <buffer/buffer.h>
+#include <buffer/markdownbuffer.h>
+#include <buffer/filebufferprovider.h>
+#include <externalfile.h>
+#include <utils/pathutils.h>
+#include <utils/fileutils.h>
+
+using namespace tests;
+
+using namespace vnotex;
+
+TestBuffer::TestBuffer(QObject *p_parent)
+    : QObject(p_parent)
+{
+}
+
+QString TestBuffer::writeBackupFile(const QString &p_name, const QString &p_text) const
+{
+    const auto filePath = PathUtils::concatenateFilePath(m_testDir.path(), p_name);
+    FileUtils::writeFile(filePath, p_text.toUtf8());
+    return filePath;
+}
+
+void TestBuffer::testReadBackupFile()
+{
+    const QString base("hello world");
+    const auto head = QString("vnotex_backup_journal /notes/a.md|%1\n").arg(Buffer::backupBaseHash(base));
+
+    // Edits are replayed against the base.
+    auto filePath = writeBackupFile("edits.vswp", head + "D5,6,7:, vnote\n" + "D12,0,1:!\n");
+    QCOMPARE(Buffer::readBackupFile(filePath, base), QString("hello, vnote!"));
+
+    // Edits after a snapshot apply to the snapshot.
+    filePath = writeBackupFile("snapshot.vswp", head + "D0,5,3:bye\n" + "S3:abc\n" + "D3,0,1:d\n");
+    QCOMPARE(Buffer::readBackupFile(filePath, base), QString("abcd"));
+
+    // A torn record at the end is skipped.
+    filePath = writeBackupFile("torn.vswp", head + "D5,6,0:\n" + "D5,0,9:, vn");
+    QCOMPARE(Buffer::readBackupFile(filePath, base), QString("hello"));
+
+    // No edits at all.
+    filePath = writeBackupFile("empty.vswp", head);
+    QCOMPARE(Buffer::readBackupFile(filePath, base), base);
+}
+
+void TestBuffer::testReadBackupFileOfAnotherBase()
+{
+    const QString base("hello world");
+    const auto head = QString("vnotex_backup_journal /notes/a.md|%1\n").arg(Buffer::backupBaseHash("hello"));
+
+    // Edits of another base are refused.
+    auto filePath = writeBackupFile("edits.vswp", head + "D5,0,6: vnote\n");
+    QVERIFY(Buffer::readBackupFile(filePath, base).isNull());
+
+    filePath = writeBackupFile("empty.vswp", head);
+    QVERIFY(Buffer::readBackupFile(filePath, base).isNull());
+
+    // A snapshot does not depend on the base.
+    filePath = writeBackupFile("snapshot.vswp", head + "D5,0,6: vnote\n" + "S3:abc\n" + "D0,1,1:x\n");
+    QCOMPARE(Buffer::readBackupFile(filePath, base), QString("xbc"));
+}
+
+void TestBuffer::testReadLegacyBackupFile()
+{
+    const QString base("hello world");
+
+    // Journal without the base hash.
+    auto filePath = writeBackupFile("journal.vswp", "vnotex_backup_journal /notes/a.md|\nD0,5,3:bye\n");
+    QCOMPARE(Buffer::readBackupFile(filePath, base), QString("bye world"));
+
+    // Full content.
+    filePath = writeBackupFile("full.vswp", "vnotex_backup_file /notes/a.md|line 1\nline 2");
+    QCOMPARE(Buffer::readBackupFile(filePath, base), QString("line 1\nline 2"));
+}
+
+void TestBuffer::testReplayEditsOfSurrogatePairs()
+{
+    const auto base = QString::fromUtf8("a\xF0\x9F\x98\x80b");
+    const auto head = QString("vnotex_backup_journal /notes/a.md|%1\n").arg(Buffer::backupBaseHash(base));
+
+    // Same high surrogate.
+    const auto joy = QString::fromUtf8("a\xF0\x9F\x98\x82b");
+    auto filePath = writeBackupFile("high.vswp", head + QString::fromUtf8(Buffer::backupEditRecord(base, joy)));
+    QCOMPARE(Buffer::readBackupFile(filePath, base), joy);
+
+    // Same low surrogate.
+    const auto linearA = QString::fromUtf8("a\xF0\x90\x98\x80b");
+    filePath = writeBackupFile("low.vswp", head + QString::fromUtf8(Buffer::backupEditRecord(base, linearA)));
+    QCOMPARE(Buffer::readBackupFile(filePath, base), linearA);
+}
+
+void TestBuffer::testHibernateAndWakeUp()
+{
+    const auto filePath = writeBackupFile("note.md", "# hello");
+
+    BufferParameters paras;
+    paras.m_provider.reset(new FileBufferProvider(QSharedPointer<ExternalFile>::create(filePath),
+                                                  nullptr,
+                                                  false));
+    MarkdownBuffer buffer(paras);
+    buffer.setLargeFileFeatures(0x3);
+
+    QVERIFY(buffer.hibernate());
+    QVERIFY(buffer.isHibernated());
+    QCOMPARE(buffer.estimateMemoryCost(), Q_INT64_C(0));
+
+    // Changes on disk are picked up on wake-up.
+    FileUtils::writeFile(filePath, QString("# world").toUtf8());
+    buffer.wakeUp();
+    QVERIFY(!buffer.isHibernated());
+    QCOMPARE(buffer.getContent(), QString("# world"));
+
+    // Features enabled by user are kept.
+    QCOMPARE(buffer.getLargeFileFeatures(), 0x3);
+}
+
+QTEST_MAIN(tests::TestBuffer)
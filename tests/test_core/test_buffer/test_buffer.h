@@ -0,0 +1,34 @@
+#ifndef TEST_BUFFER_H
+#define TEST_BUFFER_H
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+namespace tests
+{
+    class TestBuffer : public QObject
+    {
+        Q_OBJECT
+    public:
+        explicit TestBuffer(QObject *p_parent = nullptr);
+
+    private slots:
+        // Define test cases here per slot.
+        void testReadBackupFile();
+
+        void testReadBackupFileOfAnotherBase();
+
+        void testReadLegacyBackupFile();
+
+        void testReplayEditsOfSurrogatePairs();
+
+        void testHibernateAndWakeUp();
+
+    private:
+        QString writeBackupFile(const QString &p_name, const QString &p_text) const;
+
+        QTemporaryDir m_testDir;
+    };
+} // ns tests
+
+#endif // TEST_BUFFER_H
@@ -0,0 +1,28 @@
+include($$PWD/../../common.pri)
+
+TARGET = test_buffer
+TEMPLATE = app
+
+SRC_FOLDER = $$PWD/../../../src
+CORE_FOLDER = $$SRC_FOLDER/core
+
+INCLUDEPATH *= $$SRC_FOLDER
+
+LIBS_FOLDER = $$PWD/../../../libs
+
+include($$LIBS_FOLDER/vtextedit/src/editor/editor_export.pri)
+
+include($$LIBS_FOLDER/vtextedit/src/libs/syntax-highlighting/syntax-highlighting_export.pri)
+
+include($$CORE_FOLDER/core.pri)
+include($$SRC_FOLDER/widgets/widgets.pri)
+include($$SRC_FOLDER/utils/utils.pri)
+include($$SRC_FOLDER/export/export.pri)
+include($$SRC_FOLDER/search/search.pri)
+include($$SRC_FOLDER/snippet/snippet.pri)
+
+SOURCES += \
+    test_buffer.cpp
+
+HEADERS += \
+    test_buffer.h
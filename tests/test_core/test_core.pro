@@ -1,5 +1,7 @@
 TEMPLATE = subdirs
 
 SUBDIRS = \
+    test_buffer \
+    test_filewatcher \
     test_notebook \
     test_theme
@@ -0,0 +1,108 @@
+#include "test_filewatcher.h"
+
+#include <QTemporaryDir>
+#include <QSignalSpy>
+#include <QFile>
+
+#include <filewatcher.h>
+#include <utils/pathutils.h>
+
+using namespace tests;
+
+using namespace vnotex;
+
+TestFileWatcher::TestFileWatcher(QObject *p_parent)
+    : QObject(p_parent)
+{
+}
+
+void TestFileWatcher::writeFile(const QString &p_filePath, const QByteArray &p_data)
+{
+    QFile file(p_filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(p_data);
+}
+
+void TestFileWatcher::testCoalesceChanges()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const auto filePath = PathUtils::concatenateFilePath(dir.path(), "file.md");
+    writeFile(filePath, "a");
+
+    FileWatcher watcher;
+    watcher.addPath(filePath);
+    watcher.addPath(filePath);
+    QVERIFY(watcher.isWatched(filePath));
+
+    QSignalSpy spy(&watcher, &FileWatcher::filesChanged);
+    writeFile(filePath, "ab");
+    writeFile(filePath, "abc");
+    writeFile(filePath, "abcd");
+
+    QVERIFY(spy.wait());
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toStringList(), QStringList() << filePath);
+
+    // Reference counted.
+    watcher.removePath(filePath);
+    QVERIFY(watcher.isWatched(filePath));
+    watcher.removePath(filePath);
+    QVERIFY(!watcher.isWatched(filePath));
+}
+
+void TestFileWatcher::testWatchFileCreatedLater()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const auto filePath = PathUtils::concatenateFilePath(dir.path(), "new.md");
+
+    FileWatcher watcher;
+    watcher.addPath(filePath);
+
+    QSignalSpy spy(&watcher, &FileWatcher::filesChanged);
+    QSignalSpy dirSpy(&watcher, &FileWatcher::directoriesChanged);
+    writeFile(filePath, "a");
+    QVERIFY(spy.wait());
+    QVERIFY(spy.at(0).at(0).toStringList().contains(filePath));
+
+    // Parent folder watched for the pending file is not reported.
+    QCOMPARE(dirSpy.count(), 0);
+
+    // Promoted to a file watch.
+    spy.clear();
+    writeFile(filePath, "ab");
+    QVERIFY(spy.wait());
+    QVERIFY(spy.at(0).at(0).toStringList().contains(filePath));
+}
+
+void TestFileWatcher::testWatchFileRenamed()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const auto filePath = PathUtils::concatenateFilePath(dir.path(), "file.md");
+    const auto tmpFilePath = PathUtils::concatenateFilePath(dir.path(), "file.md.tmp");
+    writeFile(filePath, "a");
+
+    FileWatcher watcher;
+    watcher.addPath(filePath);
+
+    // Renamed away.
+    QSignalSpy spy(&watcher, &FileWatcher::filesChanged);
+    QVERIFY(QFile::rename(filePath, tmpFilePath));
+    QVERIFY(spy.wait());
+    QVERIFY(spy.at(0).at(0).toStringList().contains(filePath));
+
+    // Replaced by a rename, as editors save files.
+    spy.clear();
+    QVERIFY(QFile::rename(tmpFilePath, filePath));
+    QVERIFY(spy.wait());
+    QVERIFY(spy.at(0).at(0).toStringList().contains(filePath));
+
+    spy.clear();
+    writeFile(filePath, "ab");
+    QVERIFY(spy.wait());
+    QVERIFY(spy.at(0).at(0).toStringList().contains(filePath));
+}
+
+QTEST_MAIN(tests::TestFileWatcher)
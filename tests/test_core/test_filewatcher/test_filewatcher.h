@@ -0,0 +1,27 @@
+#ifndef TEST_FILEWATCHER_H
+#define TEST_FILEWATCHER_H
+
+#include <QtTest>
+
+namespace tests
+{
+    class TestFileWatcher : public QObject
+    {
+        Q_OBJECT
+    public:
+        explicit TestFileWatcher(QObject *p_parent = nullptr);
+
+    private slots:
+        // Define test cases here per slot.
+        void testCoalesceChanges();
+
+        void testWatchFileCreatedLater();
+
+        void testWatchFileRenamed();
+
+    private:
+        static void writeFile(const QString &p_filePath, const QByteArray &p_data);
+    };
+} // ns tests
+
+#endif // TEST_FILEWATCHER_H
@@ -0,0 +1,28 @@
+include($$PWD/../../common.pri)
+
+TARGET = test_filewatcher
+TEMPLATE = app
+
+SRC_FOLDER = $$PWD/../../../src
+CORE_FOLDER = $$SRC_FOLDER/core
+UTILS_FOLDER = $$SRC_FOLDER/utils
+
+INCLUDEPATH *= $$SRC_FOLDER
+INCLUDEPATH *= $$SRC_FOLDER/core
+
+SOURCES += \
+    test_filewatcher.cpp \
+    $$CORE_FOLDER/filewatcher.cpp \
+    $$UTILS_FOLDER/pathutils.cpp \
+    $$UTILS_FOLDER/utils.cpp \
+    $$UTILS_FOLDER/widgetutils.cpp \
+    $$UTILS_FOLDER/fileutils.cpp \
+
+HEADERS += \
+    test_filewatcher.h \
+    $$CORE_FOLDER/exception.h \
+    $$CORE_FOLDER/filewatcher.h \
+    $$UTILS_FOLDER/pathutils.h \
+    $$UTILS_FOLDER/utils.h \
+    $$UTILS_FOLDER/widgetutils.h \
+    $$UTILS_FOLDER/fileutils.h \
@@ -3,18 +3,35 @@
 #include <QDebug>
 #include <QTemporaryDir>
 #include <QFileInfo>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
 
 #include <versioncontroller/dummyversioncontrollerfactory.h>
 #include <versioncontroller/iversioncontroller.h>
 #include <notebookconfigmgr/vxnotebookconfigmgrfactory.h>
 #include <notebookconfigmgr/inotebookconfigmgr.h>
 #include <notebookconfigmgr/bundlenotebookconfigmgr.h>
+#include <notebookconfigmgr/sqlitenotebookconfigmgrfactory.h>
+#include <notebookconfigmgr/sqlitenotebookconfigmgr.h>
+#include <notebookconfigmgr/nodeconfigsnapshot.h>
 #include <notebookbackend/localnotebookbackendfactory.h>
+#include <notebookbackend/memorynotebookbackendfactory.h>
 #include <notebookbackend/inotebookbackend.h>
 #include <notebook/bundlenotebookfactory.h>
 #include <notebook/notebook.h>
 #include <notebook/notebookparameters.h>
+#include <notebook/node.h>
+#include <notebook/nodeloader.h>
+#include <notebook/externalnode.h>
+#include <notebook/linkindex.h>
+#include <core/file.h>
+#include <core/configmgr.h>
+#include <core/fileoperationqueue.h>
 #include <utils/pathutils.h>
+#include <utils/fileutils.h>
 
 using namespace tests;
 
@@ -55,6 +72,14 @@ void TestNotebook::testNotebookConfigMgrServer()
     auto factory = m_ncmServer->getItem(vxFactory->getName());
     auto vxConfigMgr = factory->createNotebookConfigMgr(nullptr);
     QCOMPARE(vxConfigMgr->getName(), vxFactory->getName());
+
+    // SQLite Notebook Config Manager.
+    auto sqliteFactory = QSharedPointer<SqliteNotebookConfigMgrFactory>::create();
+    m_ncmServer->registerItem(sqliteFactory->getName(), sqliteFactory);
+
+    factory = m_ncmServer->getItem(sqliteFactory->getName());
+    auto sqliteConfigMgr = factory->createNotebookConfigMgr(nullptr);
+    QCOMPARE(sqliteConfigMgr->getName(), sqliteFactory->getName());
 }
 
 void TestNotebook::testNotebookBackendServer()
@@ -70,6 +95,10 @@ void TestNotebook::testNotebookBackendServer()
     auto factory = m_backendServer->getItem(localFactory->getName());
     auto localBackend = factory->createNotebookBackend("");
     QCOMPARE(localBackend->getName(), localFactory->getName());
+
+    // Memory Notebook Backend.
+    auto memoryFactory = QSharedPointer<MemoryNotebookBackendFactory>::create();
+    m_backendServer->registerItem(memoryFactory->getName(), memoryFactory);
 }
 
 void TestNotebook::testNotebookServer()
@@ -111,9 +140,568 @@ void TestNotebook::testBundleNotebookFactoryNewNotebook()
     QVERIFY(QFileInfo::exists(notebookConfigPath));
 }
 
+void TestNotebook::testNodeIndex()
+{
+    auto notebook = newTestNotebook("test_node_index");
+    auto root = notebook->getRootNode();
+
+    auto folder = notebook->newNode(root.data(), Node::Flag::Container, "folder");
+    auto file = notebook->newNode(folder.data(), Node::Flag::Content, "file.md");
+
+    // Lookup by ID.
+    QCOMPARE(notebook->findNodeById(root->getId()), root);
+
+    // Lookup by path.
+    QCOMPARE(notebook->findNodeByPath("folder"), folder);
+    QCOMPARE(notebook->findNodeByPath("folder/file.md"), file);
+    QCOMPARE(notebook->loadNodeByPath(file->fetchAbsolutePath()), file);
+
+    // Rename updates paths of the node and its descendants.
+    folder->updateName("renamed");
+    QVERIFY(!notebook->findNodeByPath("folder"));
+    QVERIFY(!notebook->findNodeByPath("folder/file.md"));
+    QCOMPARE(notebook->findNodeByPath("renamed/file.md"), file);
+
+    // Child lookup goes through the index.
+    QCOMPARE(folder->findChild("file.md"), file);
+    QCOMPARE(folder->findChild("FILE.md", false), file);
+    QVERIFY(!folder->findChild("none.md"));
+    QVERIFY(folder->containsChild(file));
+    QVERIFY(!root->containsChild(file));
+
+    // Move.
+    auto dest = notebook->newNode(root.data(), Node::Flag::Container, "dest");
+    auto movedFile = notebook->copyNodeAsChildOf(file, dest.data(), true);
+    QVERIFY(!notebook->findNodeByPath("renamed/file.md"));
+    QCOMPARE(notebook->findNodeByPath("dest/file.md"), movedFile);
+
+    // Removal.
+    notebook->removeNode(dest);
+    QVERIFY(!notebook->findNodeByPath("dest"));
+    QVERIFY(!notebook->findNodeByPath("dest/file.md"));
+}
+
+void TestNotebook::testNodeConfigSnapshot()
+{
+    const auto modifiedTime = QDateTime::currentDateTimeUtc();
+    QJsonObject config;
+    config["name"] = "folder";
+
+    NodeConfigSnapshot snapshot;
+    snapshot.updateConfig("folder/vx.json", modifiedTime, 42, config);
+
+    NodeConfigSnapshot loaded;
+    QVERIFY(loaded.fromCbor(snapshot.toCbor()));
+    QCOMPARE(loaded.findConfig("folder/vx.json", modifiedTime, 42), config);
+
+    // Stale entries are rejected.
+    QVERIFY(loaded.findConfig("folder/vx.json", modifiedTime.addSecs(1), 42).isEmpty());
+    QVERIFY(loaded.findConfig("folder/vx.json", modifiedTime, 43).isEmpty());
+    QVERIFY(loaded.findConfig("other/vx.json", modifiedTime, 42).isEmpty());
+
+    loaded.removeConfigs("folder");
+    QVERIFY(loaded.findConfig("folder/vx.json", modifiedTime, 42).isEmpty());
+}
+
+void TestNotebook::testNodeLoader()
+{
+    auto notebook = newTestNotebook("test_node_loader");
+    auto root = notebook->getRootNode();
+    auto folder = notebook->newNode(root.data(), Node::Flag::Container, "folder");
+    notebook->newNode(folder.data(), Node::Flag::Content, "file.md");
+    notebook->newNode(folder.data(), Node::Flag::Container, "sub");
+
+    notebook->reloadNodes();
+    folder = notebook->getRootNode()->findChild("folder");
+    QVERIFY(folder && !folder->isLoaded());
+
+    auto loader = notebook->getNodeLoader();
+    QSignalSpy spy(loader, &NodeLoader::nodeLoaded);
+
+    // Concurrent loads of the same node are merged.
+    QVERIFY(loader->load(folder));
+    QVERIFY(loader->load(folder));
+    QVERIFY(loader->isLoading(folder.data()));
+
+    QVERIFY(spy.wait());
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(!loader->isLoading(folder.data()));
+    QVERIFY(folder->isLoaded());
+    QCOMPARE(folder->getChildrenCount(), 2);
+    QVERIFY(folder->findChild("file.md")->exists());
+
+    // Nothing to load.
+    QVERIFY(!loader->load(folder));
+}
+
+void TestNotebook::testSqliteNotebookConfigMgr()
+{
+    auto notebook = newTestNotebook("test_sqlite", "sqlite.vnotex");
+    auto configMgr = dynamic_cast<SqliteNotebookConfigMgr *>(notebook->getConfigMgr().data());
+    QVERIFY(configMgr);
+
+    auto root = notebook->getRootNode();
+    auto folder = notebook->newNode(root.data(), Node::Flag::Container, "folder");
+
+    NodeParameters paras;
+    paras.m_tags << "tag_a";
+    notebook->addAsNode(folder.data(), Node::Flag::Content, "file.md", paras);
+    notebook->newNode(folder.data(), Node::Flag::Content, "other.md");
+
+    // No vx.json is written.
+    QVERIFY(!QFileInfo::exists(PathUtils::concatenateFilePath(folder->fetchAbsolutePath(), "vx.json")));
+
+    QCOMPARE(configMgr->queryNotesByTag("tag_a"), QStringList() << "folder/file.md");
+    QCOMPARE(configMgr->queryNotesByModifiedTime().size(), 2);
+
+    // Rename folder and reload from database.
+    folder->updateName("renamed");
+    notebook->reloadNodes();
+    auto node = notebook->loadNodeByPath("renamed/file.md");
+    QVERIFY(node);
+    QCOMPARE(node->getTags(), QStringList() << "tag_a");
+    QCOMPARE(configMgr->queryNotesByTag("tag_a"), QStringList() << "renamed/file.md");
+
+    // Names with characters out of BMP.
+    node->getParent()->updateName(QString::fromUtf8("\xe7\xac\x94\xe8\xae\xb0\xf0\x9f\x98\x80"));
+    node->getParent()->updateName("notes");
+    notebook->reloadNodes();
+    node = notebook->loadNodeByPath("notes/file.md");
+    QVERIFY(node);
+    QCOMPARE(configMgr->queryNotesByTag("tag_a"), QStringList() << "notes/file.md");
+
+    // Convert to vx.json files.
+    configMgr->exportToNodeConfigFiles();
+    QVERIFY(QFileInfo::exists(PathUtils::concatenateFilePath(node->getParent()->fetchAbsolutePath(), "vx.json")));
+}
+
+void TestNotebook::testCachedFolderTimes()
+{
+    auto notebook = newTestNotebook("test_cached_folder_times");
+    auto root = notebook->getRootNode();
+    auto folder = notebook->newNode(root.data(), Node::Flag::Container, "folder");
+    notebook->newNode(folder.data(), Node::Flag::Content, "file.md");
+
+    // Cached times are refreshed when the parent config is written.
+    root->save();
+
+    notebook->reloadNodes();
+    folder = notebook->getRootNode()->findChild("folder");
+    QVERIFY(folder && !folder->isLoaded());
+    QVERIFY(folder->getCreatedTimeUtc().isValid());
+
+    const auto latest = folder->fetchLatestModifiedTimeUtc();
+    QVERIFY(!folder->isLoaded());
+
+    folder->load();
+    QCOMPARE(latest, folder->fetchLatestModifiedTimeUtc());
+    QVERIFY(latest >= folder->findChild("file.md")->getModifiedTimeUtc());
+
+    // Cached latest time of ancestors is dropped when a descendant changes.
+    const auto rootLatest = notebook->getRootNode()->fetchLatestModifiedTimeUtc();
+    QTest::qWait(10);
+    auto file = folder->findChild("file.md");
+    file->setModifiedTimeUtc();
+    QCOMPARE(folder->fetchLatestModifiedTimeUtc(), file->getModifiedTimeUtc());
+    QVERIFY(notebook->getRootNode()->fetchLatestModifiedTimeUtc() > rootLatest);
+
+    // Configs of all the ancestors are updated in batch after a deep note changes.
+    auto sub = notebook->newNode(folder.data(), Node::Flag::Container, "sub");
+    auto deepFile = notebook->newNode(sub.data(), Node::Flag::Content, "deep.md");
+    QTest::qWait(1100);
+    deepFile->setModifiedTimeUtc();
+    deepFile->save();
+    const auto deepTime = deepFile->getModifiedTimeUtc().toString(Qt::ISODate);
+    QTest::qWait(3500);
+
+    notebook->reloadNodes();
+    folder = notebook->getRootNode()->findChild("folder");
+    QVERIFY(folder && !folder->isLoaded());
+    QCOMPARE(folder->fetchLatestModifiedTimeUtc().toString(Qt::ISODate), deepTime);
+}
+
+void TestNotebook::testExternalChildren()
+{
+    auto notebook = newTestNotebook("test_external_children");
+    auto root = notebook->getRootNode();
+    notebook->newNode(root.data(), Node::Flag::Container, "folder");
+    notebook->newNode(root.data(), Node::Flag::Content, "file.md");
+
+    QDir rootDir(root->fetchAbsolutePath());
+    QVERIFY(rootDir.mkdir("ext_folder"));
+    QFile extFile(rootDir.filePath("ext_file.md"));
+    QVERIFY(extFile.open(QIODevice::WriteOnly));
+    extFile.close();
+
+    auto fetchNames = [root]() {
+        QStringList names;
+        for (const auto &child : root->fetchExternalChildren()) {
+            names << child->getName();
+        }
+        return names;
+    };
+
+    QCOMPARE(fetchNames(), QStringList({"ext_folder", "ext_file.md"}));
+
+    // New entries show up though the folder has been listed.
+    QFile extFile2(rootDir.filePath("ext_file2.md"));
+    QVERIFY(extFile2.open(QIODevice::WriteOnly));
+    extFile2.close();
+    QCOMPARE(fetchNames(), QStringList({"ext_folder", "ext_file.md", "ext_file2.md"}));
+
+    QVERIFY(rootDir.remove("ext_file.md"));
+    QCOMPARE(fetchNames(), QStringList({"ext_folder", "ext_file2.md"}));
+}
+
+void TestNotebook::testNodeConfigJournal()
+{
+    auto notebook = newTestNotebook("test_node_config_journal");
+    auto root = notebook->getRootNode();
+    auto file = notebook->newNode(root.data(), Node::Flag::Content, "file.md");
+
+    const auto configPath = PathUtils::concatenateFilePath(root->fetchAbsolutePath(), "vx.json");
+    const auto journalPath = PathUtils::concatenateFilePath(ConfigMgr::getInst().getUserNotebookCacheFolder(notebook->getRootFolderAbsolutePath()),
+                                                            "vx_journal.jsonl");
+    auto readFileEntry = [configPath]() {
+        QFile configFile(configPath);
+        configFile.open(QIODevice::ReadOnly);
+        const auto files = QJsonDocument::fromJson(configFile.readAll()).object().value("files").toArray();
+        return files.isEmpty() ? QJsonObject() : files[0].toObject();
+    };
+
+    const auto oldEntry = readFileEntry();
+    QCOMPARE(oldEntry.value("name").toString(), QString("file.md"));
+
+    // Updates go to the journal instead of the config.
+    file->setModifiedTimeUtc();
+    file->save();
+    file->updateName("renamed.md");
+    QVERIFY(QFileInfo::exists(journalPath));
+    QVERIFY(!QFileInfo::exists(PathUtils::concatenateFilePath(root->fetchAbsolutePath(), "vx_notebook/vx_journal.jsonl")));
+    QCOMPARE(readFileEntry(), oldEntry);
+
+    const auto modifiedTime = file->getModifiedTimeUtc();
+
+    // Replayed on open.
+    notebook->reloadNodes();
+    QVERIFY(!QFileInfo::exists(journalPath));
+    QCOMPARE(readFileEntry().value("name").toString(), QString("renamed.md"));
+
+    file = notebook->getRootNode()->findChild("renamed.md");
+    QVERIFY(file);
+    QCOMPARE(file->getModifiedTimeUtc().toString(Qt::ISODate), modifiedTime.toString(Qt::ISODate));
+}
+
+void TestNotebook::testMoveFolderNode()
+{
+    auto notebook = newTestNotebook("test_move_folder_node");
+    auto root = notebook->getRootNode();
+    auto src = notebook->newNode(root.data(), Node::Flag::Container, "src");
+    auto dest = notebook->newNode(root.data(), Node::Flag::Container, "dest");
+    auto sub = notebook->newNode(src.data(), Node::Flag::Container, "sub");
+    auto file = notebook->newNode(sub.data(), Node::Flag::Content, "file.md");
+    const auto fileId = file->getId();
+
+    // An untracked file is moved along with the folder by the rename.
+    QFile extFile(PathUtils::concatenateFilePath(sub->fetchAbsolutePath(), "ext.png"));
+    QVERIFY(extFile.open(QIODevice::WriteOnly));
+    extFile.close();
+
+    auto moved = notebook->copyNodeAsChildOf(src, dest.data(), true);
+    QCOMPARE(moved, src);
+    QCOMPARE(moved->getParent(), dest.data());
+    QVERIFY(!root->findChild("src"));
+
+    QDir rootDir(root->fetchAbsolutePath());
+    QVERIFY(!rootDir.exists("src"));
+    QVERIFY(rootDir.exists("dest/src/sub/file.md"));
+    QVERIFY(rootDir.exists("dest/src/sub/ext.png"));
+
+    // Configs follow the files.
+    notebook->reloadNodes();
+    root = notebook->getRootNode();
+    auto node = root;
+    for (const auto &name : {"dest", "src", "sub", "file.md"}) {
+        node->load();
+        node = node->findChild(name);
+        QVERIFY(node);
+    }
+    file = node;
+    QCOMPARE(file->getId(), fileId);
+}
+
+void TestNotebook::testMemoryNotebookBackend()
+{
+    auto notebook = newTestNotebook("test_memory_notebook_backend", "vx.vnotex", "memory.vnotex");
+    auto backend = notebook->getBackend();
+    auto root = notebook->getRootNode();
+    auto folder = notebook->newNode(root.data(), Node::Flag::Container, "folder");
+    auto file = notebook->newNode(folder.data(), Node::Flag::Content, "file.md");
+    folder->updateName("renamed");
+
+    // Nothing touches the disk.
+    QVERIFY(!QFileInfo::exists(notebook->getRootFolderAbsolutePath()));
+    QVERIFY(backend->existsFile("renamed/file.md"));
+    QVERIFY(!backend->exists("folder"));
+
+    notebook->reloadNodes();
+    folder = notebook->getRootNode()->findChild("renamed");
+    QVERIFY(folder);
+    folder->load();
+    QVERIFY(folder->findChild("file.md"));
+
+    // Asynchronous operations.
+    QVERIFY(backend->writeFileAsync("renamed/file.md", "vnote").result());
+    QCOMPARE(backend->readFileAsync("renamed/file.md").result(), QByteArray("vnote"));
+    QVERIFY(backend->readFileAsync("missing.md").result().isNull());
+    QVERIFY(backend->copyDirAsync("renamed", "copied").result());
+    QVERIFY(backend->existsAsync("copied/file.md").result());
+    QVERIFY(!backend->copyDirAsync("renamed", "copied").result());
+}
+
+void TestNotebook::testLinkIndex()
+{
+    // Links in code blocks and external links are skipped.
+    const auto links = LinkIndex::parseLinks("[a](../b%20c.md#x) [d](https://vnote.fun)\n"
+                                             "```\n[e](e.md)\n```\n[f]: <g h.md>\n",
+                                             "folder/note.md");
+    QCOMPARE(links.size(), 2);
+    QCOMPARE(links[0].m_targetPath, QString("b c.md"));
+    QCOMPARE(links[0].m_suffix, QString("#x"));
+    QCOMPARE(links[1].m_targetPath, QString("folder/g h.md"));
+
+    QCOMPARE(LinkIndex::rewriteLinks("[a](../b%20c.md#x) [f]: <g h.md>", "folder/note.md", "b c.md", "sub/b c.md"),
+             QString("[a](../sub/b%20c.md#x) [f]: <g h.md>"));
+    QVERIFY(LinkIndex::rewriteLinks("[a](x.md)", "note.md", "y.md", "z.md").isNull());
+
+    auto notebook = newTestNotebook("test_link_index");
+    auto root = notebook->getRootNode();
+    auto folder = notebook->newNode(root.data(), Node::Flag::Container, "folder");
+    auto target = notebook->newNode(folder.data(), Node::Flag::Content, "target.md");
+    auto other = notebook->newNode(root.data(), Node::Flag::Content, "other.md");
+    auto source = notebook->newNode(root.data(), Node::Flag::Content, "source.md", "[t](folder/target.md#intro)");
+
+    // Built in background on first query.
+    notebook->getBacklinks(target.data());
+    QTRY_VERIFY(notebook->getLinkIndex()->isBuilt());
+    QCOMPARE(notebook->getBacklinks(target.data()), QStringList() << "source.md");
+    QVERIFY(notebook->getBacklinks(other.data()).isEmpty());
+
+    // Updated on save.
+    other->getContentFile()->write("[s](source.md)");
+    QCOMPARE(notebook->getBacklinks(source.data()), QStringList() << "other.md");
+
+    // Only referring notes are rewritten on rename.
+    folder->updateName("renamed");
+    QCOMPARE(notebook->getBacklinks(target.data()), QStringList() << "source.md");
+    QTRY_COMPARE(source->getContentFile()->read(), QString("[t](renamed/target.md#intro)"));
+    QCOMPARE(other->getContentFile()->read(), QString("[s](source.md)"));
+
+    // A moved note gets its own links fixed as well.
+    auto movedSource = notebook->copyNodeAsChildOf(source, folder.data(), true);
+    QCOMPARE(notebook->getBacklinks(movedSource.data()), QStringList() << "other.md");
+    QTRY_COMPARE(movedSource->getContentFile()->read(), QString("[t](target.md#intro)"));
+    QTRY_COMPARE(other->getContentFile()->read(), QString("[s](renamed/source.md)"));
+
+    // Images copied along with a moved note keep their links.
+    QDir rootDir(root->fetchAbsolutePath());
+    QVERIFY(rootDir.mkpath("vx_images"));
+    FileUtils::writeFile(rootDir.filePath("vx_images/pic.png"), QByteArray("png"));
+    auto withImage = notebook->newNode(root.data(), Node::Flag::Content, "image.md",
+                                       "![p](vx_images/pic.png) [t](renamed/target.md)");
+    other->getContentFile()->write("![p](vx_images/pic.png)");
+    auto movedWithImage = notebook->copyNodeAsChildOf(withImage, folder.data(), true);
+    QVERIFY(rootDir.exists("renamed/vx_images/pic.png"));
+    QTRY_COMPARE(movedWithImage->getContentFile()->read(), QString("![p](vx_images/pic.png) [t](target.md)"));
+
+    // Other notes follow the image to its new place.
+    QTRY_COMPARE(other->getContentFile()->read(), QString("![p](renamed/vx_images/pic.png)"));
+}
+
+void TestNotebook::testCopyFolderNodeInQueue()
+{
+    auto notebook = newTestNotebook("test_copy_folder_node_in_queue");
+    auto otherNotebook = newTestNotebook("test_copy_folder_node_in_queue_other");
+    auto root = notebook->getRootNode();
+    auto src = notebook->newNode(root.data(), Node::Flag::Container, "src");
+    auto sub = notebook->newNode(src.data(), Node::Flag::Container, "sub");
+    auto file = notebook->newNode(sub.data(), Node::Flag::Content, "file.md");
+
+    FileOperationQueue queue;
+    QSharedPointer<Node> copied;
+    bool finished = false;
+    auto callback = [&copied, &finished](const QSharedPointer<Node> &p_node) {
+        copied = p_node;
+        finished = true;
+    };
+
+    // Copy within the notebook.
+    QVERIFY(!notebook->copyNodeAsChildOf(src, root.data(), false, &queue, this, callback));
+    QTRY_VERIFY(finished);
+    QVERIFY(copied);
+    QCOMPARE(copied->getName(), QString("src_1"));
+    QVERIFY(copied->getId() != src->getId());
+    auto copiedFile = copied->findChild("sub")->findChild("file.md");
+    QVERIFY(copiedFile);
+    QVERIFY(copiedFile->exists());
+    QVERIFY(copiedFile->getId() != file->getId());
+
+    // Move to another notebook.
+    finished = false;
+    auto otherRoot = otherNotebook->getRootNode();
+    const auto srcFolderPath = src->fetchAbsolutePath();
+    QVERIFY(!otherNotebook->copyNodeAsChildOf(src, otherRoot.data(), true, &queue, this, callback));
+    QTRY_VERIFY(finished);
+    QVERIFY(copied);
+    QCOMPARE(copied->getNotebook(), otherNotebook.data());
+    QVERIFY(!root->findChild("src"));
+    QTRY_VERIFY(!queue.isBusy());
+    QVERIFY(!QFileInfo::exists(srcFolderPath));
+    QVERIFY(QFileInfo::exists(PathUtils::concatenateFilePath(otherRoot->fetchAbsolutePath(), "src/sub/file.md")));
+
+    // Nothing is left if cancelled.
+    finished = false;
+    auto folder = otherNotebook->getRootNode()->findChild("src");
+    QVERIFY(!notebook->copyNodeAsChildOf(folder, root.data(), false, &queue, this, callback));
+    queue.cancel();
+    QTRY_VERIFY(finished);
+    QVERIFY(!copied);
+    QTRY_VERIFY(!queue.isBusy());
+    QVERIFY(!root->findChild("src"));
+    QVERIFY(!QFileInfo::exists(srcFolderPath));
+
+    // Folders reserved by pending copies are rolled back too.
+    int finishedCount = 0;
+    auto countCallback = [&finishedCount](const QSharedPointer<Node> &p_node) {
+        Q_UNUSED(p_node);
+        ++finishedCount;
+    };
+    QVERIFY(!notebook->copyNodeAsChildOf(folder, root.data(), false, &queue, this, countCallback));
+    QVERIFY(!notebook->copyNodeAsChildOf(folder, root.data(), false, &queue, this, countCallback));
+    QVERIFY(QFileInfo::exists(srcFolderPath));
+    const auto reservedFolderPath = PathUtils::concatenateFilePath(root->fetchAbsolutePath(), "src_2");
+    QVERIFY(QFileInfo::exists(reservedFolderPath));
+    queue.cancel();
+    QCOMPARE(finishedCount, 1);
+    QTRY_COMPARE(finishedCount, 2);
+    QTRY_VERIFY(!queue.isBusy());
+    QVERIFY(!root->findChild("src") && !root->findChild("src_2"));
+    QVERIFY(!QFileInfo::exists(srcFolderPath));
+    QVERIFY(!QFileInfo::exists(reservedFolderPath));
+}
+
+// Return resident memory in KB, or -1 if not available.
+static qint64 residentMemoryKb()
+{
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return -1;
+    }
+
+    while (!file.atEnd()) {
+        const auto line = file.readLine();
+        if (line.startsWith("VmRSS:")) {
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+        }
+    }
+    return -1;
+}
+
+void TestNotebook::benchmarkNodeMemory()
+{
+    const int folderCount = 50;
+    const int fileCount = 400;
+    const QStringList tagSet = {"work", "todo", "idea", "reading"};
+
+    auto notebook = newTestNotebook("benchmark_node_memory");
+    const auto rootPath = notebook->getRootNode()->fetchAbsolutePath();
+    const auto timeStr = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+
+    // Generate folder configs directly, which is much faster than creating nodes one by one.
+    const auto rootConfigPath = PathUtils::concatenateFilePath(rootPath, "vx.json");
+    auto rootConfig = FileUtils::readJsonFile(rootConfigPath);
+    auto folders = rootConfig.value("folders").toArray();
+    int id = 1000;
+    for (int i = 0; i < folderCount; ++i) {
+        const auto folderName = QString("folder_%1").arg(i);
+        QVERIFY(QDir(rootPath).mkdir(folderName));
+        folders.append(QJsonObject({{"name", folderName}}));
+
+        QJsonArray files;
+        for (int j = 0; j < fileCount; ++j) {
+            QJsonObject file;
+            file["name"] = QString("note_%1.md").arg(j);
+            file["id"] = QString::number(++id);
+            file["created_time"] = timeStr;
+            file["modified_time"] = timeStr;
+            file["attachment_folder"] = QString();
+            file["tags"] = QJsonArray::fromStringList(tagSet.mid(j % tagSet.size(), 2));
+            files.append(file);
+        }
+
+        QJsonObject folderConfig;
+        folderConfig["version"] = rootConfig.value("version");
+        folderConfig["id"] = QString::number(++id);
+        folderConfig["created_time"] = timeStr;
+        folderConfig["modified_time"] = timeStr;
+        folderConfig["files"] = files;
+        folderConfig["folders"] = QJsonArray();
+        FileUtils::writeFile(PathUtils::concatenateFilePath(rootPath, folderName + "/vx.json"), folderConfig);
+    }
+    rootConfig["folders"] = folders;
+    FileUtils::writeFile(rootConfigPath, rootConfig);
+
+    const auto memBefore = residentMemoryKb();
+
+    notebook->reloadNodes();
+    int nodeCount = 0;
+    for (const auto &child : notebook->getRootNode()->getChildrenRef()) {
+        child->load();
+        nodeCount += child->getChildrenCount() + 1;
+    }
+    QVERIFY(nodeCount >= folderCount * (fileCount + 1));
+
+    // Notes with the same tags share the list data.
+    const auto &firstFolder = notebook->getRootNode()->getChildrenRef().first();
+    const auto &firstTags = firstFolder->getChildrenRef()[0]->getTags();
+    const auto &otherTags = notebook->getRootNode()->getChildrenRef().last()->getChildrenRef()[0]->getTags();
+    QCOMPARE(firstTags, otherTags);
+    QVERIFY(firstTags.constBegin() == otherTags.constBegin());
+
+    // Keep the node compact. Its strings and lists are shared or allocated apart.
+    QVERIFY(sizeof(Node) <= 256);
+
+    // Resident memory depends on the allocator and the platform, so it is only reported.
+    const auto memAfter = residentMemoryKb();
+    if (memBefore >= 0 && memAfter >= 0) {
+        qInfo() << "nodes" << nodeCount << "sizeof(Node)" << sizeof(Node)
+                << "resident memory increase (KB)" << (memAfter - memBefore)
+                << "bytes per node" << (memAfter - memBefore) * 1024 / nodeCount;
+    } else {
+        qInfo() << "nodes" << nodeCount << "sizeof(Node)" << sizeof(Node);
+    }
+}
+
 QString TestNotebook::getTestFolderPath() const
 {
     return m_testDir->path();
 }
 
+QSharedPointer<Notebook> TestNotebook::newTestNotebook(const QString &p_folderName,
+                                                       const QString &p_configMgrName,
+                                                       const QString &p_backendName) const
+{
+    auto nbFactory = m_nbServer->getItem("bundle.vnotex");
+
+    NotebookParameters para;
+    para.m_name = p_folderName;
+    para.m_rootFolderPath = PathUtils::concatenateFilePath(getTestFolderPath(), p_folderName);
+    para.m_notebookBackend = m_backendServer->getItem(p_backendName)
+                                            ->createNotebookBackend(para.m_rootFolderPath);
+    para.m_versionController = m_vcServer->getItem("dummy.vnotex")->createVersionController();
+    para.m_notebookConfigMgr = m_ncmServer->getItem(p_configMgrName)->createNotebookConfigMgr(para.m_notebookBackend);
+
+    return nbFactory->newNotebook(para);
+}
+
 QTEST_MAIN(tests::TestNotebook)
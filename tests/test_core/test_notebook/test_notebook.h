@@ -14,6 +14,7 @@ namespace vnotex
     class INotebookConfigMgrFactory;
     class INotebookBackendFactory;
     class INotebookFactory;
+    class Notebook;
 }
 
 namespace tests
@@ -36,9 +37,38 @@ namespace tests
 
         void testBundleNotebookFactoryNewNotebook();
 
+        void testNodeIndex();
+
+        void testNodeConfigSnapshot();
+
+        void testNodeLoader();
+
+        void testSqliteNotebookConfigMgr();
+
+        void testCachedFolderTimes();
+
+        void testExternalChildren();
+
+        void testNodeConfigJournal();
+
+        void testMoveFolderNode();
+
+        void testCopyFolderNodeInQueue();
+
+        void testMemoryNotebookBackend();
+
+        void testLinkIndex();
+
+        // Memory of nodes of a generated notebook.
+        void benchmarkNodeMemory();
+
     private:
         QString getTestFolderPath() const;
 
+        QSharedPointer<vnotex::Notebook> newTestNotebook(const QString &p_folderName,
+                                                         const QString &p_configMgrName = QStringLiteral("vx.vnotex"),
+                                                         const QString &p_backendName = QStringLiteral("local.vnotex")) const;
+
         QSharedPointer<QTemporaryDir> m_testDir;
 
         QSharedPointer<vnotex::NameBasedServer<vnotex::IVersionControllerFactory>> m_vcServer;
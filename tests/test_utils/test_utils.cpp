@@ -2,9 +2,11 @@
 
 #include <QDebug>
 #include <QTemporaryDir>
+#include <QFileInfo>
 
 #include <utils/pathutils.h>
 #include <utils/fileutils.h>
+#include <core/exception.h>
 
 using namespace tests;
 
@@ -227,4 +229,122 @@ void TestUtils::testIsText()
     }
 }
 
+void TestUtils::testCopyFile()
+{
+    QTemporaryDir dir;
+    const QString testFolderPath(dir.path());
+
+    // Larger than one chunk of the kernel copy.
+    QByteArray data;
+    for (int i = 0; i < 300000; ++i) {
+        data.append(static_cast<char>(i % 251));
+    }
+
+    const auto srcPath = testFolderPath + "/src.png";
+    {
+        QFile file(srcPath);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(data);
+        file.close();
+    }
+
+    const auto destPath = testFolderPath + "/sub/dest.png";
+    FileUtils::copyFile(srcPath, destPath);
+    QCOMPARE(FileUtils::readFile(destPath), data);
+    QCOMPARE(QFileInfo(destPath).permissions(), QFileInfo(srcPath).permissions());
+
+    // Existing destination is not overwritten.
+    bool failed = false;
+    try {
+        FileUtils::copyFile(srcPath, destPath);
+    } catch (Exception &p_e) {
+        Q_UNUSED(p_e);
+        failed = true;
+    }
+    QVERIFY(failed);
+
+    // Empty file.
+    const auto emptyPath = testFolderPath + "/empty.md";
+    {
+        QFile file(emptyPath);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.close();
+    }
+    FileUtils::copyFile(emptyPath, testFolderPath + "/empty2.md");
+    QVERIFY(QFileInfo::exists(testFolderPath + "/empty2.md"));
+    QCOMPARE(QFileInfo(testFolderPath + "/empty2.md").size(), 0);
+}
+
+void TestUtils::testWriteFileDurably()
+{
+    QTemporaryDir dir;
+    const QString testFolderPath(dir.path());
+    const auto filePath = testFolderPath + "/vx.json";
+
+    FileUtils::writeFileDurably(filePath, QByteArray("old"));
+    QCOMPARE(FileUtils::readFile(filePath), QByteArray("old"));
+
+    {
+        FileUtils::DirectorySyncBatch syncBatch;
+        FileUtils::writeFileDurably(filePath, QString("new"));
+        FileUtils::writeFileDurably(testFolderPath + "/note.md", QString("note"));
+    }
+    QCOMPARE(FileUtils::readTextFile(filePath), QString("new"));
+    QCOMPARE(FileUtils::readTextFile(testFolderPath + "/note.md"), QString("note"));
+
+    // No temporary file is left.
+    QCOMPARE(QDir(testFolderPath).entryList(QDir::Files | QDir::Hidden).size(), 2);
+
+    // Target is untouched on failure.
+    bool failed = false;
+    try {
+        FileUtils::writeFileDurably(testFolderPath + "/missing/note.md", QByteArray("note"));
+    } catch (Exception &p_e) {
+        Q_UNUSED(p_e);
+        failed = true;
+    }
+    QVERIFY(failed);
+}
+
+void TestUtils::testHashFile()
+{
+    QTemporaryDir dir;
+    const QString testFolderPath(dir.path());
+    const auto filePath = testFolderPath + "/note.md";
+
+    // Known XXH64 values.
+    FileUtils::writeFile(filePath, QByteArray());
+    QCOMPARE(FileUtils::hashFile(filePath), Q_UINT64_C(0xef46db3751d8e999));
+
+    FileUtils::writeFile(filePath, QByteArray("abc"));
+    QCOMPARE(FileUtils::hashFile(filePath), Q_UINT64_C(0x44bc2cf5ad770999));
+
+    // Larger than one chunk.
+    QByteArray data(3 * 1024 * 1024 + 17, 'v');
+    FileUtils::writeFile(filePath, data);
+    const auto hash = FileUtils::hashFile(filePath);
+    FileUtils::writeFile(filePath, data);
+    QCOMPARE(FileUtils::hashFile(filePath), hash);
+
+    data[data.size() - 1] = 'x';
+    FileUtils::writeFile(filePath, data);
+    QVERIFY(FileUtils::hashFile(filePath) != hash);
+}
+
+void TestUtils::testEncodeText()
+{
+    QTemporaryDir dir;
+    const auto filePath = QString(dir.path()) + "/note.md";
+    const QString text("line 1\nline 2\n");
+
+    // Same bytes as writing and reading the text file.
+    const auto data = FileUtils::encodeText(text);
+    FileUtils::writeFile(filePath, text);
+    QCOMPARE(FileUtils::readFile(filePath), data);
+    QCOMPARE(FileUtils::hashFile(filePath), FileUtils::hashData(data));
+
+    QCOMPARE(FileUtils::decodeText(data), text);
+    QCOMPARE(FileUtils::decodeText("line 1\r\nline 2"), QString("line 1\nline 2"));
+}
+
 QTEST_MAIN(tests::TestUtils)
@@ -32,6 +32,14 @@ namespace tests
         void testRenameFile();
 
         void testIsText();
+
+        void testCopyFile();
+
+        void testWriteFileDurably();
+
+        void testHashFile();
+
+        void testEncodeText();
     };
 } // ns tests
 